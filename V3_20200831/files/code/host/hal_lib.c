@@ -0,0 +1,198 @@
+/*! ----------------------------------------------------------------------------
+ * \file		hal_lib.c
+ * \brief		Host build: replacement of the MLX16 platform libraries
+ *
+ * \note		project MLX81315
+ *
+ * \author 		Marcel Braat
+ *
+ * \date 		2020-09-14
+ *
+ * \version 	1.0 - preliminary
+ *
+ * \functions	divU16_U32byU16()
+ *				divU32_U32byU16()
+ *				mulI32_I16byI16()
+ *				mulI32_I16byU16()
+ *				mulU32_U16byU16()
+ *				ml_xxx() (LIN API)
+ *				HAL_LinReceive()
+ *				mlx_isPowerOk()
+ *
+ * The mathlib (MLX16 assembly) is replaced by C. The LIN-API (MLX4 LIN
+ * protocol handler) is replaced by a LIN-bus with a scripted master (see
+ * hal_plant.c): All calls succeed, frames are received by HAL_LinReceive().
+ *
+ * MELEXIS Microelectronic Integrated Systems
+ *
+ * Copyright (C) 2020-2020 Melexis N.V.
+ * The Software is being delivered 'AS IS' and Melexis, whether explicitly or
+ * implicitly, makes no warranty as to its Use or performance.
+ * The user accepts the Melexis Firmware License Agreement.
+ *
+ * Melexis confidential & proprietary
+ * ****************************************************************************	*/
+
+#include "hal_sim.h"
+#include <plib.h>
+#include <mathlib.h>
+#include <lin.h>
+
+/* ****************************************************************************	*
+ *	LIN-library variables														*
+ * ****************************************************************************	*/
+volatile ml_uint8 LinProtectedID = 0u;
+volatile uint8 LinFrame[8];
+ml_uint8 LinFrameDataBuffer[8];
+volatile ml_uint8 LinStatus = 0u;
+static ml_MessageID l_LinMessageIndex = 0u;
+
+/* BIST reset information (.bist_stat) */
+volatile uint16 bistResetInfo = C_CHIP_STATE_COLD_START;
+
+/* ****************************************************************************	*
+ *	Mathlib																		*
+ * ****************************************************************************	*/
+uint16 divU16_U32byU16( uint32 n, uint16 d)
+{
+	return ( (uint16) (n / d) );
+} /* End of divU16_U32byU16() */
+
+uint32 divU32_U32byU16( uint32 n, uint16 d)
+{
+	return ( n / d );
+} /* End of divU32_U32byU16() */
+
+int32 mulI32_I16byI16( int16 a, int16 b)
+{
+	return ( (int32) a * (int32) b );
+} /* End of mulI32_I16byI16() */
+
+int32 mulI32_I16byU16( int16 a, uint16 b)
+{
+	return ( (int32) a * (int32) b );
+} /* End of mulI32_I16byU16() */
+
+uint32 mulU32_U16byU16( uint16 a, uint16 b)
+{
+	return ( (uint32) a * (uint32) b );
+} /* End of mulU32_U16byU16() */
+
+/* ****************************************************************************	*
+ *	LIN-API																		*
+ * ****************************************************************************	*/
+ml_Status ml_InitLinModule( void)
+{
+	HAL_IO16( C_HAL_ADDR_MASK) |= EN_M4_SHE_IT;
+	return ( ML_SUCCESS );
+}
+
+ml_Status ml_Connect( void)
+{
+	return ( ML_SUCCESS );
+}
+
+ml_Status ml_Disconnect( void)
+{
+	return ( ML_SUCCESS );
+}
+
+ml_Status ml_SetAutoBaudRateMode( ml_uint8 Mode)
+{
+	(void) Mode;
+	return ( ML_SUCCESS );
+}
+
+ml_Status ml_SetSlewRate( ml_uint16 SlewRate)
+{
+	(void) SlewRate;
+	return ( ML_SUCCESS );
+}
+
+ml_Status ml_SetOptions( ml_uint8 IDStopBitLength, ml_uint8 TXStopBitLength, ml_bool EnableStateChangeEvent, ml_bool SleepMode)
+{
+	(void) IDStopBitLength;
+	(void) TXStopBitLength;
+	(void) EnableStateChangeEvent;
+	(void) SleepMode;
+	return ( ML_SUCCESS );
+}
+
+ml_Status ml_SetLoaderNAD( ml_uint8 Nad)
+{
+	(void) Nad;
+	return ( ML_SUCCESS );
+}
+
+ml_LinState ml_GetState( ml_uint8 bits_to_reset)
+{
+	(void) bits_to_reset;
+	return ( ml_stACTIVE );
+}
+
+ml_Status ml_AssignFrameToMessageID( ml_MessageID MessageIndex, ml_FrameID FrameID)
+{
+	(void) MessageIndex;
+	(void) FrameID;
+	return ( ML_SUCCESS );
+}
+
+ml_Status ml_DisableMessage( ml_MessageID MessageIndex)
+{
+	(void) MessageIndex;
+	return ( ML_SUCCESS );
+}
+
+ml_Status ml_DiscardFrame( void)
+{
+	return ( ML_SUCCESS );
+}
+
+ml_Status ml_DataReady( ml_bool DataTransmittedEvent)
+{
+	(void) DataTransmittedEvent;
+	return ( ML_SUCCESS );
+}
+
+void ml_GetLinEventData( void)
+{
+}
+
+void ml_ProccessLinEvent( void)
+{
+	mlu_MessageReceived( l_LinMessageIndex);
+}
+
+/* M4_SHE_IT: Only used in case the application doesn't provide its own handler */
+__attribute__((weak)) void ml_LinInterruptHandler( void)
+{
+	ml_GetLinEventData();
+	ml_ProccessLinEvent();
+}
+
+/* ****************************************************************************	*
+ * HAL_LinReceive()
+ *
+ * LIN master: Frame (8 bytes) for message u8MessageIndex is received; The
+ * MLX4 event interrupt (M4_SHE_IT) is requested.
+ * ****************************************************************************	*/
+void HAL_LinReceive( uint8 u8MessageIndex, const uint8 *pu8Data)
+{
+	uint16 u16Idx;
+	for ( u16Idx = 0u; u16Idx < 8u; u16Idx++ )
+	{
+		LinFrameDataBuffer[u16Idx] = pu8Data[u16Idx];
+	}
+	l_LinMessageIndex = (ml_MessageID) u8MessageIndex;
+	HAL_SetPending( EN_M4_SHE_IT);
+} /* End of HAL_LinReceive() */
+
+/* ****************************************************************************	*
+ * mlx_isPowerOk()
+ * ****************************************************************************	*/
+bool mlx_isPowerOk( void)
+{
+	return ( true );
+} /* End of mlx_isPowerOk() */
+
+/* EOF */
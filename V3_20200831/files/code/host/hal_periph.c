@@ -0,0 +1,436 @@
+/*! ----------------------------------------------------------------------------
+ * \file		hal_periph.c
+ * \brief		Host build: MLX81315 peripheral models
+ *
+ * \note		project MLX81315
+ *
+ * \author 		Marcel Braat
+ *
+ * \date 		2020-09-14
+ *
+ * \version 	1.0 - preliminary
+ *
+ * \functions	HAL_PeriphInit()
+ *				HAL_PeriphRead()
+ *				HAL_PeriphWrite()
+ *				HAL_PeriphUpdate()
+ *				HAL_PeriphReport()
+ *				HAL_SetXiPending()
+ *				HAL_TimerCapture()
+ *
+ * Register-level models of the peripherals used by the application:
+ * - Interrupt controller registers (PEND, XIn_PEND: write-1-to-clear);
+ * - Core timer (TIMER), periodic TIMER_IT;
+ * - Timer1/Timer2 (mode 0): Compare-B (Tn_INT4) second-level interrupt;
+ *   (mode 1, capture): Free-running, capture-A (Tn_INT1) at the input edge
+ *   and overflow (Tn_INT3) second-level interrupts;
+ * - ADC: Sequence table (ADC_SBASE), results (ADC_DBASE), soft- and
+ *   hard (PWM) triggered conversions;
+ * - Software interrupt (VARIOUS_L.SWI), MLX16 HALT (CONTROL.HALT);
+ * - NVRAM controller (NV_CTRL), never busy.
+ * All other I/O-ports behave as plain memory.
+ *
+ * MELEXIS Microelectronic Integrated Systems
+ *
+ * Copyright (C) 2020-2020 Melexis N.V.
+ * The Software is being delivered 'AS IS' and Melexis, whether explicitly or
+ * implicitly, makes no warranty as to its Use or performance.
+ * The user accepts the Melexis Firmware License Agreement.
+ *
+ * Melexis confidential & proprietary
+ * ****************************************************************************	*/
+
+#include <stdio.h>
+#include <string.h>
+#include "hal_sim.h"
+#include <ioports.h>
+#include <plib.h>
+
+#define C_HAL_NO_EVENT				0xFFFFFFFFFFFFFFFFULL
+#define C_HAL_ADC_CONV_CLOCKS		(4U * C_HAL_CLOCKS_PER_US)					/* ADC conversion time: 4us */
+#define C_HAL_ADC_EOT				0xFFFFU										/* End-of-table marker */
+#define C_HAL_PWM_DEF_PERIOD		(C_HAL_FCPU / 20000UL)						/* PWM period in case PWM1 is not configured */
+#define C_HAL_MAX_TIMER				2U
+
+typedef struct _HAL_TIMER
+{
+	uint64 u64Start;															/* Clock of counter (re)start */
+	uint64 u64Next;																/* Next compare-B event */
+	uint32 u32Compares;
+} HAL_TIMER;
+
+static uint64 l_u64CoreTimerNext = C_HAL_NO_EVENT;
+static uint16 l_u16CoreTimerReload = 0u;										/* [us] */
+static uint32 l_u32CoreTimerTicks = 0u;
+static HAL_TIMER l_aTimer[C_HAL_MAX_TIMER];
+static uint64 l_u64AdcNext = C_HAL_NO_EVENT;									/* Next end-of-conversion */
+static uint16 l_u16AdcIdx = 0u;													/* Sequence table index */
+static uint32 l_u32AdcConversions = 0u;
+static uint32 l_u32AdcSequences = 0u;
+static uint32 l_u32SoftIrqs = 0u;
+static uint32 l_u32NvramStores = 0u;
+
+/* ****************************************************************************	*
+ * HAL_SetXiPending()
+ *
+ * Set second-level interrupt request(s) u16Bits of EXTn_IT (XIn_PEND); The
+ * first-level request is set for each enabled (XIn_MASK) request.
+ * ****************************************************************************	*/
+void HAL_SetXiPending( uint16 u16Ext, uint16 u16Bits)
+{
+	HAL_IO16( C_HAL_ADDR_XI0_PEND + 2u * u16Ext) |= u16Bits;
+	if ( (HAL_IO16( C_HAL_ADDR_XI0_MASK + 2u * u16Ext) & u16Bits) != 0u )
+	{
+		HAL_SetPending( (uint16) (EN_EXT0_IT << u16Ext));
+	}
+} /* End of HAL_SetXiPending() */
+
+/* ****************************************************************************	*
+ *	Timers																		*
+ * ****************************************************************************	*/
+static uint32 HAL_TimerDivider( uint16 u16Timer)
+{
+	static const uint32 au32Divider[4] = { 1u, 16u, 256u, 256u };
+	return ( au32Divider[(HAL_IO16( C_HAL_ADDR_TMR1_CTRL + 8u * u16Timer) >> 14) & 3u] );
+}
+
+static void HAL_TimerSchedule( uint16 u16Timer)
+{
+	HAL_TIMER *pTimer = &l_aTimer[u16Timer];
+	uint16 u16Ctrl = HAL_IO16( C_HAL_ADDR_TMR1_CTRL + 8u * u16Timer);
+	uint32 u32RegB = HAL_IO16( C_HAL_ADDR_TMR1_CTRL + 8u * u16Timer + 2u);
+	uint32 u32Div = HAL_TimerDivider( u16Timer);
+
+	if ( (u16Ctrl & (TMRx_START | TMRx_T_EBLK)) != (TMRx_START | TMRx_T_EBLK) )
+	{
+		pTimer->u64Next = C_HAL_NO_EVENT;
+		return;
+	}
+	if ( (u32RegB == 0u) || ((u16Ctrl & (TMRx_MODE2 | TMRx_MODE1 | TMRx_MODE0)) != 0u) )
+	{
+		u32RegB = 0x10000u;														/* Capture mode: Free-running */
+	}
+	pTimer->u64Next = pTimer->u64Start + (uint64) u32RegB * u32Div;
+	if ( pTimer->u64Next <= g_u64HalClock )
+	{
+		/* Compare value already passed: Counter wraps-around */
+		pTimer->u64Next = pTimer->u64Start + (uint64) (u32RegB + 0x10000u) * u32Div;
+	}
+}
+
+static void HAL_TimerUpdateCnt( uint16 u16Timer)
+{
+	HAL_TIMER *pTimer = &l_aTimer[u16Timer];
+	uint16 u16Cnt = 0u;
+	if ( pTimer->u64Next != C_HAL_NO_EVENT )
+	{
+		u16Cnt = (uint16) ((g_u64HalClock - pTimer->u64Start) / HAL_TimerDivider( u16Timer));
+	}
+	HAL_IO16( C_HAL_ADDR_TMR1_CTRL + 8u * u16Timer + 6u) = u16Cnt;
+}
+
+/* ****************************************************************************	*
+ * HAL_TimerCapture()
+ *
+ * Input-A edge (u16Rising: rising or falling) of timer u16Timer (0: Timer1,
+ * 1: Timer2); In capture mode, with the edge enabled (EDG1), the counter is
+ * captured in TMRn_REGA and capture-A (Tn_INT1) is requested.
+ * ****************************************************************************	*/
+void HAL_TimerCapture( uint16 u16Timer, uint16 u16Rising)
+{
+	uint16 u16Ctrl = HAL_IO16( C_HAL_ADDR_TMR1_CTRL + 8u * u16Timer);
+	uint16 u16Edge = (u16Rising != 0u) ? TMRx_EDG1_0 : TMRx_EDG1_1;
+
+	if ( ((u16Ctrl & (TMRx_MODE2 | TMRx_MODE1 | TMRx_MODE0)) == TMRx_MODE1) && ((u16Ctrl & u16Edge) != 0u) &&
+		 (l_aTimer[u16Timer].u64Next != C_HAL_NO_EVENT) )
+	{
+		HAL_TimerUpdateCnt( u16Timer);
+		HAL_IO16( C_HAL_ADDR_TMR1_CTRL + 8u * u16Timer + 4u) = HAL_IO16( C_HAL_ADDR_TMR1_CTRL + 8u * u16Timer + 6u);
+		HAL_SetXiPending( u16Timer, EN_T1_INT1);
+	}
+} /* End of HAL_TimerCapture() */
+
+/* ****************************************************************************	*
+ *	ADC																			*
+ * ****************************************************************************	*/
+static uint64 HAL_AdcTriggerPeriod( void)
+{
+	/* Hardware triggers are spread over one PWM period */
+	uint16 u16Pscl = HAL_IO8( C_HAL_ADDR_PWM1_PSCL);
+	uint64 u64Period = ((uint64) HAL_IO16( C_HAL_ADDR_PWM1_PER) + 1u) * ((u16Pscl >> 4) + 1u) << (u16Pscl & 0x0Fu);
+	const uint16 *pu16Table = (const uint16 *) HAL_HostAddress( HAL_IO16( C_HAL_ADDR_ADC_SBASE));
+	uint16 u16Entries = 0u;
+
+	if ( HAL_IO16( C_HAL_ADDR_PWM1_PER) == 0u )
+	{
+		u64Period = C_HAL_PWM_DEF_PERIOD;
+	}
+	while ( (pu16Table[u16Entries] != C_HAL_ADC_EOT) && (u16Entries < 32u) )
+	{
+		u16Entries++;
+	}
+	return ( u64Period / ((u16Entries != 0u) ? u16Entries : 1u) );
+}
+
+static void HAL_AdcConversion( void)
+{
+	uint16 u16Ctrl = HAL_IO16( C_HAL_ADDR_ADC_CTRL);
+	const uint16 *pu16Table = (const uint16 *) HAL_HostAddress( HAL_IO16( C_HAL_ADDR_ADC_SBASE));
+	uint16 *pu16Result = (uint16 *) HAL_HostAddress( HAL_IO16( C_HAL_ADDR_ADC_DBASE));
+
+	l_u64AdcNext = C_HAL_NO_EVENT;
+	if ( (u16Ctrl & ADC_START) == 0u )
+	{
+		return;
+	}
+	if ( pu16Table[l_u16AdcIdx] != C_HAL_ADC_EOT )
+	{
+		pu16Result[l_u16AdcIdx] = HAL_AdcChannel( (pu16Table[l_u16AdcIdx] >> 8) & 0x1Fu, pu16Table[l_u16AdcIdx] & 0x00F8u) & 0x03FFu;
+		l_u16AdcIdx++;
+		l_u32AdcConversions++;
+	}
+	if ( pu16Table[l_u16AdcIdx] == C_HAL_ADC_EOT )
+	{
+		/* End of sequence */
+		l_u32AdcSequences++;
+		l_u16AdcIdx = 0u;
+		HAL_SetPending( EN_ADC_IT);
+		if ( (u16Ctrl & ADC_LOOP) == 0u )
+		{
+			HAL_IO16( C_HAL_ADDR_ADC_CTRL) = u16Ctrl & ~ADC_START;
+			return;
+		}
+	}
+	if ( (u16Ctrl & ADC_TRIG_SRC) != 0u )
+	{
+		l_u64AdcNext = g_u64HalClock + HAL_AdcTriggerPeriod();
+	}
+}
+
+static void HAL_AdcWrite( uint16 u16Old)
+{
+	uint16 u16Ctrl = HAL_IO16( C_HAL_ADDR_ADC_CTRL);
+
+	if ( (u16Ctrl & ADC_START) == 0u )
+	{
+		l_u64AdcNext = C_HAL_NO_EVENT;											/* ADC stopped */
+		l_u16AdcIdx = 0u;
+	}
+	else if ( (u16Old & ADC_START) == 0u )
+	{
+		l_u16AdcIdx = 0u;														/* Start of sequence */
+		l_u64AdcNext = C_HAL_NO_EVENT;
+		if ( (u16Ctrl & ADC_TRIG_SRC) != 0u )
+		{
+			l_u64AdcNext = g_u64HalClock + HAL_AdcTriggerPeriod();
+		}
+	}
+	else
+	{
+		u16Ctrl |= (u16Old & ADC_START);
+	}
+	if ( (u16Ctrl & ADC_SOFT_TRIG) != 0u )
+	{
+		u16Ctrl &= ~ADC_SOFT_TRIG;												/* Cleared when conversion is started */
+		if ( ((u16Ctrl & ADC_START) != 0u) && (l_u64AdcNext == C_HAL_NO_EVENT) )
+		{
+			l_u64AdcNext = g_u64HalClock + C_HAL_ADC_CONV_CLOCKS;
+		}
+	}
+	HAL_IO16( C_HAL_ADDR_ADC_CTRL) = u16Ctrl;
+}
+
+/* ****************************************************************************	*
+ * HAL_PeriphInit()
+ *
+ * Reset of the peripherals and the Melexis calibration page (NVRAM).
+ * ****************************************************************************	*/
+void HAL_PeriphInit( void)
+{
+	volatile MLX_CALIBRATION_PARAMS *pCalib = (volatile MLX_CALIBRATION_PARAMS *) (uintptr_t) BGN_MLX_CALIB_ADDRESS_AREA1;
+
+	memset( l_aTimer, 0, sizeof(l_aTimer));
+	l_aTimer[0].u64Next = C_HAL_NO_EVENT;
+	l_aTimer[1].u64Next = C_HAL_NO_EVENT;
+
+	/* Typical calibration values */
+	pCalib->EE_mTempLow = 600u;													/* -40C */
+	pCalib->EE_mTempMid = 500u;													/*  35C */
+	pCalib->EE_mTempHigh = 380u;												/* 125C */
+	pCalib->EE_TGAINCAL_RES = 0x00C0u;
+	pCalib->EE_V_OFFS_GAIN_CAL = (219u << 8);									/* Vs [10mV] = ADC * 219/64 */
+	pCalib->EE_ADC_OFFS_GAIN_CAL = (219u << 8);
+	pCalib->EE_C_GAINS_CAL = 0x0000u;
+	pCalib->EE_C_OFFS_FLT_CAL = 0;
+
+	HAL_PlantInit();
+} /* End of HAL_PeriphInit() */
+
+/* ****************************************************************************	*
+ * HAL_PeriphRead()
+ *
+ * Update the I/O-port at u16Address, before it is read by the application.
+ * ****************************************************************************	*/
+void HAL_PeriphRead( uint16 u16Address)
+{
+	if ( (u16Address == (C_HAL_ADDR_TMR1_CTRL + 6u)) || (u16Address == (C_HAL_ADDR_TMR1_CTRL + 14u)) )
+	{
+		HAL_TimerUpdateCnt( (u16Address - C_HAL_ADDR_TMR1_CTRL) / 8u);			/* TMRn_CNT */
+	}
+	else if ( (u16Address == C_HAL_ADDR_TIMER) && (l_u64CoreTimerNext != C_HAL_NO_EVENT) )
+	{
+		/* Core timer: Down-counter [us] until the next reload */
+		HAL_IO16( u16Address) = TMR_EN | (uint16) ((l_u64CoreTimerNext - g_u64HalClock) / C_HAL_CLOCKS_PER_US);
+	}
+} /* End of HAL_PeriphRead() */
+
+/* ****************************************************************************	*
+ * HAL_PeriphWrite()
+ *
+ * Perform the side-effects of the application write to I/O-port u16Address;
+ * u16OldValue is the value before the write.
+ * ****************************************************************************	*/
+void HAL_PeriphWrite( uint16 u16Address, uint16 u16OldValue, uint16 u16Size)
+{
+	(void) u16Size;
+	switch ( u16Address )
+	{
+	case C_HAL_ADDR_PEND:
+		HAL_IO16( u16Address) = u16OldValue & ~HAL_IO16( u16Address);			/* Write-1-to-clear */
+		break;
+	case C_HAL_ADDR_XI0_PEND:
+	case C_HAL_ADDR_XI0_PEND + 2u:
+	case C_HAL_ADDR_XI0_PEND + 4u:
+	case C_HAL_ADDR_XI0_PEND + 6u:
+	case C_HAL_ADDR_XI0_PEND + 8u:
+		HAL_IO16( u16Address) = u16OldValue & ~HAL_IO16( u16Address);			/* Write-1-to-clear */
+		break;
+	case C_HAL_ADDR_VARIOUS_L:
+		if ( (HAL_IO8( u16Address) & SWI) != 0u )
+		{
+			HAL_IO8( u16Address) &= ~SWI;										/* Automatically cleared */
+			HAL_SetPending( EN_SOFT_IT);
+			l_u32SoftIrqs++;
+		}
+		break;
+	case C_HAL_ADDR_CONTROL:
+		if ( (HAL_IO8( u16Address) & HALT) != 0u )
+		{
+			HAL_IO8( u16Address) &= ~HALT;										/* Write-only */
+			HAL_Halt();
+		}
+		break;
+	case C_HAL_ADDR_NV_CTRL:
+		if ( (HAL_IO16( u16Address) & NV_CONF_MASK) == NV_CONF_STORE )
+		{
+			l_u32NvramStores++;
+		}
+		HAL_IO16( u16Address) &= ~(NV_CONF_MASK | NV_BUSY);						/* Command completed */
+		break;
+	case C_HAL_ADDR_TIMER:
+		l_u64CoreTimerNext = C_HAL_NO_EVENT;
+		l_u16CoreTimerReload = HAL_IO16( u16Address) & 0x7FFFu;
+		if ( (HAL_IO16( u16Address) & TMR_EN) != 0u )
+		{
+			l_u64CoreTimerNext = g_u64HalClock + (uint64) l_u16CoreTimerReload * C_HAL_CLOCKS_PER_US;
+		}
+		break;
+	case C_HAL_ADDR_TMR1_CTRL:
+	case C_HAL_ADDR_TMR1_CTRL + 8u:
+		{
+			uint16 u16Timer = (u16Address - C_HAL_ADDR_TMR1_CTRL) / 8u;
+			if ( ((HAL_IO16( u16Address) & TMRx_START) != 0u) && ((u16OldValue & TMRx_START) == 0u) )
+			{
+				l_aTimer[u16Timer].u64Start = g_u64HalClock;					/* (Re)start counter */
+			}
+			HAL_TimerSchedule( u16Timer);
+		}
+		break;
+	case C_HAL_ADDR_TMR1_CTRL + 2u:												/* TMR1_REGB */
+	case C_HAL_ADDR_TMR1_CTRL + 10u:											/* TMR2_REGB */
+		HAL_TimerSchedule( (u16Address - C_HAL_ADDR_TMR1_CTRL) / 8u);
+		break;
+	case C_HAL_ADDR_ADC_CTRL:
+		HAL_AdcWrite( u16OldValue);
+		break;
+	default:
+		break;
+	}
+} /* End of HAL_PeriphWrite() */
+
+/* ****************************************************************************	*
+ * HAL_PeriphUpdate()
+ *
+ * Handle all peripheral events up to the current clock.
+ * Returns the clock of the next peripheral event.
+ * ****************************************************************************	*/
+uint64 HAL_PeriphUpdate( void)
+{
+	uint64 u64Next, u64PlantNext;
+	uint16 u16Timer;
+
+	while ( l_u64CoreTimerNext <= g_u64HalClock )
+	{
+		l_u32CoreTimerTicks++;
+		HAL_SetPending( EN_TIMER_IT);
+		l_u64CoreTimerNext += (uint64) l_u16CoreTimerReload * C_HAL_CLOCKS_PER_US;
+	}
+	for ( u16Timer = 0u; u16Timer < C_HAL_MAX_TIMER; u16Timer++ )
+	{
+		HAL_TIMER *pTimer = &l_aTimer[u16Timer];
+		while ( pTimer->u64Next <= g_u64HalClock )
+		{
+			uint16 u16Ctrl = HAL_IO16( C_HAL_ADDR_TMR1_CTRL + 8u * u16Timer);
+			pTimer->u32Compares++;
+			pTimer->u64Start = pTimer->u64Next;								/* Mode 0: Counter restarts at compare-B */
+			HAL_TimerSchedule( u16Timer);
+			if ( (u16Ctrl & (TMRx_MODE2 | TMRx_MODE1 | TMRx_MODE0)) != 0u )
+			{
+				HAL_SetXiPending( u16Timer, EN_T1_INT3);						/* Capture mode: Overflow */
+			}
+			else
+			{
+				HAL_SetXiPending( u16Timer, EN_T1_INT4);
+			}
+		}
+	}
+	while ( l_u64AdcNext <= g_u64HalClock )
+	{
+		HAL_AdcConversion();
+	}
+
+	u64Next = l_u64CoreTimerNext;
+	for ( u16Timer = 0u; u16Timer < C_HAL_MAX_TIMER; u16Timer++ )
+	{
+		if ( l_aTimer[u16Timer].u64Next < u64Next )
+		{
+			u64Next = l_aTimer[u16Timer].u64Next;
+		}
+	}
+	if ( l_u64AdcNext < u64Next )
+	{
+		u64Next = l_u64AdcNext;
+	}
+	u64PlantNext = HAL_PlantUpdate();
+	if ( u64PlantNext < u64Next )
+	{
+		u64Next = u64PlantNext;
+	}
+	return ( u64Next );
+} /* End of HAL_PeriphUpdate() */
+
+/* ****************************************************************************	*
+ * HAL_PeriphReport()
+ * ****************************************************************************	*/
+void HAL_PeriphReport( void)
+{
+	printf( "Peripherals:\n");
+	printf( "  Core-timer %10lu periods\n", (unsigned long) l_u32CoreTimerTicks);
+	printf( "  Timer1     %10lu compares\n", (unsigned long) l_aTimer[0].u32Compares);
+	printf( "  Timer2     %10lu compares\n", (unsigned long) l_aTimer[1].u32Compares);
+	printf( "  ADC        %10lu conversions, %lu sequences\n", (unsigned long) l_u32AdcConversions, (unsigned long) l_u32AdcSequences);
+	printf( "  SWI        %10lu requests\n", (unsigned long) l_u32SoftIrqs);
+	printf( "  NVRAM      %10lu stores\n", (unsigned long) l_u32NvramStores);
+} /* End of HAL_PeriphReport() */
+
+/* EOF */
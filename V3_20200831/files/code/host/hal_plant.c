@@ -0,0 +1,599 @@
+/*! ----------------------------------------------------------------------------
+ * \file		hal_plant.c
+ * \brief		Host build: Stepper-motor, hall-sensor and valve plant model
+ *
+ * \note		project MLX81315
+ *
+ * \author 		Marcel Braat
+ *
+ * \date 		2020-09-21
+ *
+ * \version 	1.0 - preliminary
+ *
+ * \functions	HAL_PlantInit()
+ *				HAL_PlantOption()
+ *				HAL_PlantUsage()
+ *				HAL_PlantUpdate()
+ *				HAL_PlantReport()
+ *				HAL_AdcChannel()
+ *
+ * Closed-loop model of the actuator, driven by the motor-driver I/O-ports:
+ * - Driver: Phase U, V, W and T voltage from DRVCFG and the PWMn_LT/HT
+ *   thresholds (PWM window, averaged over the PWM period);
+ * - Bi-polar stepper (BIPOLAR_MODE_UW_VT): Coil A between U and W, coil B
+ *   between V and T; Coil resistance NVRAM_MOTOR_COIL_RTOT (+ 2x FET),
+ *   inductance C_PLANT_COIL_L, back-EMF NVRAM_MOTOR_CONSTANT [10mV/RPS];
+ * - Rotor: Inertia, viscous friction, (position depended) Coulomb load
+ *   torque and mechanical end-stops (inelastic);
+ * - Hall-switch on IO[5]: Toggles every C_PLANT_HALL_PITCH full-steps, the
+ *   centre of the MotorStallCheckH() rebound window (option -H)
+ *   (XI4_IO5, edge selected by IO_CFG.FRB_IO5);
+ * - ADC: Supply voltage, chip temperature and the coil current of the coil
+ *   conducting at the hardware trigger moment (PWMn_CMP: centre, coil A;
+ *   PWMn_CNT: period start, coil B).
+ * A scripted LIN master sends actuator control frames (MSG_CONTROL).
+ *
+ * Metrics, per LIN command: time-to-position (rotor settled), final rotor
+ * position, peak coil current, end-stop contact and stall-detection latency
+ * (g_sMotorFault.ST); stalls reported without end-stop contact are counted
+ * as false stalls.
+ *
+ * MELEXIS Microelectronic Integrated Systems
+ *
+ * Copyright (C) 2020-2020 Melexis N.V.
+ * The Software is being delivered 'AS IS' and Melexis, whether explicitly or
+ * implicitly, makes no warranty as to its Use or performance.
+ * The user accepts the Melexis Firmware License Agreement.
+ *
+ * Melexis confidential & proprietary
+ * ****************************************************************************	*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "hal_sim.h"
+#include <ioports.h>
+#include "MotorDriver.h"
+#include "MotorStall.h"
+
+#define C_PLANT_DT_CLOCKS			(5U * C_HAL_CLOCKS_PER_US)					/* Integration step: 5us */
+#define C_PLANT_DT					((double) C_PLANT_DT_CLOCKS / (double) C_HAL_FCPU)
+#define C_PLANT_COIL_L				0.010										/* Coil inductance [H] */
+#define C_PLANT_INERTIA				3.0e-7										/* Rotor (and gear) inertia [kg.m2] */
+#define C_PLANT_VISCOUS				2.0e-5										/* Viscous friction [Nm.s/rad] */
+#define C_PLANT_DIODE				0.7											/* Body-diode forward voltage [V] */
+#define C_PLANT_SETTLE_FS			0.1											/* Settled: rotor within 0.1 FS */
+#define C_PLANT_HALL_PITCH			((double) (C_STALL_H_EDGE_MIN + C_STALL_H_EDGE_MAX) / (2.0 * (double) C_MICROSTEP_PER_FULLSTEP))	/* Full-steps per hall-edge */
+#define C_PLANT_MAX_CMD				64U
+#define C_PLANT_MAX_PROFILE			1024U										/* Load profile: one value per full-step */
+#define C_PLANT_ADC_VS(v)			((uint16) (((v) * 100.0 * 64.0) / 219.0))	/* See EE_V_OFFS_GAIN_CAL (HAL_PeriphInit) */
+#define C_PLANT_ADC_TJ				513U										/* 25C */
+#define C_PLANT_MA_PER_LSB			2.0											/* EE_GMCURR / C_GMCURR_DIV */
+#define C_PLANT_LIN_MSG_CONTROL		0x01U										/* MSG_CONTROL (LIN_Protocol.h) */
+#define C_PLANT_DEF_SCRIPT			"100:init,3000:960,6000:0"
+
+#define C_PLANT_CMD_INIT			0xFFFFU
+#define C_PLANT_CMD_STOP			0xFFFEU
+
+typedef struct _PLANT_CMD
+{
+	uint64 u64Clock;															/* Clock of LIN command */
+	uint16 u16Cmd;																/* Position [uStep] or C_PLANT_CMD_xxx */
+	/* Metrics */
+	uint64 u64Settled;															/* Last rotor movement */
+	uint64 u64Contact;															/* First end-stop contact (0: none) */
+	uint64 u64Stall;															/* Stall detected (0: none) */
+	double dPosition;															/* Rotor position at end of command [FS] */
+	double dPeakCurrent;														/* Peak coil current [A] */
+} PLANT_CMD;
+
+static double l_dVsupply = 12.0;												/* Supply voltage [V] */
+static double l_dLoad = 0.010;													/* Load torque [Nm] */
+static double l_dTravel = 260.0;												/* End-stop to end-stop [FS] */
+static double l_dStartPos = 120.0;												/* Initial rotor position [FS] */
+static double l_dHallPitch = C_PLANT_HALL_PITCH;								/* Full-steps per hall-switch edge */
+static uint32 l_u32Seed = 0u;													/* Random load profile (0: constant load) */
+static uint32 l_u32Random;
+static uint16 l_u16Csv = FALSE;
+static const char *l_pszScript = C_PLANT_DEF_SCRIPT;
+
+static double l_adLoadProfile[C_PLANT_MAX_PROFILE];
+static double l_dIa, l_dIb;														/* Coil currents [A] */
+static double l_dTheta;															/* Rotor position [rad, electric] */
+static double l_dOmega;															/* Rotor speed [rad/s, mechanic] */
+static double l_dRestPos;
+static uint16 l_u16Hall;
+static uint16 l_u16Contact = FALSE;
+static uint16 l_u16Stall = FALSE;
+static uint64 l_u64Next = 0u;
+static PLANT_CMD l_aCmd[C_PLANT_MAX_CMD];
+static uint16 l_u16Cmds = 0u;
+static uint16 l_u16CmdIdx = 0u;													/* Next command to send */
+static uint32 l_u32FalseStalls = 0u;
+static uint32 l_u32HallEdges = 0u;
+
+/* ****************************************************************************	*
+ *	Load profile																*
+ * ****************************************************************************	*/
+static uint32 HAL_PlantRandom( void)
+{
+	l_u32Random = (l_u32Random * 1103515245u) + 12345u;
+	return ( (l_u32Random >> 8) & 0xFFFFu );
+}
+
+static double HAL_PlantLoad( double dPosFS)
+{
+	int iIdx = (int) dPosFS;
+	if ( iIdx < 0 )
+	{
+		iIdx = 0;
+	}
+	if ( iIdx >= (int) C_PLANT_MAX_PROFILE )
+	{
+		iIdx = (int) C_PLANT_MAX_PROFILE - 1;
+	}
+	return ( l_adLoadProfile[iIdx] );
+}
+
+/* ****************************************************************************	*
+ *	LIN master																	*
+ * ****************************************************************************	*/
+static void HAL_PlantParseScript( void)
+{
+	const char *psz = l_pszScript;
+	while ( (*psz != '\0') && (l_u16Cmds < C_PLANT_MAX_CMD) )
+	{
+		char *pszEnd;
+		PLANT_CMD *pCmd = &l_aCmd[l_u16Cmds];
+		unsigned long ulTime = strtoul( psz, &pszEnd, 0);
+		if ( *pszEnd != ':' )
+		{
+			fprintf( stderr, "Invalid LIN script: %s\n", l_pszScript);
+			exit( 2);
+		}
+		psz = pszEnd + 1;
+		memset( pCmd, 0, sizeof(*pCmd));
+		pCmd->u64Clock = (uint64) ulTime * (C_HAL_FCPU / 1000u);
+		if ( strncmp( psz, "init", 4) == 0 )
+		{
+			pCmd->u16Cmd = C_PLANT_CMD_INIT;
+			psz += 4;
+		}
+		else if ( strncmp( psz, "stop", 4) == 0 )
+		{
+			pCmd->u16Cmd = C_PLANT_CMD_STOP;
+			psz += 4;
+		}
+		else
+		{
+			pCmd->u16Cmd = (uint16) strtoul( psz, &pszEnd, 0);
+			psz = pszEnd;
+		}
+		if ( *psz == ',' )
+		{
+			psz++;
+		}
+		l_u16Cmds++;
+	}
+}
+
+static void HAL_PlantSendCmd( const PLANT_CMD *pCmd)
+{
+	uint8 au8Frame[8] = { 0u, 0u, 0u, 0xFFu, 0xFFu, 0xFFu, 0xFFu, 0xFFu };
+	if ( pCmd->u16Cmd == C_PLANT_CMD_INIT )
+	{
+		au8Frame[2] = 0x01u | (0x01u << 1);										/* EnableRequest & InitRequest */
+	}
+	else if ( pCmd->u16Cmd != C_PLANT_CMD_STOP )
+	{
+		au8Frame[0] = (uint8) (pCmd->u16Cmd & 0xFFu);							/* PositionRequest */
+		au8Frame[1] = (uint8) (pCmd->u16Cmd >> 8);
+		au8Frame[2] = 0x01u;													/* EnableRequest */
+	}
+	HAL_LinReceive( C_PLANT_LIN_MSG_CONTROL, au8Frame);
+}
+
+/* ****************************************************************************	*
+ *	Motor driver																*
+ * ****************************************************************************	*/
+
+/* Phase output (0.0 .. 1.0 of supply), or negative in case of tri-state */
+static double HAL_PlantPhase( uint16 u16Phase, uint16 u16PwmBase)
+{
+	uint16 u16DrvCfg = HAL_IO16( C_HAL_ADDR_DRVCFG);
+	uint16 u16Cfg = (u16DrvCfg >> (2u * u16Phase)) & 3u;
+	double dDuty = -1.0;
+
+	if ( (u16DrvCfg & DIS_DRV) != 0u )
+	{
+		u16Cfg = 0u;
+	}
+	if ( u16Cfg == 1u )
+	{
+		/* PWM: Output high between LT and HT (LT > HT: Around period start/end) */
+		int32 i32Period = (int32) HAL_IO16( C_HAL_ADDR_PWM1_PER) + 1;
+		int32 i32Lt = (int32) HAL_IO16( u16PwmBase);
+		int32 i32Ht = (int32) HAL_IO16( u16PwmBase + 2u);
+		int32 i32High = (i32Lt <= i32Ht) ? (i32Ht - i32Lt) : ((i32Period - i32Lt) + i32Ht);
+		if ( i32High < 0 )
+		{
+			i32High = 0;
+		}
+		if ( i32High > i32Period )
+		{
+			i32High = i32Period;
+		}
+		dDuty = (double) i32High / (double) i32Period;
+	}
+	else if ( u16Cfg == 2u )
+	{
+		dDuty = 0.0;
+	}
+	else if ( u16Cfg == 3u )
+	{
+		dDuty = 1.0;
+	}
+	return ( dDuty );
+}
+
+/* Coil current update; dPos/dNeg: phase outputs, dEmf: back-EMF */
+static double HAL_PlantCoil( double dCurrent, double dPos, double dNeg, double dEmf, double dR)
+{
+	double dVoltage;
+	double dNew;
+	if ( (dPos < 0.0) || (dNeg < 0.0) )
+	{
+		/* Tri-state: Current decays through the body-diodes */
+		if ( dCurrent == 0.0 )
+		{
+			return ( 0.0 );
+		}
+		dVoltage = (dCurrent > 0.0) ? -(l_dVsupply + 2.0 * C_PLANT_DIODE) : (l_dVsupply + 2.0 * C_PLANT_DIODE);
+		dNew = dCurrent + ((dVoltage - dR * dCurrent - dEmf) / C_PLANT_COIL_L) * C_PLANT_DT;
+		if ( (dNew * dCurrent) <= 0.0 )
+		{
+			dNew = 0.0;
+		}
+		return ( dNew );
+	}
+	dVoltage = (dPos - dNeg) * l_dVsupply;
+	return ( dCurrent + ((dVoltage - dR * dCurrent - dEmf) / C_PLANT_COIL_L) * C_PLANT_DT );
+}
+
+/* ****************************************************************************	*
+ * HAL_PlantStep()
+ *
+ * One integration step of the electric and mechanic model.
+ * ****************************************************************************	*/
+static void HAL_PlantStep( void)
+{
+	double dR = (double) (NVRAM_MOTOR_COIL_RTOT + (2u * C_FETS_RTOT));
+	double dPolePairs = (NVRAM_POLE_PAIRS != 0u) ? (double) NVRAM_POLE_PAIRS : 1.0;
+	double dKe = ((double) NVRAM_MOTOR_CONSTANT * 0.01) / (2.0 * M_PI);		/* [V.s/rad] = [Nm/A] */
+	double dCos = cos( l_dTheta);
+	double dSin = sin( l_dTheta);
+	double dU = HAL_PlantPhase( 0u, C_HAL_ADDR_PWM1_LT + 30u);
+	double dV = HAL_PlantPhase( 1u, C_HAL_ADDR_PWM1_LT + 20u);
+	double dW = HAL_PlantPhase( 2u, C_HAL_ADDR_PWM1_LT + 10u);
+	double dT = HAL_PlantPhase( 3u, C_HAL_ADDR_PWM1_LT + 40u);
+	double dTorque, dLoad, dPosFS;
+
+	if ( dR < 1.0 )
+	{
+		dR = 1.0;
+	}
+
+	/* Electric: Coil A (W-U): Psi.sin(theta), coil B (T-V): Psi.cos(theta) */
+	l_dIa = HAL_PlantCoil( l_dIa, dW, dU, dKe * l_dOmega * dCos, dR);
+	l_dIb = HAL_PlantCoil( l_dIb, dT, dV, -dKe * l_dOmega * dSin, dR);
+
+	/* Mechanic */
+	dPosFS = l_dTheta * (2.0 / M_PI);
+	dTorque = dKe * ((l_dIa * dCos) - (l_dIb * dSin)) - (C_PLANT_VISCOUS * l_dOmega);
+	dLoad = HAL_PlantLoad( dPosFS);
+	if ( l_dOmega == 0.0 )
+	{
+		if ( fabs( dTorque) > dLoad )
+		{
+			l_dOmega = ((dTorque - copysign( dLoad, dTorque)) / C_PLANT_INERTIA) * C_PLANT_DT;
+		}
+	}
+	else
+	{
+		double dOmega = l_dOmega + ((dTorque - copysign( dLoad, l_dOmega)) / C_PLANT_INERTIA) * C_PLANT_DT;
+		l_dOmega = ((dOmega * l_dOmega) < 0.0) ? 0.0 : dOmega;
+	}
+	l_dTheta += l_dOmega * dPolePairs * C_PLANT_DT;
+
+	/* End-stops */
+	dPosFS = l_dTheta * (2.0 / M_PI);
+	l_u16Contact = FALSE;
+	if ( dPosFS <= 0.0 )
+	{
+		l_dTheta = 0.0;
+		if ( l_dOmega < 0.0 )
+		{
+			l_dOmega = 0.0;
+		}
+		l_u16Contact = (dTorque < 0.0);
+	}
+	else if ( dPosFS >= l_dTravel )
+	{
+		l_dTheta = l_dTravel * (M_PI / 2.0);
+		if ( l_dOmega > 0.0 )
+		{
+			l_dOmega = 0.0;
+		}
+		l_u16Contact = (dTorque > 0.0);
+	}
+	else
+	{
+	}
+
+	/* Hall-switch on IO[5] and TC1 (Timer2 input-A, if routed) */
+	{
+		uint16 u16Hall = (uint16) (((int) floor( l_dTheta * (2.0 / M_PI) / l_dHallPitch)) & 1);
+		if ( u16Hall != l_u16Hall )
+		{
+			uint16 u16Falling = ((HAL_IO16( C_HAL_ADDR_IO_CFG) & FRB_IO5) != 0u);
+			l_u16Hall = u16Hall;
+			l_u32HallEdges++;
+			if ( u16Hall != 0u )
+			{
+				HAL_IO16( C_HAL_ADDR_IO_IN) |= XI4_IO5;
+			}
+			else
+			{
+				HAL_IO16( C_HAL_ADDR_IO_IN) &= ~XI4_IO5;
+			}
+			if ( (u16Hall != 0u) != (u16Falling != 0u) )
+			{
+				HAL_SetXiPending( 4u, XI4_IO5);
+			}
+			if ( (HAL_IO16( C_HAL_ADDR_ANA_OUTI) & ((uint16) 3u << 4)) == T2_INA_TC1 )
+			{
+				HAL_TimerCapture( 1u, u16Hall);
+			}
+		}
+	}
+}
+
+/* ****************************************************************************	*
+ * HAL_PlantMetrics()
+ * ****************************************************************************	*/
+static void HAL_PlantMetrics( void)
+{
+	double dPosFS = l_dTheta * (2.0 / M_PI);
+	uint16 u16Stall = (g_sMotorFault.ST != 0u);
+	PLANT_CMD *pCmd = (l_u16CmdIdx != 0u) ? &l_aCmd[l_u16CmdIdx - 1u] : NULL;
+
+	if ( fabs( dPosFS - l_dRestPos) > C_PLANT_SETTLE_FS )
+	{
+		l_dRestPos = dPosFS;
+		if ( pCmd != NULL )
+		{
+			pCmd->u64Settled = g_u64HalClock;
+		}
+	}
+	if ( pCmd == NULL )
+	{
+		l_u16Stall = u16Stall;
+		return;
+	}
+	if ( fabs( l_dIa) > pCmd->dPeakCurrent )
+	{
+		pCmd->dPeakCurrent = fabs( l_dIa);
+	}
+	if ( fabs( l_dIb) > pCmd->dPeakCurrent )
+	{
+		pCmd->dPeakCurrent = fabs( l_dIb);
+	}
+	if ( l_u16Contact && (pCmd->u64Contact == 0u) )
+	{
+		pCmd->u64Contact = g_u64HalClock;
+	}
+	if ( u16Stall && !l_u16Stall )
+	{
+		if ( pCmd->u64Contact != 0u )
+		{
+			if ( pCmd->u64Stall == 0u )
+			{
+				pCmd->u64Stall = g_u64HalClock;
+			}
+		}
+		else
+		{
+			l_u32FalseStalls++;
+		}
+	}
+	l_u16Stall = u16Stall;
+	pCmd->dPosition = dPosFS;
+}
+
+/* ****************************************************************************	*
+ * HAL_PlantInit()
+ * ****************************************************************************	*/
+void HAL_PlantInit( void)
+{
+	uint16 u16Idx;
+	l_u32Random = l_u32Seed;
+	for ( u16Idx = 0u; u16Idx < C_PLANT_MAX_PROFILE; u16Idx++ )
+	{
+		l_adLoadProfile[u16Idx] = l_dLoad;
+		if ( l_u32Seed != 0u )
+		{
+			/* Load variation of +/- 50% per full-step */
+			l_adLoadProfile[u16Idx] *= 0.5 + ((double) HAL_PlantRandom() / 65535.0);
+		}
+	}
+	l_dTheta = l_dStartPos * (M_PI / 2.0);
+	l_dRestPos = l_dStartPos;
+	l_dOmega = 0.0;
+	l_dIa = 0.0;
+	l_dIb = 0.0;
+	l_u16Hall = (uint16) (((int) floor( l_dStartPos / l_dHallPitch)) & 1);
+	HAL_IO16( C_HAL_ADDR_IO_IN) = (l_u16Hall != 0u) ? XI4_IO5 : 0u;
+	HAL_PlantParseScript();
+	l_u64Next = 0u;
+} /* End of HAL_PlantInit() */
+
+/* ****************************************************************************	*
+ * HAL_PlantOption()
+ *
+ * Command line option of the plant; Returns FALSE if not a plant option.
+ * ****************************************************************************	*/
+uint16 HAL_PlantOption( int iOpt, const char *pszArg)
+{
+	switch ( iOpt )
+	{
+	case 'L':
+		l_dLoad = strtod( pszArg, NULL) / 1000.0;
+		break;
+	case 'R':
+		l_u32Seed = (uint32) strtoul( pszArg, NULL, 0);
+		break;
+	case 'p':
+		l_dStartPos = strtod( pszArg, NULL);
+		break;
+	case 'e':
+		l_dTravel = strtod( pszArg, NULL);
+		break;
+	case 'H':
+		l_dHallPitch = strtod( pszArg, NULL);
+		break;
+	case 'V':
+		l_dVsupply = strtod( pszArg, NULL);
+		break;
+	case 'm':
+		l_pszScript = pszArg;
+		break;
+	case 'C':
+		l_u16Csv = TRUE;
+		break;
+	default:
+		return ( FALSE );
+	}
+	return ( TRUE );
+} /* End of HAL_PlantOption() */
+
+void HAL_PlantUsage( void)
+{
+	fprintf( stderr,
+		"  -L mNm     Load torque (default: %.0f)\n"
+		"  -R seed    Random load profile, +/-50%% per full-step (default: constant load)\n"
+		"  -p FS      Initial rotor position from lower end-stop (default: %.0f)\n"
+		"  -e FS      Travel between end-stops (default: %.0f)\n"
+		"  -H FS      Full-steps per hall-switch edge (default: %.0f)\n"
+		"  -V volt    Supply voltage (default: %.1f)\n"
+		"  -m script  LIN master: ms:init|stop|position[,...] (default: %s)\n"
+		"  -C         Metrics in CSV format\n",
+		l_dLoad * 1000.0, l_dStartPos, l_dTravel, l_dHallPitch, l_dVsupply, C_PLANT_DEF_SCRIPT);
+} /* End of HAL_PlantUsage() */
+
+/* ****************************************************************************	*
+ * HAL_PlantUpdate()
+ *
+ * Run the plant up to the current clock. Returns the clock of the next step.
+ * ****************************************************************************	*/
+uint64 HAL_PlantUpdate( void)
+{
+	while ( l_u64Next <= g_u64HalClock )
+	{
+		while ( (l_u16CmdIdx < l_u16Cmds) && (l_aCmd[l_u16CmdIdx].u64Clock <= l_u64Next) )
+		{
+			l_aCmd[l_u16CmdIdx].u64Settled = l_aCmd[l_u16CmdIdx].u64Clock;
+			HAL_PlantSendCmd( &l_aCmd[l_u16CmdIdx]);
+			l_u16CmdIdx++;
+		}
+		HAL_PlantStep();
+		HAL_PlantMetrics();
+		l_u64Next += C_PLANT_DT_CLOCKS;
+	}
+	return ( l_u64Next );
+} /* End of HAL_PlantUpdate() */
+
+/* ****************************************************************************	*
+ * HAL_AdcChannel()
+ *
+ * Plant analogue inputs; u16Trigger: ADC hardware trigger (ADC_HW_TRIGGER_xxx)
+ * ****************************************************************************	*/
+uint16 HAL_AdcChannel( uint16 u16Channel, uint16 u16Trigger)
+{
+	double dResult = 0.0;
+	switch ( u16Channel )
+	{
+	case 0u:																	/* VS/14 */
+	case 4u:																	/* VSM/14 (filtered) */
+	case 14u:																	/* VSM/14 */
+		dResult = C_PLANT_ADC_VS( l_dVsupply);
+		break;
+	case 1u:																	/* Chip temperature */
+		dResult = C_PLANT_ADC_TJ;
+		break;
+	case 13u:																	/* Motor-driver current (unfiltered) */
+	case 29u:																	/* Motor-driver current (filtered) */
+		dResult = (fabs( ((u16Trigger & ADC_HW_TRIGGER_PWM1_CMP) != 0u) ? l_dIa : l_dIb) * 1000.0) / C_PLANT_MA_PER_LSB;
+		break;
+	default:
+		break;
+	}
+	return ( (dResult > 1023.0) ? 1023u : (uint16) dResult );
+} /* End of HAL_AdcChannel() */
+
+/* ****************************************************************************	*
+ * HAL_PlantReport()
+ * ****************************************************************************	*/
+void HAL_PlantReport( void)
+{
+	uint16 u16Idx;
+	const double dMsPerClock = 1000.0 / (double) C_HAL_FCPU;
+
+	if ( !l_u16Csv )
+	{
+		printf( "Plant:        load %.1f mNm%s, Vs %.1f V, travel %.0f FS, %lu hall-edges, %lu false stall(s)\n",
+			l_dLoad * 1000.0, (l_u32Seed != 0u) ? " (random)" : "", l_dVsupply, l_dTravel,
+			(unsigned long) l_u32HallEdges, (unsigned long) l_u32FalseStalls);
+		printf( "  t[ms]  command  t-pos[ms]  pos[FS]  Ipk[mA]  contact[ms]  stall-latency[ms]\n");
+	}
+	for ( u16Idx = 0u; u16Idx < l_u16CmdIdx; u16Idx++ )
+	{
+		const PLANT_CMD *pCmd = &l_aCmd[u16Idx];
+		char szCmd[8];
+		double dLatency = -1.0;
+		if ( pCmd->u16Cmd == C_PLANT_CMD_INIT )
+		{
+			strcpy( szCmd, "init");
+		}
+		else if ( pCmd->u16Cmd == C_PLANT_CMD_STOP )
+		{
+			strcpy( szCmd, "stop");
+		}
+		else
+		{
+			snprintf( szCmd, sizeof(szCmd), "%u", pCmd->u16Cmd);
+		}
+		if ( (pCmd->u64Contact != 0u) && (pCmd->u64Stall != 0u) )
+		{
+			dLatency = (double) (pCmd->u64Stall - pCmd->u64Contact) * dMsPerClock;
+		}
+		if ( l_u16Csv )
+		{
+			printf( "csv,%.1f,%lu,%.0f,%s,%.1f,%.2f,%.1f,%.1f,%.2f,%lu\n",
+				l_dLoad * 1000.0, (unsigned long) l_u32Seed, (double) pCmd->u64Clock * dMsPerClock, szCmd,
+				(double) (pCmd->u64Settled - pCmd->u64Clock) * dMsPerClock, pCmd->dPosition, pCmd->dPeakCurrent * 1000.0,
+				(pCmd->u64Contact != 0u) ? (double) (pCmd->u64Contact - pCmd->u64Clock) * dMsPerClock : -1.0,
+				dLatency, (unsigned long) l_u32FalseStalls);
+		}
+		else
+		{
+			printf( "  %5.0f  %-7s  %9.1f  %7.2f  %7.1f  %11.1f  %17.2f\n",
+				(double) pCmd->u64Clock * dMsPerClock, szCmd,
+				(double) (pCmd->u64Settled - pCmd->u64Clock) * dMsPerClock, pCmd->dPosition, pCmd->dPeakCurrent * 1000.0,
+				(pCmd->u64Contact != 0u) ? (double) (pCmd->u64Contact - pCmd->u64Clock) * dMsPerClock : -1.0,
+				dLatency);
+		}
+	}
+} /* End of HAL_PlantReport() */
+
+/* EOF */
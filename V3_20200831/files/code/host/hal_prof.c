@@ -0,0 +1,374 @@
+/*! ----------------------------------------------------------------------------
+ * \file		hal_prof.c
+ * \brief		Host build: Function and ISR cycle profile, cycle budgets
+ *
+ * \note		project MLX81315
+ *
+ * \author 		Marcel Braat
+ *
+ * \date 		2020-09-24
+ *
+ * \version 	1.0 - preliminary
+ *
+ * \functions	HAL_ProfInit()
+ *				HAL_ProfEnter()
+ *				HAL_ProfLeave()
+ *				HAL_ProfSteal()
+ *				HAL_ProfOption()
+ *				HAL_ProfUsage()
+ *				HAL_ProfReport()
+ *
+ * Each application function entry/exit (__tsan_func_entry/exit) is recorded
+ * on a shadow call-stack. Per function: number of calls, and the simulated
+ * clocks per call (inclusive callees), excluding the clocks of preempting
+ * ISR's and of HALT (HAL_ProfSteal()). An ISR is a function at the next
+ * nesting level, so the EXT0_IT figures are per ISR invocation.
+ *
+ * Cycle budgets (-b function=clocks) are checked against the maximum clocks
+ * of a single call; A violated budget fails the simulation (exit code 3).
+ *
+ * The functions are identified by an address within the function (return
+ * address of the entry hook), and named from the symbol table of the host
+ * executable at the end of the simulation.
+ *
+ * MELEXIS Microelectronic Integrated Systems
+ *
+ * Copyright (C) 2020-2020 Melexis N.V.
+ * The Software is being delivered 'AS IS' and Melexis, whether explicitly or
+ * implicitly, makes no warranty as to its Use or performance.
+ * The user accepts the Melexis Firmware License Agreement.
+ *
+ * Melexis confidential & proprietary
+ * ****************************************************************************	*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <elf.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "hal_sim.h"
+#include "Build.h"
+
+#define C_PROF_MAX_FUNC				1024U										/* Power of 2 (hash table) */
+#define C_PROF_STACK_DEPTH			128U
+#define C_PROF_MAX_LEVEL			8U											/* ISR nesting levels */
+#define C_PROF_MAX_BUDGET			16U
+
+typedef struct _PROF_FUNC
+{
+	uintptr_t uAddress;															/* Address within the function (0: free) */
+	const char *pszName;
+	uint32 u32Calls;
+	uint64 u64Clocks;															/* Total clocks (inclusive callees) */
+	uint64 u64MaxClocks;														/* Maximum clocks of a single call */
+} PROF_FUNC;
+
+typedef struct _PROF_FRAME
+{
+	PROF_FUNC *pFunc;
+	uint64 u64Start;															/* Clock at entry */
+	uint64 u64Stolen;															/* Stolen clocks at entry, at the level of the frame */
+	uint16 u16Level;
+} PROF_FRAME;
+
+typedef struct _PROF_BUDGET
+{
+	const char *pszName;
+	uint64 u64Clocks;
+} PROF_BUDGET;
+
+static PROF_FUNC *l_aFunc;														/* Heap: Outside the 64kB data window */
+static PROF_FRAME *l_aStack;
+static uint16 l_u16StackIdx = 0u;
+static uint32 l_u32Overflows = 0u;
+static uint64 l_au64Stolen[C_PROF_MAX_LEVEL];									/* Clocks stolen from each nesting level */
+static PROF_BUDGET l_aBudget[C_PROF_MAX_BUDGET];
+static uint16 l_u16Budgets = 0u;
+static uint16 l_u16ReportLines = 0u;											/* Functions in the report (0: none) */
+
+static PROF_FUNC *HAL_ProfLookup( uintptr_t uAddress)
+{
+	uint32 u32Idx = (uint32) ((uAddress >> 2) * 2654435761u) & (C_PROF_MAX_FUNC - 1u);
+	uint32 u32Probe;
+	for ( u32Probe = 0u; u32Probe < C_PROF_MAX_FUNC; u32Probe++ )
+	{
+		PROF_FUNC *pFunc = &l_aFunc[u32Idx];
+		if ( pFunc->uAddress == uAddress )
+		{
+			return ( pFunc );
+		}
+		if ( pFunc->uAddress == 0u )
+		{
+			pFunc->uAddress = uAddress;
+			return ( pFunc );
+		}
+		u32Idx = (u32Idx + 1u) & (C_PROF_MAX_FUNC - 1u);
+	}
+	return ( NULL );
+}
+
+/* ****************************************************************************	*
+ * HAL_ProfInit()
+ * ****************************************************************************	*/
+void HAL_ProfInit( void)
+{
+	l_aFunc = calloc( C_PROF_MAX_FUNC, sizeof(PROF_FUNC));
+	l_aStack = calloc( C_PROF_STACK_DEPTH, sizeof(PROF_FRAME));
+	if ( (l_aFunc == NULL) || (l_aStack == NULL) )
+	{
+		fprintf( stderr, "Out of memory (profile)\n");
+		exit( 1);
+	}
+} /* End of HAL_ProfInit() */
+
+/* ****************************************************************************	*
+ * HAL_ProfEnter()
+ *
+ * Function entry at ISR nesting level u16Level.
+ * ****************************************************************************	*/
+void HAL_ProfEnter( uintptr_t uAddress, uint16 u16Level)
+{
+	PROF_FRAME *pFrame;
+	if ( (l_u16StackIdx >= C_PROF_STACK_DEPTH) || (u16Level >= C_PROF_MAX_LEVEL) )
+	{
+		l_u32Overflows++;
+		l_u16StackIdx++;
+		return;
+	}
+	pFrame = &l_aStack[l_u16StackIdx++];
+	pFrame->pFunc = HAL_ProfLookup( uAddress);
+	pFrame->u64Start = g_u64HalClock;
+	pFrame->u64Stolen = l_au64Stolen[u16Level];
+	pFrame->u16Level = u16Level;
+} /* End of HAL_ProfEnter() */
+
+/* ****************************************************************************	*
+ * HAL_ProfLeave()
+ * ****************************************************************************	*/
+void HAL_ProfLeave( void)
+{
+	PROF_FRAME *pFrame;
+	PROF_FUNC *pFunc;
+	uint64 u64Clocks;
+	if ( l_u16StackIdx == 0u )
+	{
+		return;
+	}
+	if ( --l_u16StackIdx >= C_PROF_STACK_DEPTH )
+	{
+		return;
+	}
+	pFrame = &l_aStack[l_u16StackIdx];
+	pFunc = pFrame->pFunc;
+	if ( pFunc == NULL )
+	{
+		return;
+	}
+	u64Clocks = (g_u64HalClock - pFrame->u64Start) - (l_au64Stolen[pFrame->u16Level] - pFrame->u64Stolen);
+	pFunc->u32Calls++;
+	pFunc->u64Clocks += u64Clocks;
+	if ( u64Clocks > pFunc->u64MaxClocks )
+	{
+		pFunc->u64MaxClocks = u64Clocks;
+	}
+} /* End of HAL_ProfLeave() */
+
+/* ****************************************************************************	*
+ * HAL_ProfSteal()
+ *
+ * u64Clocks are not spent by the code running at nesting level u16Level
+ * (preempting ISR or HALT).
+ * ****************************************************************************	*/
+void HAL_ProfSteal( uint16 u16Level, uint64 u64Clocks)
+{
+	if ( u16Level < C_PROF_MAX_LEVEL )
+	{
+		l_au64Stolen[u16Level] += u64Clocks;
+	}
+} /* End of HAL_ProfSteal() */
+
+/* ****************************************************************************	*
+ * HAL_ProfOption()
+ *
+ * Command line option of the profiler; Returns FALSE if not a profiler option.
+ * ****************************************************************************	*/
+uint16 HAL_ProfOption( int iOpt, const char *pszArg)
+{
+	if ( iOpt == 'P' )
+	{
+		l_u16ReportLines = (uint16) strtoul( pszArg, NULL, 0);
+	}
+	else if ( iOpt == 'b' )
+	{
+		const char *pszValue = strchr( pszArg, '=');
+		if ( (pszValue == NULL) || (l_u16Budgets >= C_PROF_MAX_BUDGET) )
+		{
+			return ( FALSE );
+		}
+		l_aBudget[l_u16Budgets].pszName = strndup( pszArg, (size_t) (pszValue - pszArg));
+		l_aBudget[l_u16Budgets].u64Clocks = strtoull( pszValue + 1, NULL, 0);
+		l_u16Budgets++;
+	}
+	else
+	{
+		return ( FALSE );
+	}
+	return ( TRUE );
+} /* End of HAL_ProfOption() */
+
+void HAL_ProfUsage( void)
+{
+	fprintf( stderr,
+		"  -P n       Profile: n functions with the most clocks (default: none)\n"
+		"  -b f=clk   Cycle budget: maximum clocks per call of function f (repeatable)\n");
+} /* End of HAL_ProfUsage() */
+
+/* ****************************************************************************	*
+ * HAL_ProfResolve()
+ *
+ * Name the profiled functions, using the symbol table of the host executable.
+ * ****************************************************************************	*/
+static void HAL_ProfResolve( void)
+{
+	struct stat sStat;
+	const uint8 *pu8Elf;
+	const Elf64_Ehdr *pEhdr;
+	const Elf64_Shdr *pShdr;
+	uint16 u16Sec;
+	int iFd = open( "/proc/self/exe", O_RDONLY);
+
+	if ( iFd < 0 )
+	{
+		return;
+	}
+	if ( (fstat( iFd, &sStat) != 0) ||
+		 ((pu8Elf = mmap( NULL, (size_t) sStat.st_size, PROT_READ, MAP_PRIVATE, iFd, 0)) == MAP_FAILED) )
+	{
+		close( iFd);
+		return;
+	}
+	close( iFd);
+	pEhdr = (const Elf64_Ehdr *) pu8Elf;
+	pShdr = (const Elf64_Shdr *) (pu8Elf + pEhdr->e_shoff);
+	for ( u16Sec = 0u; u16Sec < pEhdr->e_shnum; u16Sec++ )
+	{
+		if ( pShdr[u16Sec].sh_type == SHT_SYMTAB )
+		{
+			const Elf64_Sym *pSym = (const Elf64_Sym *) (pu8Elf + pShdr[u16Sec].sh_offset);
+			const char *pszStr = (const char *) (pu8Elf + pShdr[pShdr[u16Sec].sh_link].sh_offset);
+			size_t uSyms = pShdr[u16Sec].sh_size / sizeof(Elf64_Sym);
+			size_t uSym;
+			for ( uSym = 0u; uSym < uSyms; uSym++ )
+			{
+				uint32 u32Idx;
+				if ( ELF64_ST_TYPE( pSym[uSym].st_info) != STT_FUNC )
+				{
+					continue;
+				}
+				for ( u32Idx = 0u; u32Idx < C_PROF_MAX_FUNC; u32Idx++ )
+				{
+					PROF_FUNC *pFunc = &l_aFunc[u32Idx];
+					if ( (pFunc->uAddress >= pSym[uSym].st_value) &&
+						 (pFunc->uAddress < (pSym[uSym].st_value + pSym[uSym].st_size)) )
+					{
+						pFunc->pszName = pszStr + pSym[uSym].st_name;
+					}
+				}
+			}
+		}
+	}
+	/* The mapping remains; The names are used by the report */
+} /* End of HAL_ProfResolve() */
+
+static int HAL_ProfCompare( const void *pA, const void *pB)
+{
+	const PROF_FUNC *pFuncA = *(const PROF_FUNC * const *) pA;
+	const PROF_FUNC *pFuncB = *(const PROF_FUNC * const *) pB;
+	return ( (pFuncA->u64Clocks < pFuncB->u64Clocks) ? 1 : ((pFuncA->u64Clocks > pFuncB->u64Clocks) ? -1 : 0) );
+}
+
+/* ****************************************************************************	*
+ * HAL_ProfReport()
+ *
+ * Report the profile and check the cycle budgets; Returns FALSE in case a
+ * budget is exceeded.
+ * ****************************************************************************	*/
+uint16 HAL_ProfReport( void)
+{
+	PROF_FUNC **apFunc;
+	uint32 u32Funcs = 0u;
+	uint32 u32Idx;
+	uint16 u16Budget;
+	uint16 u16Result = TRUE;
+
+	if ( (l_u16ReportLines == 0u) && (l_u16Budgets == 0u) )
+	{
+		return ( TRUE );
+	}
+	HAL_ProfResolve();
+	apFunc = calloc( C_PROF_MAX_FUNC, sizeof(PROF_FUNC *));
+	if ( apFunc == NULL )
+	{
+		return ( FALSE );
+	}
+	for ( u32Idx = 0u; u32Idx < C_PROF_MAX_FUNC; u32Idx++ )
+	{
+		if ( l_aFunc[u32Idx].u32Calls != 0u )
+		{
+			apFunc[u32Funcs++] = &l_aFunc[u32Idx];
+		}
+	}
+	qsort( apFunc, u32Funcs, sizeof(apFunc[0]), HAL_ProfCompare);
+
+	if ( l_u16ReportLines != 0u )
+	{
+		printf( "Functions:    %lu profiled%s\n", (unsigned long) u32Funcs,
+			(l_u32Overflows != 0u) ? " (shadow call-stack overflow)" : "");
+		printf( "  %-36s %10s %12s %8s %8s %7s\n", "function", "calls", "clocks", "avg", "max", "CPU");
+		for ( u32Idx = 0u; (u32Idx < u32Funcs) && (u32Idx < l_u16ReportLines); u32Idx++ )
+		{
+			const PROF_FUNC *pFunc = apFunc[u32Idx];
+			printf( "  %-36s %10lu %12llu %8.1f %8llu %6.2f%%\n",
+				(pFunc->pszName != NULL) ? pFunc->pszName : "?", (unsigned long) pFunc->u32Calls,
+				(unsigned long long) pFunc->u64Clocks, (double) pFunc->u64Clocks / (double) pFunc->u32Calls,
+				(unsigned long long) pFunc->u64MaxClocks,
+				(g_u64HalClock != 0u) ? (100.0 * (double) pFunc->u64Clocks / (double) g_u64HalClock) : 0.0);
+		}
+	}
+
+	for ( u16Budget = 0u; u16Budget < l_u16Budgets; u16Budget++ )
+	{
+		const PROF_BUDGET *pBudget = &l_aBudget[u16Budget];
+		const PROF_FUNC *pFound = NULL;
+		for ( u32Idx = 0u; u32Idx < u32Funcs; u32Idx++ )
+		{
+			if ( (apFunc[u32Idx]->pszName != NULL) && (strcmp( apFunc[u32Idx]->pszName, pBudget->pszName) == 0) )
+			{
+				pFound = apFunc[u32Idx];
+				break;
+			}
+		}
+		if ( pFound == NULL )
+		{
+			printf( "Budget:       %-24s not called\n", pBudget->pszName);
+		}
+		else
+		{
+			uint16 u16Pass = (pFound->u64MaxClocks <= pBudget->u64Clocks);
+			printf( "Budget:       %-24s max %8llu <= %8llu clocks: %s\n", pBudget->pszName,
+				(unsigned long long) pFound->u64MaxClocks, (unsigned long long) pBudget->u64Clocks,
+				u16Pass ? "pass" : "FAIL");
+			if ( !u16Pass )
+			{
+				u16Result = FALSE;
+			}
+		}
+	}
+	free( apFunc);
+	return ( u16Result );
+} /* End of HAL_ProfReport() */
+
+/* EOF */
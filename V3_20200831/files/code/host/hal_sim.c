@@ -0,0 +1,577 @@
+/*! ----------------------------------------------------------------------------
+ * \file		hal_sim.c
+ * \brief		Host build: MLX81315 simulator core
+ *
+ * \note		project MLX81315
+ *
+ * \author 		Marcel Braat
+ *
+ * \date 		2020-09-14
+ *
+ * \version 	1.0 - preliminary
+ *
+ * \functions	HAL_SetPriority()
+ *				HAL_GetCpuStatus()
+ *				HAL_SetCpuStatus()
+ *				HAL_PushPriority()
+ *				HAL_PopPriority()
+ *				HAL_EnterUserMode()
+ *				HAL_EnterSystemMode()
+ *				HAL_Delay()
+ *				HAL_LoopForever()
+ *				HAL_Halt()
+ *				HAL_Advance()
+ *				HAL_SetPending()
+ *				HAL_HostAddress()
+ *				HAL_Stop()
+ *				__tsan_xxx()
+ *				main()
+ *
+ * The application sources are compiled with -fsanitize=thread, without the
+ * thread-sanitizer run-time library: Each memory access (and function entry)
+ * calls one of the __tsan_xxx() hooks below. The hooks advance the simulated
+ * MLX16 clock (l_u16ClocksPerAccess per access), feed the I/O-port accesses to
+ * the peripheral models and dispatch the pending (and enabled) interrupts in
+ * the same way as the MLX16 interrupt controller:
+ * - An interrupt of level L is accepted when L <= the CPU priority;
+ * - The ISR runs at the absolute priority of the vector (vectors-lin.S);
+ * - Lowest level first, equal levels in vector order.
+ * A write hook is called before the store; The side-effects of an I/O-port
+ * write (e.g. write-1-to-clear) are therefore performed at the next hook.
+ *
+ * The application runs on a static stack (within the 64kB data window, see
+ * HAL_HostAddress()), until the simulated time expires or the application
+ * halts/resets the chip.
+ *
+ * The function entry/exit hooks also feed the function profile (hal_prof.c);
+ * Clocks of a preempting ISR or HALT are excluded from the interrupted code.
+ *
+ * MELEXIS Microelectronic Integrated Systems
+ *
+ * Copyright (C) 2020-2020 Melexis N.V.
+ * The Software is being delivered 'AS IS' and Melexis, whether explicitly or
+ * implicitly, makes no warranty as to its Use or performance.
+ * The user accepts the Melexis Firmware License Agreement.
+ *
+ * Melexis confidential & proprietary
+ * ****************************************************************************	*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include "hal_sim.h"
+
+#define C_HAL_APP_STACK_SIZE		0x4000U										/* Application stack (host frames are larger than MLX16 frames) */
+#define C_HAL_PRIO_STACK_DEPTH		8U
+#define C_HAL_DEF_SIM_TIME			1000U										/* Default simulated time [ms] */
+#define C_HAL_DEF_CLOCKS_PER_ACCESS	2U											/* Default MLX16 clocks per memory access */
+
+/* Application entry; main.c is compiled with -Dmain=app_main */
+extern int16 app_main( void);
+
+/* Interrupt Service Routines (vectors-lin.S) */
+extern void ml_LinInterruptHandler( void);
+extern void TIMER_IT( void);
+extern void ADC_IT( void);
+extern void EXT0_IT( void);
+extern void EXT1_IT( void) __attribute__((weak));						/* Timer2 hall-edge capture (optional) */
+extern void EXT4_IT( void);
+extern void SOFT_IT( void);
+
+/* Host linker symbols: Begin of read-only data */
+extern const char etext[];
+extern char end[];
+
+typedef struct _HAL_VECTOR
+{
+	const char *pszName;
+	uint16 u16MaskBit;															/* MASK/PEND bit */
+	uint16 u16PrioShift;														/* PRIO field; C_HAL_PRIO_FIXED: u16Level */
+	uint16 u16Level;															/* Fixed interrupt level */
+	uint16 u16Psup;																/* Absolute ISR priority (psup) */
+	void (*pfnHandler)( void);													/* NULL: _fatal() */
+} HAL_VECTOR;
+
+#define C_HAL_PRIO_FIXED			0xFFFFU
+
+/* Vector table; See vectors-lin.S */
+static const HAL_VECTOR l_aVectors[HAL_MAX_IRQ] =
+{
+	{ "M4_SHE_IT", (1u << 4),  C_HAL_PRIO_FIXED, 5u, 4u, ml_LinInterruptHandler },
+	{ "TIMER_IT",  (1u << 5),  0u,               0u, 5u, TIMER_IT },
+	{ "ADC_IT",    (1u << 6),  2u,               0u, 4u, ADC_IT },
+	{ "EE_IT",     (1u << 7),  4u,               0u, 0u, NULL },
+	{ "EXT0_IT",   (1u << 8),  6u,               0u, 3u, EXT0_IT },
+	{ "EXT1_IT",   (1u << 9),  8u,               0u, 3u, EXT1_IT },
+	{ "EXT2_IT",   (1u << 10), 10u,              0u, 0u, NULL },
+	{ "EXT3_IT",   (1u << 11), 12u,              0u, 0u, NULL },
+	{ "EXT4_IT",   (1u << 12), 14u,              0u, 2u, EXT4_IT },
+	{ "SOFT_IT",   (1u << 13), C_HAL_PRIO_FIXED, 7u, 6u, SOFT_IT }
+};
+
+uint64 g_u64HalClock = 0u;														/* Simulated MLX16 CPU-clocks */
+
+static uint16 l_u16CpuStatus = 0u;												/* M-register: Priority and user-mode */
+static uint16 l_au16PrioStack[C_HAL_PRIO_STACK_DEPTH];
+static uint16 l_u16PrioStackIdx = 0u;
+static uint16 l_u16ClocksPerAccess = C_HAL_DEF_CLOCKS_PER_ACCESS;
+static uint64 l_u64NextEvent = 0u;												/* Next peripheral event [clocks] */
+static uint64 l_u64EndClock = 0u;												/* End of simulation [clocks] */
+static uint16 l_u16PendingWrAddr = 0u;											/* I/O-port write to be processed */
+static uint16 l_u16PendingWrOld = 0u;
+static uint16 l_u16PendingWrSize = 0u;
+static uint16 l_u16Nesting = 0u;
+static uint16 l_u16MaxNesting = 0u;
+static uint32 l_au32IrqCount[HAL_MAX_IRQ];
+static uint32 l_u32IrqTotal = 0u;
+static uint64 l_au64IrqClocks[HAL_MAX_IRQ];										/* Clocks spent in ISR (including nested ISR's) */
+static uint64 l_u64Accesses = 0u;
+static const char *l_pszStopReason = "";
+static ucontext_t l_HostContext;
+static ucontext_t l_AppContext;
+static uint8 l_au8AppStack[C_HAL_APP_STACK_SIZE] __attribute__((aligned(16)));
+
+static void HAL_Event( void);
+static inline void HAL_Flush( void);
+
+/* ****************************************************************************	*
+ * HAL_CheckIrq()
+ *
+ * Dispatch all pending and enabled interrupts which are accepted at the
+ * current CPU priority.
+ * ****************************************************************************	*/
+static void HAL_CheckIrq( void)
+{
+	for (;;)
+	{
+		uint16 u16Pending = HAL_IO16( C_HAL_ADDR_PEND) & HAL_IO16( C_HAL_ADDR_MASK);
+		uint16 u16Prio = HAL_IO16( C_HAL_ADDR_PRIO);
+		uint16 u16BestLevel = 0xFFFFu;
+		uint16 u16Best = HAL_MAX_IRQ;
+		uint16 u16Idx;
+		if ( u16Pending == 0u )
+		{
+			return;
+		}
+		for ( u16Idx = 0u; u16Idx < HAL_MAX_IRQ; u16Idx++ )
+		{
+			const HAL_VECTOR *pVector = &l_aVectors[u16Idx];
+			if ( (u16Pending & pVector->u16MaskBit) != 0u )
+			{
+				uint16 u16Level = pVector->u16Level;
+				if ( pVector->u16PrioShift != C_HAL_PRIO_FIXED )
+				{
+					u16Level = ((u16Prio >> pVector->u16PrioShift) & 3u) + 3u;
+				}
+				if ( u16Level < u16BestLevel )
+				{
+					u16BestLevel = u16Level;
+					u16Best = u16Idx;
+				}
+			}
+		}
+		if ( u16BestLevel > (l_u16CpuStatus & C_HAL_M_PRIO_MASK) )
+		{
+			return;																/* Not accepted at current priority */
+		}
+		{
+			const HAL_VECTOR *pVector = &l_aVectors[u16Best];
+			uint16 u16SavedStatus = l_u16CpuStatus;
+			uint64 u64Start = g_u64HalClock;
+			HAL_IO16( C_HAL_ADDR_PEND) &= ~pVector->u16MaskBit;					/* Acknowledge */
+			if ( pVector->pfnHandler == NULL )
+			{
+				HAL_Stop( pVector->pszName);									/* _fatal() */
+			}
+			l_au32IrqCount[u16Best]++;
+			l_u32IrqTotal++;
+			l_u16CpuStatus = pVector->u16Psup;									/* System-mode, absolute priority */
+			if ( ++l_u16Nesting > l_u16MaxNesting )
+			{
+				l_u16MaxNesting = l_u16Nesting;
+			}
+			pVector->pfnHandler();
+			HAL_Flush();
+			l_u16Nesting--;
+			l_u16CpuStatus = u16SavedStatus;									/* reti */
+			l_au64IrqClocks[u16Best] += (g_u64HalClock - u64Start);
+			HAL_ProfSteal( l_u16Nesting, g_u64HalClock - u64Start);
+		}
+	}
+} /* End of HAL_CheckIrq() */
+
+/* ****************************************************************************	*
+ * HAL_Flush()
+ *
+ * Perform the side-effects of the last I/O-port write.
+ * ****************************************************************************	*/
+static inline void HAL_Flush( void)
+{
+	if ( l_u16PendingWrAddr != 0u )
+	{
+		uint16 u16Address = l_u16PendingWrAddr;
+		l_u16PendingWrAddr = 0u;
+		HAL_PeriphWrite( u16Address, l_u16PendingWrOld, l_u16PendingWrSize);
+		l_u64NextEvent = g_u64HalClock;											/* Peripheral (re)scheduled */
+		if ( (HAL_IO16( C_HAL_ADDR_PEND) & HAL_IO16( C_HAL_ADDR_MASK)) != 0u )
+		{
+			HAL_CheckIrq();
+		}
+	}
+} /* End of HAL_Flush() */
+
+/* ****************************************************************************	*
+ * HAL_Hook()
+ *
+ * Common part of all memory access hooks.
+ * ****************************************************************************	*/
+static inline void HAL_Hook( void)
+{
+	HAL_Flush();
+	l_u64Accesses++;
+	g_u64HalClock += l_u16ClocksPerAccess;
+	if ( g_u64HalClock >= l_u64NextEvent )
+	{
+		HAL_Event();
+	}
+} /* End of HAL_Hook() */
+
+/* ****************************************************************************	*
+ * HAL_Event()
+ *
+ * Update peripherals up to the current clock, and dispatch interrupts.
+ * ****************************************************************************	*/
+static void HAL_Event( void)
+{
+	if ( g_u64HalClock >= l_u64EndClock )
+	{
+		HAL_Stop( "end of simulation");
+	}
+	l_u64NextEvent = HAL_PeriphUpdate();
+	if ( l_u64NextEvent > l_u64EndClock )
+	{
+		l_u64NextEvent = l_u64EndClock;
+	}
+	if ( (HAL_IO16( C_HAL_ADDR_PEND) & HAL_IO16( C_HAL_ADDR_MASK)) != 0u )
+	{
+		HAL_CheckIrq();
+	}
+} /* End of HAL_Event() */
+
+static inline uint16 HAL_IsIoPort( const void *pAddress)
+{
+	uintptr_t u = (uintptr_t) pAddress;
+	return ( (u >= C_HAL_IO_BEGIN) && (u < C_HAL_IO_END) );
+}
+
+static inline void HAL_VolatileRead( const void *pAddress)
+{
+	HAL_Hook();
+	if ( HAL_IsIoPort( pAddress) )
+	{
+		HAL_PeriphRead( (uint16) (uintptr_t) pAddress);
+	}
+}
+
+static inline void HAL_VolatileWrite( const void *pAddress, uint16 u16Size)
+{
+	HAL_Hook();
+	if ( HAL_IsIoPort( pAddress) )
+	{
+		l_u16PendingWrAddr = (uint16) (uintptr_t) pAddress;
+		l_u16PendingWrOld = (u16Size == 1u) ? HAL_IO8( pAddress) : HAL_IO16( pAddress);
+		l_u16PendingWrSize = u16Size;
+	}
+}
+
+/* ****************************************************************************	*
+ *	Instrumentation hooks (-fsanitize=thread)									*
+ * ****************************************************************************	*/
+void __tsan_init( void) { }
+void __tsan_func_entry( void *pCaller)
+{
+	(void) pCaller;
+	HAL_ProfEnter( (uintptr_t) __builtin_return_address( 0), l_u16Nesting);
+	HAL_Hook();
+}
+void __tsan_func_exit( void)
+{
+	HAL_Flush();
+	HAL_ProfLeave();
+}
+#define HAL_TSAN_ACCESS(n)																\
+void __tsan_read##n( void *p) { (void) p; HAL_Hook(); }									\
+void __tsan_write##n( void *p) { (void) p; HAL_Hook(); }								\
+void __tsan_unaligned_read##n( void *p) { (void) p; HAL_Hook(); }						\
+void __tsan_unaligned_write##n( void *p) { (void) p; HAL_Hook(); }						\
+void __tsan_volatile_read##n( void *p) { HAL_VolatileRead( p); }						\
+void __tsan_volatile_write##n( void *p) { HAL_VolatileWrite( p, (n)); }					\
+void __tsan_unaligned_volatile_read##n( void *p) { HAL_VolatileRead( p); }				\
+void __tsan_unaligned_volatile_write##n( void *p) { HAL_VolatileWrite( p, (n)); }
+HAL_TSAN_ACCESS(1)
+HAL_TSAN_ACCESS(2)
+HAL_TSAN_ACCESS(4)
+HAL_TSAN_ACCESS(8)
+HAL_TSAN_ACCESS(16)
+void __tsan_read_range( void *p, unsigned long n) { (void) p; HAL_Advance( (uint32) n); }
+void __tsan_write_range( void *p, unsigned long n) { (void) p; HAL_Advance( (uint32) n); }
+
+/* ****************************************************************************	*
+ *	Simulated CPU (syslib.h)													*
+ * ****************************************************************************	*/
+void HAL_SetPriority( uint16 u16Prio)
+{
+	HAL_Flush();
+	l_u16CpuStatus = (l_u16CpuStatus & ~C_HAL_M_PRIO_MASK) | (u16Prio & C_HAL_M_PRIO_MASK);
+	HAL_CheckIrq();
+} /* End of HAL_SetPriority() */
+
+uint16 HAL_GetCpuStatus( void)
+{
+	return ( l_u16CpuStatus );
+} /* End of HAL_GetCpuStatus() */
+
+void HAL_SetCpuStatus( uint16 u16Status)
+{
+	HAL_Flush();
+	l_u16CpuStatus = u16Status;
+	HAL_CheckIrq();
+} /* End of HAL_SetCpuStatus() */
+
+void HAL_PushPriority( uint16 u16Prio)
+{
+	if ( l_u16PrioStackIdx >= C_HAL_PRIO_STACK_DEPTH )
+	{
+		HAL_Stop( "STACK_IT (psup)");
+	}
+	l_au16PrioStack[l_u16PrioStackIdx++] = l_u16CpuStatus;
+	HAL_SetPriority( u16Prio);
+} /* End of HAL_PushPriority() */
+
+void HAL_PopPriority( void)
+{
+	if ( l_u16PrioStackIdx == 0u )
+	{
+		HAL_Stop( "STACK_IT (pop M)");
+	}
+	HAL_SetCpuStatus( l_au16PrioStack[--l_u16PrioStackIdx]);
+} /* End of HAL_PopPriority() */
+
+void HAL_EnterUserMode( void)
+{
+	l_u16CpuStatus |= C_HAL_M_USER_MODE;
+} /* End of HAL_EnterUserMode() */
+
+void HAL_EnterSystemMode( void)
+{
+	l_u16CpuStatus &= ~C_HAL_M_USER_MODE;
+} /* End of HAL_EnterSystemMode() */
+
+/* ****************************************************************************	*
+ * HAL_Advance()
+ *
+ * Advance the simulated clock by u32Clocks CPU-clocks, handling the
+ * peripheral events and interrupts in between.
+ * ****************************************************************************	*/
+void HAL_Advance( uint32 u32Clocks)
+{
+	uint64 u64Target;
+	HAL_Flush();
+	u64Target = g_u64HalClock + u32Clocks;
+	while ( g_u64HalClock < u64Target )
+	{
+		g_u64HalClock = (l_u64NextEvent < u64Target) ? l_u64NextEvent : u64Target;
+		if ( g_u64HalClock >= l_u64NextEvent )
+		{
+			HAL_Event();
+		}
+	}
+} /* End of HAL_Advance() */
+
+void HAL_Delay( uint32 u32Loops)
+{
+	HAL_Advance( 4u * u32Loops + 1u);											/* 4 clocks per loop */
+} /* End of HAL_Delay() */
+
+void HAL_LoopForever( void)
+{
+	for (;;)
+	{
+		HAL_Advance( C_HAL_CLOCKS_PER_US * 1000U);
+	}
+} /* End of HAL_LoopForever() */
+
+/* ****************************************************************************	*
+ * HAL_Halt()
+ *
+ * MLX16 HALT: Wait for an interrupt request; In case all interrupts are
+ * disabled, the chip enters sleep, which ends the simulation. A request
+ * which is pending but not accepted at the current CPU priority (HALT within
+ * an atomic section) ends the HALT too; It is dispatched when the priority
+ * is lowered.
+ * ****************************************************************************	*/
+void HAL_Halt( void)
+{
+	uint32 u32IrqTotal = l_u32IrqTotal;
+	HAL_Flush();
+	while ( (l_u32IrqTotal == u32IrqTotal) &&
+			((HAL_IO16( C_HAL_ADDR_PEND) & HAL_IO16( C_HAL_ADDR_MASK)) == 0u) )
+	{
+		if ( HAL_IO16( C_HAL_ADDR_MASK) == 0u )
+		{
+			HAL_Stop( "MLX16 halted (sleep)");
+		}
+		HAL_ProfSteal( l_u16Nesting, l_u64NextEvent - g_u64HalClock);
+		g_u64HalClock = l_u64NextEvent;
+		HAL_Event();
+	}
+} /* End of HAL_Halt() */
+
+/* ****************************************************************************	*
+ * HAL_SetPending()
+ *
+ * Set (first-level) interrupt request(s).
+ * ****************************************************************************	*/
+void HAL_SetPending( uint16 u16PendMask)
+{
+	HAL_IO16( C_HAL_ADDR_PEND) |= u16PendMask;
+} /* End of HAL_SetPending() */
+
+/* ****************************************************************************	*
+ * HAL_HostAddress()
+ *
+ * Convert a 16-bit application data address (e.g. ADC_SBASE/ADC_DBASE) into
+ * the host address. All application data (read-only data, data, bss and the
+ * application stack) is located within a 64kB window, starting at etext.
+ * ****************************************************************************	*/
+void *HAL_HostAddress( uint16 u16Address)
+{
+	uintptr_t uBase = (uintptr_t) etext;
+	return ( (void *) (uBase + (uint16) (u16Address - (uint16) uBase)) );
+} /* End of HAL_HostAddress() */
+
+/* ****************************************************************************	*
+ * HAL_Stop()
+ *
+ * End of simulation; Return to the host.
+ * ****************************************************************************	*/
+void HAL_Stop( const char *pszReason)
+{
+	l_pszStopReason = pszReason;
+	(void) swapcontext( &l_AppContext, &l_HostContext);
+	abort();
+} /* End of HAL_Stop() */
+
+/* Reset of the MLX16 (lib_mlx813xx.h) */
+void MLX16_RESET( void)
+{
+	HAL_Stop( "MLX16 reset");
+} /* End of MLX16_RESET() */
+
+static void HAL_AppEntry( void)
+{
+	(void) app_main();
+	HAL_Stop( "main() returned");
+}
+
+static void HAL_Usage( const char *pszName)
+{
+	fprintf( stderr,
+		"Usage: %s [-t ms] [-c clocks] [plant options]\n"
+		"  -t ms      Simulated time [ms] (default: %u)\n"
+		"  -c clocks  MLX16 clocks per memory access (default: %u)\n",
+		pszName, C_HAL_DEF_SIM_TIME, C_HAL_DEF_CLOCKS_PER_ACCESS);
+	HAL_PlantUsage();
+	HAL_ProfUsage();
+	exit( 2);
+}
+
+/* ****************************************************************************	*
+ * main()
+ *
+ * Host entry: Map the MLX16 address space, run the application for the
+ * simulated time and report.
+ * ****************************************************************************	*/
+int main( int argc, char *argv[])
+{
+	uint32 u32SimTime = C_HAL_DEF_SIM_TIME;
+	struct timespec tStart, tStop;
+	double dHostTime, dSimTime;
+	uint16 u16Idx;
+	int iOpt;
+	void *pMem;
+
+	while ( (iOpt = getopt( argc, argv, "t:c:L:R:p:e:H:V:m:CP:b:")) != -1 )
+	{
+		switch ( iOpt )
+		{
+		case 't':
+			u32SimTime = (uint32) strtoul( optarg, NULL, 0);
+			break;
+		case 'c':
+			l_u16ClocksPerAccess = (uint16) strtoul( optarg, NULL, 0);
+			break;
+		default:
+			if ( !HAL_PlantOption( iOpt, optarg) && !HAL_ProfOption( iOpt, optarg) )
+			{
+				HAL_Usage( argv[0]);
+			}
+		}
+	}
+
+	/* MLX16 address space: NVRAM, I/O-ports and Flash */
+	pMem = mmap( (void *) (uintptr_t) C_HAL_MEM_BASE, C_HAL_MEM_END - C_HAL_MEM_BASE, PROT_READ | PROT_WRITE,
+		MAP_FIXED_NOREPLACE | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if ( pMem != (void *) (uintptr_t) C_HAL_MEM_BASE )
+	{
+		fprintf( stderr, "Cannot map MLX16 address space at 0x%04X (check vm.mmap_min_addr <= %u)\n",
+			C_HAL_MEM_BASE, C_HAL_MEM_BASE);
+		return ( 1 );
+	}
+	if ( (uintptr_t) (end - etext) > 0x10000u )
+	{
+		fprintf( stderr, "Application data exceeds the 64kB data window (%lu bytes)\n",
+			(unsigned long) (end - etext));
+		return ( 1 );
+	}
+
+	HAL_PeriphInit();
+	HAL_ProfInit();
+	l_u64EndClock = (uint64) u32SimTime * (C_HAL_FCPU / 1000u);
+	l_u64NextEvent = 0u;
+
+	(void) getcontext( &l_AppContext);
+	l_AppContext.uc_stack.ss_sp = l_au8AppStack;
+	l_AppContext.uc_stack.ss_size = sizeof(l_au8AppStack);
+	l_AppContext.uc_link = &l_HostContext;
+	makecontext( &l_AppContext, HAL_AppEntry, 0);
+
+	clock_gettime( CLOCK_MONOTONIC, &tStart);
+	(void) swapcontext( &l_HostContext, &l_AppContext);
+	clock_gettime( CLOCK_MONOTONIC, &tStop);
+
+	dHostTime = (double) (tStop.tv_sec - tStart.tv_sec) + 1e-9 * (double) (tStop.tv_nsec - tStart.tv_nsec);
+	dSimTime = (double) g_u64HalClock / (double) C_HAL_FCPU;
+	printf( "Stop:         %s\n", l_pszStopReason);
+	printf( "Simulated:    %.3f s (%llu clocks @ %lu MHz, %llu accesses)\n", dSimTime,
+		(unsigned long long) g_u64HalClock, C_HAL_FCPU / 1000000UL, (unsigned long long) l_u64Accesses);
+	printf( "Host:         %.3f s (%.1f x real-time)\n", dHostTime, (dHostTime > 0.0) ? (dSimTime / dHostTime) : 0.0);
+	printf( "Interrupts:   (max. nesting %u)\n", l_u16MaxNesting);
+	for ( u16Idx = 0u; u16Idx < HAL_MAX_IRQ; u16Idx++ )
+	{
+		if ( l_au32IrqCount[u16Idx] != 0u )
+		{
+			printf( "  %-10s %10lu x, %6.2f%% CPU\n", l_aVectors[u16Idx].pszName, (unsigned long) l_au32IrqCount[u16Idx],
+				(g_u64HalClock != 0u) ? (100.0 * (double) l_au64IrqClocks[u16Idx] / (double) g_u64HalClock) : 0.0);
+		}
+	}
+	HAL_PeriphReport();
+	HAL_PlantReport();
+	return ( HAL_ProfReport() ? 0 : 3 );
+} /* End of main() */
+
+/* EOF */
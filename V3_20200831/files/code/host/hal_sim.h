@@ -0,0 +1,127 @@
+/*! \file		hal_sim.h
+ *  \brief		Host build: MLX81315 simulator internals
+ *
+ * \note		project MLX81315
+ *
+ * \author 		Marcel Braat
+ *
+ * \date 		2020-09-14
+ *
+ * \version 	1.0 - preliminary
+ *
+ *
+ * MELEXIS Microelectronic Integrated Systems
+ *
+ * Copyright (C) 2020-2020 Melexis N.V.
+ * The Software is being delivered 'AS IS' and Melexis, whether explicitly or
+ * implicitly, makes no warranty as to its Use or performance.
+ * The user accepts the Melexis Firmware License Agreement.
+ *
+ * Melexis confidential & proprietary
+ *
+ * ****************************************************************************	*/
+
+#ifndef HAL_SIM_H_
+#define HAL_SIM_H_
+
+#include "hal_host.h"
+#include "hal_cpu.h"
+
+/* MLX16 clock */
+#define C_HAL_FCPU					(250000UL * MCU_PLL_MULT)					/* 28 MHz */
+#define C_HAL_CLOCKS_PER_US			(C_HAL_FCPU / 1000000UL)
+
+/* Direct (non-instrumented) access to the simulated I/O-ports */
+#define HAL_IO16(addr)				(*(volatile uint16 *) (uintptr_t) (addr))
+#define HAL_IO8(addr)				(*(volatile uint8 *) (uintptr_t) (addr))
+
+/* Simulated I/O-port addresses (see <ioports.h>) */
+#define C_HAL_IO_BEGIN				0x2000U
+#define C_HAL_IO_END				0x2900U
+#define C_HAL_ADDR_CONTROL			0x2000U
+#define C_HAL_ADDR_PRIO				0x2004U
+#define C_HAL_ADDR_MASK				0x2006U
+#define C_HAL_ADDR_PEND				0x2008U
+#define C_HAL_ADDR_NV_CTRL			0x2024U
+#define C_HAL_ADDR_XI0_MASK			0x202AU
+#define C_HAL_ADDR_XI0_PEND			0x2034U										/* XIn_PEND = XI0_PEND + 2*n */
+#define C_HAL_ADDR_VARIOUS_L		0x2800U
+#define C_HAL_ADDR_TIMER			0x2806U
+#define C_HAL_ADDR_ADC_CTRL			0x2810U
+#define C_HAL_ADDR_ADC_SBASE		0x2812U
+#define C_HAL_ADDR_ADC_DBASE		0x2814U
+#define C_HAL_ADDR_TMR1_CTRL		0x282AU										/* TMRn_CTRL = TMR1_CTRL + 8*(n-1) */
+#define C_HAL_ADDR_PWM1_PSCL		0x284BU
+#define C_HAL_ADDR_PWM1_PER			0x284CU
+#define C_HAL_ADDR_PWM1_LT			0x284EU										/* PWMn_LT = PWM1_LT + 10*(n-1), PWMn_HT = PWMn_LT + 2 */
+#define C_HAL_ADDR_IO_CFG			0x28BEU
+#define C_HAL_ADDR_DRVCFG			0x28C6U
+#define C_HAL_ADDR_IO_IN			0x28CAU
+#define C_HAL_ADDR_ANA_OUTI			0x28D0U
+
+typedef enum
+{
+	HAL_IRQ_M4_SHE = 0,
+	HAL_IRQ_TIMER,
+	HAL_IRQ_ADC,
+	HAL_IRQ_EE,
+	HAL_IRQ_EXT0,
+	HAL_IRQ_EXT1,
+	HAL_IRQ_EXT2,
+	HAL_IRQ_EXT3,
+	HAL_IRQ_EXT4,
+	HAL_IRQ_SOFT,
+	HAL_MAX_IRQ
+} HAL_IRQ;
+
+/* ****************************************************************************	*
+ *	Simulator core (hal_sim.c)													*
+ * ****************************************************************************	*/
+extern uint64 g_u64HalClock;													/* Simulated MLX16 CPU-clocks */
+extern void HAL_Advance( uint32 u32Clocks);
+extern void HAL_Halt( void);
+extern void HAL_SetPending( uint16 u16PendMask);
+extern void *HAL_HostAddress( uint16 u16Address);
+extern void HAL_Stop( const char *pszReason) __attribute__((noreturn));
+
+/* ****************************************************************************	*
+ *	Peripherals (hal_periph.c)													*
+ * ****************************************************************************	*/
+extern void HAL_PeriphInit( void);
+extern void HAL_PeriphRead( uint16 u16Address);
+extern void HAL_PeriphWrite( uint16 u16Address, uint16 u16OldValue, uint16 u16Size);
+extern uint64 HAL_PeriphUpdate( void);
+extern void HAL_PeriphReport( void);
+extern void HAL_SetXiPending( uint16 u16Ext, uint16 u16Bits);
+extern void HAL_TimerCapture( uint16 u16Timer, uint16 u16Rising);
+
+/* ****************************************************************************	*
+ *	Plant-model (hal_plant.c)													*
+ * ****************************************************************************	*/
+extern void HAL_PlantInit( void);
+extern uint16 HAL_PlantOption( int iOpt, const char *pszArg);
+extern void HAL_PlantUsage( void);
+extern uint64 HAL_PlantUpdate( void);
+extern void HAL_PlantReport( void);
+/* ADC input (raw 10-bits result) of channel u16Channel, converted at hardware trigger u16Trigger */
+extern uint16 HAL_AdcChannel( uint16 u16Channel, uint16 u16Trigger);
+
+/* ****************************************************************************	*
+ *	Function profile and cycle budgets (hal_prof.c)								*
+ * ****************************************************************************	*/
+extern void HAL_ProfInit( void);
+extern void HAL_ProfEnter( uintptr_t uAddress, uint16 u16Level);
+extern void HAL_ProfLeave( void);
+extern void HAL_ProfSteal( uint16 u16Level, uint64 u64Clocks);
+extern uint16 HAL_ProfOption( int iOpt, const char *pszArg);
+extern void HAL_ProfUsage( void);
+extern uint16 HAL_ProfReport( void);
+
+/* ****************************************************************************	*
+ *	LIN-bus (hal_lib.c)															*
+ * ****************************************************************************	*/
+extern void HAL_LinReceive( uint8 u8MessageIndex, const uint8 *pu8Data);
+
+#endif /* HAL_SIM_H_ */
+
+/* EOF */
@@ -0,0 +1,9 @@
+/*! \file		Private_mathlib.h
+ *  \brief		Host build: case-sensitive file-system alias of "private_mathlib.h"
+ *
+ * The MLX16 tool-chain runs on a case-insensitive file-system.
+ * ****************************************************************************	*/
+
+#include "private_mathlib.h"
+
+/* EOF */
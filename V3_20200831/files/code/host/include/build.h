@@ -0,0 +1,9 @@
+/*! \file		build.h
+ *  \brief		Host build: case-sensitive file-system alias of "Build.h"
+ *
+ * The MLX16 tool-chain runs on a case-insensitive file-system.
+ * ****************************************************************************	*/
+
+#include "Build.h"
+
+/* EOF */
@@ -0,0 +1,56 @@
+/*! \file		hal_cpu.h
+ *  \brief		Host build: simulated MLX16 CPU and register file
+ *
+ * \note		project MLX81315
+ *
+ * \author 		Marcel Braat
+ *
+ * \date 		2020-09-14
+ *
+ * \version 	1.0 - preliminary
+ *
+ * The I/O-ports of <ioports.h> are resolved at their native MLX16 addresses
+ * (ioports.ld), on top of a host memory mapping of the MLX16 address space
+ * (NVRAM, I/O, Flash). Each (volatile) memory access of the application is
+ * reported to the simulator (-fsanitize=thread instrumentation), which
+ * advances the simulated clock, updates the peripherals and dispatches the
+ * pending interrupts at their MLX16 priority.
+ *
+ * MELEXIS Microelectronic Integrated Systems
+ *
+ * Copyright (C) 2020-2020 Melexis N.V.
+ * The Software is being delivered 'AS IS' and Melexis, whether explicitly or
+ * implicitly, makes no warranty as to its Use or performance.
+ * The user accepts the Melexis Firmware License Agreement.
+ *
+ * Melexis confidential & proprietary
+ *
+ * ****************************************************************************	*/
+
+#ifndef HAL_CPU_H_
+#define HAL_CPU_H_
+
+/* MLX16 address space mapped on the host */
+#define C_HAL_MEM_BASE				0x1000U										/* NVRAM, I/O-ports and Flash */
+#define C_HAL_MEM_END				0x10000UL
+
+/* CPU status (M-register) emulation */
+#define C_HAL_M_PRIO_MASK			0x0007U										/* Priority [2:0] */
+#define C_HAL_M_USER_MODE			0x0008U										/* User-mode */
+
+/* ****************************************************************************	*
+ *	P u b l i c   f u n c t i o n s   (simulated CPU)							*
+ * ****************************************************************************	*/
+extern void HAL_SetPriority( uint16 u16Prio);
+extern uint16 HAL_GetCpuStatus( void);
+extern void HAL_SetCpuStatus( uint16 u16Status);
+extern void HAL_PushPriority( uint16 u16Prio);
+extern void HAL_PopPriority( void);
+extern void HAL_EnterUserMode( void);
+extern void HAL_EnterSystemMode( void);
+extern void HAL_Delay( uint32 u32Loops);
+extern void HAL_LoopForever( void) __attribute__((noreturn));
+
+#endif /* HAL_CPU_H_ */
+
+/* EOF */
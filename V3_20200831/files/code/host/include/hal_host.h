@@ -0,0 +1,51 @@
+/*! \file		hal_host.h
+ *  \brief		Host (x86-64) build: MLX16 compiler/type abstraction
+ *
+ * \note		project MLX81315
+ *
+ * \author 		Marcel Braat
+ *
+ * \date 		2020-09-14
+ *
+ * \version 	1.0 - preliminary
+ *
+ * Forced-include (-include) header of the host build; Included before any
+ * application or platform header. It replaces the MLX16-GCC type-library
+ * (int = 16-bits, long = 32-bits) by fixed-size host types, and provides the
+ * MLX16-GCC specific pre-defines.
+ *
+ * MELEXIS Microelectronic Integrated Systems
+ *
+ * Copyright (C) 2020-2020 Melexis N.V.
+ * The Software is being delivered 'AS IS' and Melexis, whether explicitly or
+ * implicitly, makes no warranty as to its Use or performance.
+ * The user accepts the Melexis Firmware License Agreement.
+ *
+ * Melexis confidential & proprietary
+ *
+ * ****************************************************************************	*/
+
+#ifndef HAL_HOST_H_
+#define HAL_HOST_H_
+
+#include <stdint.h>
+
+/* MLX16-GCC release emulated by the host build */
+#define __MLX16_GCC_MAJOR__			1
+#define __MLX16_GCC_MINOR__			8
+
+/* Replacement of <typelib.h>: MLX16 int is 16-bits, long is 32-bits */
+#define TYPELIB_H_
+#define __MLX16_STDINT_H__
+typedef uint8_t			uint8;
+typedef int8_t			int8;
+typedef uint16_t		uint16;
+typedef int16_t			int16;
+typedef uint32_t		uint32;
+typedef int32_t			int32;
+typedef uint64_t		uint64;
+typedef int64_t			int64;
+
+#endif /* HAL_HOST_H_ */
+
+/* EOF */
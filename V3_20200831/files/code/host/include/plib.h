@@ -0,0 +1,63 @@
+/*! \file		plib.h
+ *  \brief		Host build: replacement of the platform <plib.h>
+ *
+ * \note		project MLX81315
+ *
+ * \author 		Marcel Braat
+ *
+ * \date 		2020-09-14
+ *
+ * \version 	1.0 - preliminary
+ *
+ * Same as mulan2_platform/products/81315/include/plib.h; The MLX16 inline
+ * assembly nvram_CalcCRC() is replaced by a C implementation.
+ *
+ * MELEXIS Microelectronic Integrated Systems
+ *
+ * Copyright (C) 2020-2020 Melexis N.V.
+ * The Software is being delivered 'AS IS' and Melexis, whether explicitly or
+ * implicitly, makes no warranty as to its Use or performance.
+ * The user accepts the Melexis Firmware License Agreement.
+ *
+ * Melexis confidential & proprietary
+ *
+ * ****************************************************************************	*/
+
+#ifndef PLIB_H_
+#define PLIB_H_
+
+#include <stdbool.h>
+#include "ioports.h"
+#include "lib_mlx813xx.h"
+#include "lib_mlx813xx_bist.h"
+#define nvram_CalcCRC	nvram_CalcCRC_MLX16										/* MLX16 assembly version is not used */
+#include "lib_mlx813xx_patch.h"
+#include "lib_mlx813xx_wdg.h"
+#include "mlx_eep_map.h"
+#undef nvram_CalcCRC
+
+/* nvram_CalcCRC()
+ * const uint16_t *pu16BeginAddress: Start-address (16-bit aligned)
+ * const uint16_t u16Length: Length (in 16-bit words)
+ *
+ * returns a 8-bit (extended to 16-bit) CRC (Sum with carry) calculation over the specified area.
+ */
+static __inline__ uint16 nvram_CalcCRC( const uint16_t *pu16BeginAddress, const uint16_t u16Length)
+{
+	uint32 u32Sum = 0u;
+	uint16 u16Count = u16Length;
+	uint16 u16CRC;
+
+	do
+	{
+		u32Sum += *pu16BeginAddress++;											/* adc A, [Y++] */
+		u32Sum = (u32Sum & 0xFFFFu) + (u32Sum >> 16);
+	} while ( --u16Count != 0u );												/* djnz X */
+	u16CRC = (uint16) ((u32Sum & 0xFFu) + (u32Sum >> 8));						/* adc AL, AH */
+	u16CRC = (u16CRC & 0xFFu) + (u16CRC >> 8);									/* adc AL, #0 */
+	return ( (uint16) (u16CRC & 0xFFu) );
+} /* End of nvram_CalcCRC() */
+
+extern bool mlx_isPowerOk (void);      /*lint !e19 */
+
+#endif /* PLIB_H_ */
@@ -0,0 +1,219 @@
+/*! \file		syslib.h
+ *  \brief		Host build: replacement of the platform <syslib.h>
+ *
+ * \note		project MLX81315
+ *
+ * \author 		Marcel Braat
+ *
+ * \date 		2020-09-14
+ *
+ * \version 	1.0 - preliminary
+ *
+ * Same API as mulan2_platform/include/syslib.h; The MLX16 inline assembly
+ * (priority, CPU status, delays) is replaced by calls to the simulated CPU.
+ *
+ * MELEXIS Microelectronic Integrated Systems
+ *
+ * Copyright (C) 2020-2020 Melexis N.V.
+ * The Software is being delivered 'AS IS' and Melexis, whether explicitly or
+ * implicitly, makes no warranty as to its Use or performance.
+ * The user accepts the Melexis Firmware License Agreement.
+ *
+ * Melexis confidential & proprietary
+ *
+ * ****************************************************************************	*/
+
+#ifndef SYSLIB_H_
+#define SYSLIB_H_
+
+#include "typelib.h"
+#include <ioports.h>
+#include <mlx16_cfg.h>
+#include <static_assert.h>
+#include "hal_cpu.h"
+
+/* Abstraction for inlining */
+#define INLINE  __attribute__((always_inline)) inline
+
+/* define function as interrupt handler (dispatched by the simulated interrupt controller) */
+#define __interrupt__
+
+/* place variable in direct page */
+#define __DPAGE__
+
+/* do not place variable in direct page */
+#define __NODPAGE__
+
+/* section in the first half of the flash */
+#define __MLX_TEXT__
+
+/* ---------------------------------------------------------------------------
+ * Bit manipulations
+ */
+/* Bit value */
+#define _BV(bit)    (1u << (bit))
+
+/*
+ * Find first set bit (starting from msbit)
+ * fsb(0) = 0
+ * fsb(1) = 0
+ * fsb(0xffff) = 15
+ */
+static __inline__ int16  __fsb(uint16 v)
+{
+    int16 first_bit = 15;
+
+    if ( v == 0u )
+    {
+        return 0;
+    }
+    while ( (v & 0x8000u) == 0u )
+    {
+        v = (uint16) (v << 1);
+        first_bit--;
+    }
+    return (first_bit);
+}
+
+
+/* ----------------------------------------------------------------------------
+ * Blocking delays (4 clocks per loop)
+ */
+#define DELAY(loops)            HAL_Delay( (uint32) (loops))
+
+/*-----------------------------------------------------------------------------
+ * Delays for 'us' microseconds
+ */
+#define DELAY_US(us)    DELAY((FPLL * (uint32)(us) + 2000) / 4000)
+
+/*
+ * Blocking delay for 'msec' milliseconds
+ */
+static INLINE void MSEC_DELAY(int16 msec)
+{
+    int16 i;
+    for(i = 0; i < msec; i++)
+    {
+        DELAY(FPLL/4);
+    }
+}
+
+#define LOOP_FOREVER()  HAL_LoopForever()
+
+
+/* ----------------------------------------------------------------------------
+ * MLX16 helper functions
+ */
+#define SET_STACK(stack)        do { (void) (stack); } while(0)
+
+#define SET_PRIORITY(prio)      HAL_SetPriority( (uint16) (prio))
+
+#define ENTER_USER_MODE()       HAL_EnterUserMode()
+
+/*
+ * Switch to system mode keeping Priority register value
+ */
+#define ENTER_SYSTEM_MODE_KEEP_PRIO() HAL_EnterSystemMode()
+
+/*
+ * Switch to system mode with zeroing of Priority register value
+ */
+#define ENTER_SYSTEM_MODE_PRIO_0()                                      \
+do {                                                                    \
+    ENTER_SYSTEM_MODE_KEEP_PRIO();                                      \
+    SET_PRIORITY(0);                                                    \
+} while(0)
+
+/* Deprecated; use ENTER_SYSTEM_MODE_PRIO_0 or ENTER_SYSTEM_MODE_KEEP_PRIO instead */
+#define ENTER_SYSTEM_MODE() ENTER_SYSTEM_MODE_PRIO_0()
+
+#define NOP()               HAL_Delay( 0u)  /* no operation */
+
+
+#define MLX16_MASK_ALL_INT()    \
+    do {                        \
+        MASK = 0;               \
+    } while (0)
+
+#define MLX16_HALT()            \
+        do {                    \
+            CONTROL |= HALT;    \
+            NOP();              \
+        } while (0)
+
+/*
+ *
+ */
+extern void MLX16_RESET (void);  /* MLX16 reset is core/project specific */
+
+/*
+ * Return M register value
+ */
+static INLINE uint16 SYS_getCpuStatus (void)
+{
+    return HAL_GetCpuStatus();
+}
+
+/*
+ * Set M register value
+ */
+static INLINE void SYS_setCpuStatus (uint16 status)
+{
+    HAL_SetCpuStatus( status);
+}
+
+/*
+ * Clears M register
+ */
+static INLINE void SYS_clearCpuStatus (void)
+{
+    HAL_SetCpuStatus( 0u);
+}
+
+
+/* ----------------------------------------------------------------------------
+ * ATOMIC_CODE
+ * Wrapper to get atomic code execution block
+ */
+static INLINE void __statusCleanup (const  uint16 *p)
+{
+    SYS_setCpuStatus(*p);
+}
+
+#define ATOMIC_CODE(__code__)                                           \
+do  {                                                                   \
+    uint16 _mreg_saved __attribute__((cleanup(__statusCleanup)));       \
+                                                                        \
+    _mreg_saved = SYS_getCpuStatus();                                   \
+    ENTER_SYSTEM_MODE_PRIO_0();                                         \
+    __code__                                                            \
+} while (0)
+
+/*
+ * Execute code in system mode keeping Priority register value
+ */
+#define SYSTEM_CODE(__code__)                                           \
+do  {                                                                   \
+    uint16 _mreg_saved __attribute__((cleanup(__statusCleanup)));       \
+                                                                        \
+    _mreg_saved = SYS_getCpuStatus();                                   \
+    ENTER_SYSTEM_MODE_KEEP_PRIO();                                      \
+    __code__                                                            \
+} while (0)
+
+
+/* ----------------------------------------------------------------------------
+ * MLX4 helper functions
+ */
+#define MLX4_RESET()        (CONTROL &= ~M4_RB)
+#define MLX4_START()        (CONTROL |=  M4_RB)
+
+#define ENABLE_MLX4_INT()   (MASK |=  EN_M4_SHE_IT)
+#define DISABLE_MLX4_INT()  (MASK &= ~EN_M4_SHE_IT)
+
+#define CLEAR_MLX4_INT()    (PEND = CLR_M4_SHE_IT)
+
+#define GET_STATUS_MLX4_INT()   (MASK & EN_M4_SHE_IT)
+
+
+#endif /* SYSLIB_H_ */
@@ -0,0 +1,989 @@
+/*! ----------------------------------------------------------------------------
+ * \file		lss_wcet.c
+ * \brief		Host tool: Static worst-case execution time and stack-depth
+ *				analysis of the MLX16 interrupt handlers
+ *
+ * \note		project MLX81315
+ *
+ * \author 		Marcel Braat
+ *
+ * \date 		2020-09-28
+ *
+ * \version 	1.0 - preliminary
+ *
+ * \functions	main()
+ *
+ * Usage: lss_wcet [options] <project>.lss <project>.map vectors-lin.S
+ *
+ * Input:
+ * - <project>.lss: Disassembly (objdump -d -S) of the MLX16 application;
+ * - <project>.map: Symbol addresses and the RAM memory region (stack);
+ * - vectors-lin.S: The interrupt handlers (CALLVECTOR), their absolute ISR
+ *   priority (psup) and the interrupt level (comment: "(level)" or level).
+ *
+ * Per function, the control-flow graph is build from the listing; The WCET
+ * is the longest path, including the callees (call, callf, tail-jumps). Loops
+ * (back-edges) are repeated with their bound: "lod Cx/X, #n" before a djnz
+ * loop, otherwise the default loop-bound (-l) or the annotated bound
+ * (-L function=n). The stack-depth follows push/pop, inc/dec S and the
+ * return address of the calls.
+ *
+ * Per ISR the worst-case path is reported. Under the interrupt priorities,
+ * an ISR j preempts ISR i when level(j) <= psup(i); The worst-case response
+ * of ISR i is: blocking (longest ISR which i can't preempt) + WCET(i) + all
+ * ISR's which preempt i. The worst-case stack is the deepest main-loop stack
+ * plus the deepest chain of nested ISR's, and is checked against the stack
+ * area (_stack .. end of RAM) that is monitored by STACK_IT.
+ *
+ * Exit code 0: All ISR's within the period (-T) and no stack overflow; 1:
+ * Budget exceeded; 2: Input error; 3: Listing doesn't match the sources (a
+ * handler of vectors-lin.S is not in the listing), budgets not checked.
+ *
+ * NOTE: The instruction cycles are an estimate (l_aCost, -m mnemonic=cycles);
+ * Indirect jumps/calls are not followed and reported.
+ *
+ * MELEXIS Microelectronic Integrated Systems
+ *
+ * Copyright (C) 2020-2020 Melexis N.V.
+ * The Software is being delivered 'AS IS' and Melexis, whether explicitly or
+ * implicitly, makes no warranty as to its Use or performance.
+ * The user accepts the Melexis Firmware License Agreement.
+ *
+ * Melexis confidential & proprietary
+ * ****************************************************************************	*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <ctype.h>
+#include <unistd.h>
+
+#define C_WCET_MAX_INSN				24576U
+#define C_WCET_MAX_FUNC				1024U
+#define C_WCET_MAX_SYM				2048U
+#define C_WCET_MAX_VECTOR			32U
+#define C_WCET_MAX_ANNOT			64U
+#define C_WCET_DEF_PERIOD			1400U										/* One PWM period: 28MHz / 20kHz */
+#define C_WCET_DEF_LOOP				1U
+#define C_WCET_CALL_STACK			2										/* call: PC */
+#define C_WCET_CALLF_STACK			4										/* callf: PC and M */
+#define C_WCET_IRQ_STACK			4										/* Interrupt: PC and M */
+#define C_WCET_NO_TARGET			0xFFFFFFFFU
+
+/* Function state */
+#define C_FUNC_TODO					0U
+#define C_FUNC_BUSY					1U
+#define C_FUNC_DONE					2U
+
+/* Function flags */
+#define C_FLAG_INDIRECT				0x01U										/* Indirect jump or call */
+#define C_FLAG_RECURSION			0x02U
+#define C_FLAG_LOOP					0x04U										/* Loop with default bound */
+#define C_FLAG_EXTERNAL				0x08U										/* Call outside the listing */
+
+typedef struct _WCET_INSN
+{
+	uint32_t u32Addr;
+	uint16_t u16Words;
+	char szMnem[8];
+	char szOps[40];
+	uint32_t u32Target;															/* Jump/call target address */
+} WCET_INSN;
+
+typedef struct _WCET_FUNC
+{
+	char szName[48];
+	uint32_t u32Addr;
+	uint32_t u32First;															/* First instruction */
+	uint32_t u32Count;
+	uint16_t u16State;
+	uint16_t u16Flags;
+	uint16_t u16SubFlags;														/* Flags of the callees */
+	uint64_t u64Wcet;															/* Including callees */
+	int32_t i32Stack;															/* Including callees */
+	int32_t i32Critical;														/* Callee with the largest contribution on the worst path */
+} WCET_FUNC;
+
+typedef struct _WCET_SYM
+{
+	char szName[48];
+	uint32_t u32Addr;
+} WCET_SYM;
+
+typedef struct _WCET_VECTOR
+{
+	char szName[24];															/* Vector name, e.g. EXT0_IT */
+	char szHandler[48];
+	uint16_t u16Psup;															/* Absolute priority of the ISR */
+	uint16_t u16Level;															/* Interrupt level */
+	int32_t i32Func;
+	uint64_t u64Response;
+	int32_t i32Chain;															/* Stack of the deepest nesting, starting with this ISR */
+} WCET_VECTOR;
+
+typedef struct _WCET_ANNOT
+{
+	char szName[48];
+	uint32_t u32Value;
+} WCET_ANNOT;
+
+typedef struct _WCET_COST
+{
+	const char *pszMnem;
+	uint16_t u16Cycles;															/* In addition to the instruction words */
+} WCET_COST;
+
+/* Estimated additional cycles per instruction (not from the MLX16 datasheet) */
+static WCET_COST l_aCost[] =
+{
+	{ "call",  2u }, { "callf", 3u }, { "ret",   3u }, { "reti",  3u },
+	{ "jmp",   1u }, { "jmpf",  2u }, { "djnz",  1u },
+	{ "divu", 16u }, { "divs", 16u }, { "mulu",  2u }, { "muls",  2u }, { "macu",  3u },
+	{ "movsw", 2u }, { "push",  1u }, { "pushw", 1u }, { "pop",   1u },
+	{ NULL,    0u }
+};
+
+static WCET_INSN *l_aInsn;
+static uint32_t l_u32Insns = 0u;
+static WCET_FUNC l_aFunc[C_WCET_MAX_FUNC];
+static uint32_t l_u32Funcs = 0u;
+static WCET_SYM l_aSym[C_WCET_MAX_SYM];
+static uint32_t l_u32Syms = 0u;
+static WCET_VECTOR l_aVector[C_WCET_MAX_VECTOR];
+static uint32_t l_u32Vectors = 0u;
+static WCET_ANNOT l_aLoop[C_WCET_MAX_ANNOT];
+static uint32_t l_u32Loops = 0u;
+static WCET_ANNOT l_aLevel[C_WCET_MAX_ANNOT];
+static uint32_t l_u32Levels = 0u;
+static uint32_t l_u32DefLoop = C_WCET_DEF_LOOP;
+static uint32_t l_u32Period = C_WCET_DEF_PERIOD;
+static uint32_t l_u32RamEnd = 0u;
+static uint32_t l_u32StackBegin = 0u;
+static const char *l_pszMain = "main";
+
+/* ****************************************************************************	*
+ *	Helpers																		*
+ * ****************************************************************************	*/
+static const char *WCET_StripName( const char *pszName)
+{
+	return ( (pszName[0] == '_') ? (pszName + 1) : pszName );
+}
+
+static int32_t WCET_FindFunc( const char *pszName)
+{
+	uint32_t u32Idx;
+	for ( u32Idx = 0u; u32Idx < l_u32Funcs; u32Idx++ )
+	{
+		if ( strcmp( WCET_StripName( l_aFunc[u32Idx].szName), pszName) == 0 )
+		{
+			return ( (int32_t) u32Idx );
+		}
+	}
+	return ( -1 );
+}
+
+static int32_t WCET_FuncAt( uint32_t u32Addr)
+{
+	uint32_t u32Idx;
+	for ( u32Idx = 0u; u32Idx < l_u32Funcs; u32Idx++ )
+	{
+		if ( l_aFunc[u32Idx].u32Addr == u32Addr )
+		{
+			return ( (int32_t) u32Idx );
+		}
+	}
+	return ( -1 );
+}
+
+static uint32_t WCET_Annotation( const WCET_ANNOT *pAnnot, uint32_t u32Annots, const char *pszName, uint32_t u32Default)
+{
+	uint32_t u32Idx;
+	for ( u32Idx = 0u; u32Idx < u32Annots; u32Idx++ )
+	{
+		if ( strcmp( pAnnot[u32Idx].szName, WCET_StripName( pszName)) == 0 )
+		{
+			return ( pAnnot[u32Idx].u32Value );
+		}
+	}
+	return ( u32Default );
+}
+
+static int WCET_AddAnnotation( WCET_ANNOT *pAnnot, uint32_t *pu32Annots, const char *pszArg)
+{
+	const char *pszValue = strchr( pszArg, '=');
+	size_t uLen;
+	if ( (pszValue == NULL) || (*pu32Annots >= C_WCET_MAX_ANNOT) )
+	{
+		return ( 0 );
+	}
+	uLen = (size_t) (pszValue - pszArg);
+	if ( uLen >= sizeof(pAnnot->szName) )
+	{
+		return ( 0 );
+	}
+	memcpy( pAnnot[*pu32Annots].szName, pszArg, uLen);
+	pAnnot[*pu32Annots].szName[uLen] = '\0';
+	pAnnot[*pu32Annots].u32Value = (uint32_t) strtoul( pszValue + 1, NULL, 0);
+	(*pu32Annots)++;
+	return ( 1 );
+}
+
+static int WCET_IsCondJump( const WCET_INSN *pInsn)
+{
+	return ( ((pInsn->szMnem[0] == 'j') && (strcmp( pInsn->szMnem, "jmp") != 0) && (strcmp( pInsn->szMnem, "jmpf") != 0)) ||
+			 (strcmp( pInsn->szMnem, "djnz") == 0) );
+}
+
+static int WCET_IsJump( const WCET_INSN *pInsn)
+{
+	return ( (strcmp( pInsn->szMnem, "jmp") == 0) || (strcmp( pInsn->szMnem, "jmpf") == 0) );
+}
+
+static int WCET_IsCall( const WCET_INSN *pInsn)
+{
+	return ( (strcmp( pInsn->szMnem, "call") == 0) || (strcmp( pInsn->szMnem, "callf") == 0) );
+}
+
+static int WCET_IsReturn( const WCET_INSN *pInsn)
+{
+	return ( strncmp( pInsn->szMnem, "ret", 3) == 0 );
+}
+
+static uint64_t WCET_Cycles( const WCET_INSN *pInsn)
+{
+	uint64_t u64Cycles = pInsn->u16Words;
+	const WCET_COST *pCost;
+	for ( pCost = l_aCost; pCost->pszMnem != NULL; pCost++ )
+	{
+		if ( strcmp( pCost->pszMnem, pInsn->szMnem) == 0 )
+		{
+			return ( u64Cycles + pCost->u16Cycles );
+		}
+	}
+	if ( WCET_IsCondJump( pInsn) )
+	{
+		u64Cycles++;															/* Taken */
+	}
+	else if ( (strchr( pInsn->szOps, '[') != NULL) || (strstr( pInsn->szOps, "dp:") != NULL) ||
+			  (strstr( pInsn->szOps, "io:") != NULL) || (strstr( pInsn->szOps, "ep:") != NULL) ||
+			  (strstr( pInsn->szOps, "0x") != NULL) )
+	{
+		u64Cycles++;															/* Data memory access */
+	}
+	return ( u64Cycles );
+}
+
+/* Stack effect [bytes] of an instruction (excluding calls) */
+static int32_t WCET_StackEffect( const WCET_INSN *pInsn)
+{
+	int32_t i32Size = ((strncmp( pInsn->szOps, "D", 1) == 0) && (pInsn->szOps[1] != 'L') && (pInsn->szOps[1] != 'H')) ||
+					  (strncmp( pInsn->szOps, "YA", 2) == 0) ? 4 : 2;
+	if ( (strcmp( pInsn->szMnem, "push") == 0) || (strcmp( pInsn->szMnem, "pushw") == 0) )
+	{
+		return ( (strcmp( pInsn->szMnem, "pushw") == 0) ? 2 : i32Size );
+	}
+	if ( strcmp( pInsn->szMnem, "pop") == 0 )
+	{
+		return ( -i32Size );
+	}
+	if ( (strncmp( pInsn->szOps, "S, #", 4) == 0) &&
+		 ((strcmp( pInsn->szMnem, "inc") == 0) || (strcmp( pInsn->szMnem, "dec") == 0)) )
+	{
+		int32_t i32Value = (int32_t) strtol( pInsn->szOps + 4, NULL, 0);
+		return ( (pInsn->szMnem[0] == 'i') ? i32Value : -i32Value );
+	}
+	return ( 0 );
+}
+
+/* ****************************************************************************	*
+ *	Input																		*
+ * ****************************************************************************	*/
+static int WCET_ReadListing( const char *pszFile)
+{
+	static const char * const apszSections[] = { ".text", ".ramfunc", ".system_services", NULL };
+	char szLine[512];
+	int iCode = 0;
+	FILE *pFile = fopen( pszFile, "r");
+
+	if ( pFile == NULL )
+	{
+		perror( pszFile);
+		return ( 0 );
+	}
+	while ( fgets( szLine, sizeof(szLine), pFile) != NULL )
+	{
+		unsigned int uAddr;
+		char szName[48];
+
+		if ( strncmp( szLine, "Disassembly of section ", 23) == 0 )
+		{
+			uint16_t u16Idx;
+			iCode = 0;
+			for ( u16Idx = 0u; apszSections[u16Idx] != NULL; u16Idx++ )
+			{
+				size_t uLen = strlen( apszSections[u16Idx]);
+				if ( (strncmp( szLine + 23, apszSections[u16Idx], uLen) == 0) && (szLine[23 + uLen] == ':') )
+				{
+					iCode = 1;
+				}
+			}
+			continue;
+		}
+		if ( !iCode )
+		{
+			continue;
+		}
+		if ( (sscanf( szLine, "%x <%47[^>]>:", &uAddr, szName) == 2) && isxdigit( (unsigned char) szLine[0]) )
+		{
+			WCET_FUNC *pFunc;
+			if ( l_u32Funcs >= C_WCET_MAX_FUNC )
+			{
+				fprintf( stderr, "Too many functions\n");
+				break;
+			}
+			pFunc = &l_aFunc[l_u32Funcs++];
+			memset( pFunc, 0, sizeof(*pFunc));
+			snprintf( pFunc->szName, sizeof(pFunc->szName), "%s", szName);
+			pFunc->u32Addr = uAddr;
+			pFunc->u32First = l_u32Insns;
+			pFunc->i32Critical = -1;
+			continue;
+		}
+		if ( (szLine[0] == ' ') && (sscanf( szLine, " %x:\t", &uAddr) == 1) && (strchr( szLine, '\t') != NULL) && (l_u32Funcs != 0u) )
+		{
+			char *pszField = strchr( szLine, '\t') + 1;								/* Opcode words */
+			char *pszMnem = strchr( pszField, '\t');
+			WCET_INSN *pInsn;
+			char *psz;
+			if ( l_u32Insns >= C_WCET_MAX_INSN )
+			{
+				fprintf( stderr, "Too many instructions\n");
+				break;
+			}
+			pInsn = &l_aInsn[l_u32Insns];
+			memset( pInsn, 0, sizeof(*pInsn));
+			pInsn->u32Addr = uAddr;
+			pInsn->u32Target = C_WCET_NO_TARGET;
+			for ( psz = pszField; (psz != pszMnem) && (*psz != '\0') && (*psz != '\n'); psz++ )
+			{
+				if ( isxdigit( (unsigned char) psz[0]) && ((psz == pszField) || (psz[-1] == ' ')) )
+				{
+					pInsn->u16Words++;
+				}
+			}
+			if ( pszMnem != NULL )
+			{
+				char *pszOps = strchr( pszMnem + 1, '\t');
+				size_t uLen = (pszOps != NULL) ? (size_t) (pszOps - (pszMnem + 1)) : strcspn( pszMnem + 1, "\n");
+				if ( uLen >= sizeof(pInsn->szMnem) )
+				{
+					uLen = sizeof(pInsn->szMnem) - 1u;
+				}
+				memcpy( pInsn->szMnem, pszMnem + 1, uLen);
+				if ( pszOps != NULL )
+				{
+					snprintf( pInsn->szOps, sizeof(pInsn->szOps), "%s", pszOps + 1);
+					pInsn->szOps[strcspn( pInsn->szOps, "\n<")] = '\0';
+				}
+			}
+			if ( WCET_IsCall( pInsn) || WCET_IsJump( pInsn) || WCET_IsCondJump( pInsn) )
+			{
+				const char *pszTarget = strstr( pInsn->szOps, "0x");
+				if ( (pszTarget != NULL) && ((pszTarget == pInsn->szOps) || (pszTarget[-1] == ' ')) )
+				{
+					pInsn->u32Target = (uint32_t) strtoul( pszTarget, NULL, 16);
+				}
+			}
+			l_aFunc[l_u32Funcs - 1u].u32Count++;
+			l_u32Insns++;
+		}
+	}
+	fclose( pFile);
+	return ( l_u32Insns != 0u );
+}
+
+static int WCET_ReadMap( const char *pszFile)
+{
+	char szLine[512];
+	FILE *pFile = fopen( pszFile, "r");
+
+	if ( pFile == NULL )
+	{
+		perror( pszFile);
+		return ( 0 );
+	}
+	while ( fgets( szLine, sizeof(szLine), pFile) != NULL )
+	{
+		unsigned long ulAddr, ulLength;
+		char szName[48], szExtra[64];
+		int iFields = sscanf( szLine, " 0x%lx %47s %63s", &ulAddr, szName, szExtra);
+		if ( (iFields == 2) && (szName[0] == '_') && (l_u32Syms < C_WCET_MAX_SYM) )
+		{
+			snprintf( l_aSym[l_u32Syms].szName, sizeof(l_aSym[0].szName), "%s", szName);
+			l_aSym[l_u32Syms].u32Addr = (uint32_t) ulAddr;
+			l_u32Syms++;
+		}
+		else if ( (iFields == 3) && (strcmp( szName, "PROVIDE") == 0) && (strncmp( szExtra, "(_stack,", 8) == 0) )
+		{
+			l_u32StackBegin = (uint32_t) ulAddr;
+		}
+		else if ( (sscanf( szLine, "ram 0x%lx 0x%lx", &ulAddr, &ulLength) == 2) )
+		{
+			l_u32RamEnd = (uint32_t) (ulAddr + ulLength);
+		}
+	}
+	fclose( pFile);
+	return ( 1 );
+}
+
+static int WCET_ReadVectors( const char *pszFile)
+{
+	char szLine[512];
+	FILE *pFile = fopen( pszFile, "r");
+
+	if ( pFile == NULL )
+	{
+		perror( pszFile);
+		return ( 0 );
+	}
+	while ( fgets( szLine, sizeof(szLine), pFile) != NULL )
+	{
+		char szHandler[48];
+		unsigned int uOffset, uPsup;
+		char *pszComment;
+		WCET_VECTOR *pVector;
+		if ( (sscanf( szLine, " CALLVECTOR ( %x , %47[A-Za-z0-9_] , %u )", &uOffset, szHandler, &uPsup) != 3) ||
+			 (l_u32Vectors >= C_WCET_MAX_VECTOR) )
+		{
+			continue;
+		}
+		pVector = &l_aVector[l_u32Vectors++];
+		memset( pVector, 0, sizeof(*pVector));
+		snprintf( pVector->szHandler, sizeof(pVector->szHandler), "%s", szHandler);
+		snprintf( pVector->szName, sizeof(pVector->szName), "%.23s", szHandler);
+		pVector->u16Psup = (uint16_t) uPsup;
+		pVector->u16Level = 7u;
+		pszComment = strchr( szLine, ';');
+		if ( pszComment != NULL )
+		{
+			/* "; 3-6 (4)   EXT0_IT ..." or "; 5      M4_SHE_IT ..." */
+			char *psz = pszComment + 1;
+			char szName[24];
+			pVector->u16Level = (uint16_t) strtoul( psz, NULL, 10);
+			while ( isspace( (unsigned char) *psz) || isdigit( (unsigned char) *psz) || (*psz == '-') )
+			{
+				psz++;
+			}
+			if ( *psz == '(' )
+			{
+				pVector->u16Level = (uint16_t) strtoul( psz + 1, &psz, 10);
+				psz++;
+			}
+			if ( sscanf( psz, " %23[A-Za-z0-9_]", szName) == 1 )
+			{
+				snprintf( pVector->szName, sizeof(pVector->szName), "%s", szName);
+			}
+		}
+		pVector->u16Level = (uint16_t) WCET_Annotation( l_aLevel, l_u32Levels, pVector->szName, pVector->u16Level);
+	}
+	fclose( pFile);
+	return ( l_u32Vectors != 0u );
+}
+
+/* ****************************************************************************	*
+ *	Analysis																	*
+ * ****************************************************************************	*/
+static void WCET_AnalyseFunc( int32_t i32Func);
+
+/* Cost of a call (or tail-jump) to address u32Target */
+static uint64_t WCET_CalleeCost( WCET_FUNC *pCaller, uint32_t u32Target, int32_t *pi32Callee)
+{
+	int32_t i32Callee = (u32Target != C_WCET_NO_TARGET) ? WCET_FuncAt( u32Target) : -1;
+	*pi32Callee = i32Callee;
+	if ( i32Callee < 0 )
+	{
+		pCaller->u16Flags |= (u32Target == C_WCET_NO_TARGET) ? C_FLAG_INDIRECT : C_FLAG_EXTERNAL;
+		return ( 0u );
+	}
+	WCET_AnalyseFunc( i32Callee);
+	if ( l_aFunc[i32Callee].u16State == C_FUNC_BUSY )
+	{
+		pCaller->u16Flags |= C_FLAG_RECURSION;
+		return ( 0u );
+	}
+	pCaller->u16SubFlags |= (uint16_t) (l_aFunc[i32Callee].u16Flags | l_aFunc[i32Callee].u16SubFlags);
+	return ( l_aFunc[i32Callee].u64Wcet );
+}
+
+/* Loop bound of the loop with header u32Head (back-edge from u32Tail) */
+static uint32_t WCET_LoopBound( const WCET_FUNC *pFunc, uint32_t u32Head, uint32_t u32Tail, uint16_t *pu16Default)
+{
+	const WCET_INSN *pTail = &l_aInsn[pFunc->u32First + u32Tail];
+	*pu16Default = 0u;
+	if ( strcmp( pTail->szMnem, "djnz") == 0 )
+	{
+		/* lod Cx, #n ... djnz Cx, head */
+		size_t uRegLen = strcspn( pTail->szOps, ",");
+		int32_t i32Idx;
+		for ( i32Idx = (int32_t) u32Head - 1; (i32Idx >= 0) && (i32Idx >= (int32_t) u32Head - 4); i32Idx-- )
+		{
+			const WCET_INSN *pInsn = &l_aInsn[pFunc->u32First + (uint32_t) i32Idx];
+			if ( ((strcmp( pInsn->szMnem, "lod") == 0) || (strcmp( pInsn->szMnem, "mov") == 0)) &&
+				 (strncmp( pInsn->szOps, pTail->szOps, uRegLen) == 0) && (strncmp( pInsn->szOps + uRegLen, ", #", 3) == 0) )
+			{
+				uint32_t u32Bound = (uint32_t) strtoul( pInsn->szOps + uRegLen + 3, NULL, 0);
+				return ( (u32Bound != 0u) ? u32Bound : 1u );
+			}
+		}
+	}
+	*pu16Default = 1u;
+	return ( WCET_Annotation( l_aLoop, l_u32Loops, pFunc->szName, l_u32DefLoop) );
+}
+
+/* ****************************************************************************	*
+ * WCET_AnalyseFunc()
+ *
+ * Longest path through the function (acyclic after removing the back-edges;
+ * loops are accounted at their header), and the maximum stack depth.
+ * ****************************************************************************	*/
+static void WCET_AnalyseFunc( int32_t i32Func)
+{
+	WCET_FUNC *pFunc = &l_aFunc[i32Func];
+	uint32_t u32Count = pFunc->u32Count;
+	uint64_t *au64Cost, *au64Dist, *au64Extra;
+	int32_t *ai32Next, *ai32Callee, *ai32Sp;
+	uint8_t *au8Mark;
+	uint32_t *au32Stack, *au32Succ, *au32Order;
+	uint32_t u32Sp = 0u, u32Orders = 0u, u32Idx;
+
+	if ( pFunc->u16State != C_FUNC_TODO )
+	{
+		return;
+	}
+	pFunc->u16State = C_FUNC_BUSY;
+	if ( u32Count == 0u )
+	{
+		pFunc->u16State = C_FUNC_DONE;
+		return;
+	}
+	au64Cost = calloc( u32Count, sizeof(uint64_t));
+	au64Dist = calloc( u32Count, sizeof(uint64_t));
+	au64Extra = calloc( u32Count, sizeof(uint64_t));
+	ai32Next = calloc( u32Count, sizeof(int32_t));
+	ai32Callee = calloc( u32Count, sizeof(int32_t));
+	ai32Sp = calloc( u32Count, sizeof(int32_t));
+	au8Mark = calloc( u32Count, sizeof(uint8_t));
+	au32Stack = calloc( u32Count, sizeof(uint32_t));
+	au32Succ = calloc( 2u * u32Count, sizeof(uint32_t));						/* [2n]: Jump target, [2n+1]: Fall-through */
+	au32Order = calloc( u32Count, sizeof(uint32_t));
+	if ( (au64Cost == NULL) || (au64Dist == NULL) || (au64Extra == NULL) || (ai32Next == NULL) || (ai32Callee == NULL) ||
+		 (ai32Sp == NULL) || (au8Mark == NULL) || (au32Stack == NULL) || (au32Succ == NULL) || (au32Order == NULL) )
+	{
+		fprintf( stderr, "Out of memory\n");
+		exit( 2);
+	}
+
+	/* Successors, cost and callees */
+	for ( u32Idx = 0u; u32Idx < u32Count; u32Idx++ )
+	{
+		const WCET_INSN *pInsn = &l_aInsn[pFunc->u32First + u32Idx];
+		uint32_t u32Target = C_WCET_NO_TARGET;
+		uint32_t u32Fall = (u32Idx + 1u < u32Count) ? (u32Idx + 1u) : C_WCET_NO_TARGET;
+		ai32Callee[u32Idx] = -1;
+		au64Cost[u32Idx] = WCET_Cycles( pInsn);
+		if ( (pInsn->u32Target != C_WCET_NO_TARGET) && (WCET_IsJump( pInsn) || WCET_IsCondJump( pInsn)) )
+		{
+			uint32_t u32Jmp;
+			for ( u32Jmp = 0u; u32Jmp < u32Count; u32Jmp++ )
+			{
+				if ( l_aInsn[pFunc->u32First + u32Jmp].u32Addr == pInsn->u32Target )
+				{
+					u32Target = u32Jmp;
+					break;
+				}
+			}
+		}
+		if ( WCET_IsReturn( pInsn) )
+		{
+			u32Fall = C_WCET_NO_TARGET;
+		}
+		else if ( WCET_IsJump( pInsn) )
+		{
+			u32Fall = C_WCET_NO_TARGET;
+			if ( u32Target == C_WCET_NO_TARGET )
+			{
+				au64Cost[u32Idx] += WCET_CalleeCost( pFunc, pInsn->u32Target, &ai32Callee[u32Idx]);	/* Tail-jump */
+			}
+		}
+		else if ( WCET_IsCall( pInsn) )
+		{
+			au64Cost[u32Idx] += WCET_CalleeCost( pFunc, pInsn->u32Target, &ai32Callee[u32Idx]);
+		}
+		else if ( WCET_IsCondJump( pInsn) && (u32Target == C_WCET_NO_TARGET) && (pInsn->u32Target != C_WCET_NO_TARGET) )
+		{
+			int32_t i32Callee;
+			au64Cost[u32Idx] += WCET_CalleeCost( pFunc, pInsn->u32Target, &i32Callee);	/* Conditional tail-jump */
+			ai32Callee[u32Idx] = i32Callee;
+		}
+		au32Succ[2u * u32Idx] = u32Target;
+		au32Succ[2u * u32Idx + 1u] = u32Fall;
+	}
+
+	/* Depth-first search: Post-order, back-edges (loops) and stack depth */
+	au32Stack[u32Sp++] = 0u;
+	au8Mark[0] = 1u;															/* 1: On DFS stack, 2: Done */
+	ai32Sp[0] = 0;
+	while ( u32Sp != 0u )
+	{
+		uint32_t u32Node = au32Stack[u32Sp - 1u];
+		uint32_t u32Edge;
+		int iPushed = 0;
+		for ( u32Edge = 0u; u32Edge < 2u; u32Edge++ )
+		{
+			uint32_t u32Succ = au32Succ[2u * u32Node + u32Edge];
+			if ( u32Succ == C_WCET_NO_TARGET )
+			{
+				continue;
+			}
+			if ( au8Mark[u32Succ] == 0u )
+			{
+				au8Mark[u32Succ] = 1u;
+				ai32Sp[u32Succ] = ai32Sp[u32Node] + WCET_StackEffect( &l_aInsn[pFunc->u32First + u32Node]);
+				au32Stack[u32Sp++] = u32Succ;
+				iPushed = 1;
+				break;
+			}
+			if ( au8Mark[u32Succ] == 1u )
+			{
+				/* Back-edge u32Node -> u32Succ: Loop */
+				uint16_t u16Default;
+				uint32_t u32Bound = WCET_LoopBound( pFunc, u32Succ, u32Node, &u16Default);
+				uint64_t u64Body = 0u;
+				uint32_t u32Body;
+				au32Succ[2u * u32Node + u32Edge] = C_WCET_NO_TARGET;
+				if ( u16Default )
+				{
+					pFunc->u16Flags |= C_FLAG_LOOP;
+				}
+				/* Body estimate: Instructions between header and back-edge (straight-line) */
+				for ( u32Body = u32Succ; (u32Body <= u32Node) && (u32Body < u32Count); u32Body++ )
+				{
+					u64Body += au64Cost[u32Body];
+				}
+				if ( u32Bound > 1u )
+				{
+					au64Extra[u32Succ] += (uint64_t) (u32Bound - 1u) * u64Body;
+				}
+			}
+		}
+		if ( !iPushed )
+		{
+			au8Mark[u32Node] = 2u;
+			au32Order[u32Orders++] = u32Node;
+			u32Sp--;
+		}
+	}
+
+	/* Longest path in reverse post-order (successors first) */
+	pFunc->i32Stack = 0;
+	for ( u32Idx = 0u; u32Idx < u32Orders; u32Idx++ )
+	{
+		uint32_t u32Node = au32Order[u32Idx];
+		const WCET_INSN *pInsn = &l_aInsn[pFunc->u32First + u32Node];
+		uint64_t u64Best = 0u;
+		uint32_t u32Edge;
+		int32_t i32Depth = ai32Sp[u32Node] + WCET_StackEffect( pInsn);
+		ai32Next[u32Node] = -1;
+		for ( u32Edge = 0u; u32Edge < 2u; u32Edge++ )
+		{
+			uint32_t u32Succ = au32Succ[2u * u32Node + u32Edge];
+			if ( (u32Succ != C_WCET_NO_TARGET) && (au8Mark[u32Succ] == 2u) && (au64Dist[u32Succ] >= u64Best) )
+			{
+				u64Best = au64Dist[u32Succ];
+				ai32Next[u32Node] = (int32_t) u32Succ;
+			}
+		}
+		au64Dist[u32Node] = au64Cost[u32Node] + au64Extra[u32Node] + u64Best;
+		if ( ai32Callee[u32Node] >= 0 )
+		{
+			i32Depth = ai32Sp[u32Node] + l_aFunc[ai32Callee[u32Node]].i32Stack +
+				((strcmp( pInsn->szMnem, "callf") == 0) ? C_WCET_CALLF_STACK : C_WCET_CALL_STACK);
+		}
+		if ( i32Depth > pFunc->i32Stack )
+		{
+			pFunc->i32Stack = i32Depth;
+		}
+	}
+	pFunc->u64Wcet = au64Dist[0];
+
+	/* Critical callee: Largest callee on the worst path */
+	{
+		int32_t i32Node = 0;
+		uint64_t u64Max = 0u;
+		while ( i32Node >= 0 )
+		{
+			int32_t i32Callee = ai32Callee[i32Node];
+			if ( (i32Callee >= 0) && (l_aFunc[i32Callee].u16State == C_FUNC_DONE) && (l_aFunc[i32Callee].u64Wcet > u64Max) )
+			{
+				u64Max = l_aFunc[i32Callee].u64Wcet;
+				pFunc->i32Critical = i32Callee;
+			}
+			i32Node = ai32Next[i32Node];
+		}
+	}
+
+	free( au64Cost);
+	free( au64Dist);
+	free( au64Extra);
+	free( ai32Next);
+	free( ai32Callee);
+	free( ai32Sp);
+	free( au8Mark);
+	free( au32Stack);
+	free( au32Succ);
+	free( au32Order);
+	pFunc->u16State = C_FUNC_DONE;
+} /* End of WCET_AnalyseFunc() */
+
+static void WCET_PrintPath( int32_t i32Func)
+{
+	uint16_t u16Depth = 0u;
+	while ( (i32Func >= 0) && (u16Depth < 12u) )
+	{
+		printf( "%s%s(%llu)", (u16Depth != 0u) ? " -> " : "", WCET_StripName( l_aFunc[i32Func].szName),
+			(unsigned long long) l_aFunc[i32Func].u64Wcet);
+		i32Func = l_aFunc[i32Func].i32Critical;
+		u16Depth++;
+	}
+	printf( "\n");
+}
+
+static const char *WCET_Flags( uint16_t u16Flags)
+{
+	static char szFlags[8];
+	snprintf( szFlags, sizeof(szFlags), "%c%c%c%c",
+		(u16Flags & C_FLAG_LOOP) ? 'L' : '-', (u16Flags & C_FLAG_INDIRECT) ? 'I' : '-',
+		(u16Flags & C_FLAG_EXTERNAL) ? 'E' : '-', (u16Flags & C_FLAG_RECURSION) ? 'R' : '-');
+	return ( szFlags );
+}
+
+static void WCET_Usage( const char *pszName)
+{
+	fprintf( stderr,
+		"Usage: %s [options] <project>.lss <project>.map vectors-lin.S\n"
+		"  -T clocks      ISR budget (default: %u, one PWM period)\n"
+		"  -l n           Default loop-bound (default: %u)\n"
+		"  -L f=n         Loop-bound of the loops in function f (repeatable)\n"
+		"  -i NAME=level  Interrupt level of vector NAME (repeatable; default: vectors-lin.S comment)\n"
+		"  -m mnem=n      Additional cycles of instruction mnem (repeatable)\n"
+		"  -s function    Main-loop root for the stack-depth (default: main)\n",
+		pszName, C_WCET_DEF_PERIOD, C_WCET_DEF_LOOP);
+	exit( 2);
+}
+
+/* ****************************************************************************	*
+ * main()
+ * ****************************************************************************	*/
+int main( int argc, char *argv[])
+{
+	int32_t i32Main, i32MaxChain = 0;
+	uint32_t u32Idx, u32Other;
+	uint32_t u32Stale = 0u;													/* Vector handlers not in the listing */
+	int iResult = 0;
+	int iOpt;
+
+	while ( (iOpt = getopt( argc, argv, "T:l:L:i:m:s:")) != -1 )
+	{
+		switch ( iOpt )
+		{
+		case 'T':
+			l_u32Period = (uint32_t) strtoul( optarg, NULL, 0);
+			break;
+		case 'l':
+			l_u32DefLoop = (uint32_t) strtoul( optarg, NULL, 0);
+			break;
+		case 'L':
+			if ( !WCET_AddAnnotation( l_aLoop, &l_u32Loops, optarg) )
+			{
+				WCET_Usage( argv[0]);
+			}
+			break;
+		case 'i':
+			if ( !WCET_AddAnnotation( l_aLevel, &l_u32Levels, optarg) )
+			{
+				WCET_Usage( argv[0]);
+			}
+			break;
+		case 'm':
+			{
+				WCET_COST *pCost;
+				const char *pszValue = strchr( optarg, '=');
+				if ( pszValue == NULL )
+				{
+					WCET_Usage( argv[0]);
+				}
+				for ( pCost = l_aCost; pCost->pszMnem != NULL; pCost++ )
+				{
+					if ( strncmp( pCost->pszMnem, optarg, (size_t) (pszValue - optarg)) == 0 )
+					{
+						pCost->u16Cycles = (uint16_t) strtoul( pszValue + 1, NULL, 0);
+					}
+				}
+			}
+			break;
+		case 's':
+			l_pszMain = optarg;
+			break;
+		default:
+			WCET_Usage( argv[0]);
+		}
+	}
+	if ( (argc - optind) != 3 )
+	{
+		WCET_Usage( argv[0]);
+	}
+	l_aInsn = calloc( C_WCET_MAX_INSN, sizeof(WCET_INSN));
+	if ( (l_aInsn == NULL) || !WCET_ReadListing( argv[optind]) || !WCET_ReadMap( argv[optind + 1]) ||
+		 !WCET_ReadVectors( argv[optind + 2]) )
+	{
+		return ( 2 );
+	}
+
+	/* Resolve the handlers with the symbol addresses (e.g. ml_LinInterruptHandler = linit) */
+	for ( u32Idx = 0u; u32Idx < l_u32Vectors; u32Idx++ )
+	{
+		WCET_VECTOR *pVector = &l_aVector[u32Idx];
+		pVector->i32Func = WCET_FindFunc( pVector->szHandler);
+		if ( pVector->i32Func < 0 )
+		{
+			for ( u32Other = 0u; u32Other < l_u32Syms; u32Other++ )
+			{
+				if ( strcmp( WCET_StripName( l_aSym[u32Other].szName), pVector->szHandler) == 0 )
+				{
+					pVector->i32Func = WCET_FuncAt( l_aSym[u32Other].u32Addr);
+				}
+			}
+		}
+		if ( pVector->i32Func >= 0 )
+		{
+			WCET_AnalyseFunc( pVector->i32Func);
+		}
+	}
+	i32Main = WCET_FindFunc( l_pszMain);
+	if ( i32Main >= 0 )
+	{
+		WCET_AnalyseFunc( i32Main);
+	}
+
+	printf( "Interrupt handlers: WCET [clocks, estimated], stack [bytes]; budget %lu clocks\n", (unsigned long) l_u32Period);
+	printf( "  %-10s %-24s %5s %5s %8s %6s %5s %8s\n", "vector", "handler", "level", "psup", "wcet", "stack", "flags", "response");
+	for ( u32Idx = 0u; u32Idx < l_u32Vectors; u32Idx++ )
+	{
+		WCET_VECTOR *pVector = &l_aVector[u32Idx];
+		uint64_t u64Blocking = 0u, u64Preempt = 0u;
+		if ( pVector->i32Func < 0 )
+		{
+			printf( "  %-10s %-24s not in listing (rebuild)\n", pVector->szName, pVector->szHandler);
+			u32Stale++;
+			continue;
+		}
+		for ( u32Other = 0u; u32Other < l_u32Vectors; u32Other++ )
+		{
+			const WCET_VECTOR *pOther = &l_aVector[u32Other];
+			if ( (u32Other == u32Idx) || (pOther->i32Func < 0) )
+			{
+				continue;
+			}
+			if ( pOther->u16Level <= pVector->u16Psup )
+			{
+				u64Preempt += l_aFunc[pOther->i32Func].u64Wcet;					/* Preempts this ISR */
+			}
+			else if ( (pVector->u16Level > pOther->u16Psup) && (l_aFunc[pOther->i32Func].u64Wcet > u64Blocking) )
+			{
+				u64Blocking = l_aFunc[pOther->i32Func].u64Wcet;					/* Blocks this ISR */
+			}
+		}
+		pVector->u64Response = u64Blocking + l_aFunc[pVector->i32Func].u64Wcet + u64Preempt;
+		printf( "  %-10s %-24s %5u %5u %8llu %6ld %5s %8llu%s\n", pVector->szName,
+			WCET_StripName( l_aFunc[pVector->i32Func].szName), pVector->u16Level, pVector->u16Psup,
+			(unsigned long long) l_aFunc[pVector->i32Func].u64Wcet, (long) (l_aFunc[pVector->i32Func].i32Stack + C_WCET_IRQ_STACK),
+			WCET_Flags( (uint16_t) (l_aFunc[pVector->i32Func].u16Flags | l_aFunc[pVector->i32Func].u16SubFlags)),
+			(unsigned long long) pVector->u64Response, (l_aFunc[pVector->i32Func].u64Wcet > l_u32Period) ? "  EXCEEDS BUDGET" : "");
+		if ( l_aFunc[pVector->i32Func].u64Wcet > l_u32Period )
+		{
+			iResult = 1;
+		}
+	}
+	printf( "  flags: L = loop with default bound, I = indirect jump/call, E = external call, R = recursion\n");
+	if ( u32Stale != 0u )
+	{
+		printf( "  %lu handler(s) of %s not in the listing: The listing is older than the sources;\n"
+				"  The WCET above is of the build of the listing, not of the current sources\n",
+				(unsigned long) u32Stale, argv[optind + 2]);
+	}
+
+	printf( "Worst-case paths:\n");
+	for ( u32Idx = 0u; u32Idx < l_u32Vectors; u32Idx++ )
+	{
+		if ( l_aVector[u32Idx].i32Func >= 0 )
+		{
+			printf( "  %-10s ", l_aVector[u32Idx].szName);
+			WCET_PrintPath( l_aVector[u32Idx].i32Func);
+		}
+	}
+
+	/* Deepest ISR nesting: Chain of ISR's, each preempting the previous one (levels strictly decrease) */
+	for ( u32Idx = l_u32Vectors; u32Idx-- > 0u; )
+	{
+		l_aVector[u32Idx].i32Chain = -1;
+	}
+	{
+		uint16_t u16Level;
+		for ( u16Level = 0u; u16Level < 8u; u16Level++ )
+		{
+			for ( u32Idx = 0u; u32Idx < l_u32Vectors; u32Idx++ )
+			{
+				WCET_VECTOR *pVector = &l_aVector[u32Idx];
+				int32_t i32Deepest = 0;
+				if ( (pVector->i32Func < 0) || (pVector->u16Level != u16Level) )
+				{
+					continue;
+				}
+				for ( u32Other = 0u; u32Other < l_u32Vectors; u32Other++ )
+				{
+					const WCET_VECTOR *pOther = &l_aVector[u32Other];
+					if ( (u32Other != u32Idx) && (pOther->i32Func >= 0) && (pOther->u16Level < u16Level) &&
+						 (pOther->u16Level <= pVector->u16Psup) && (pOther->i32Chain > i32Deepest) )
+					{
+						i32Deepest = pOther->i32Chain;
+					}
+				}
+				pVector->i32Chain = l_aFunc[pVector->i32Func].i32Stack + C_WCET_IRQ_STACK + i32Deepest;
+				if ( pVector->i32Chain > i32MaxChain )
+				{
+					i32MaxChain = pVector->i32Chain;
+				}
+			}
+		}
+	}
+	{
+		int32_t i32MainStack = (i32Main >= 0) ? l_aFunc[i32Main].i32Stack : 0;
+		int32_t i32Total = i32MainStack + i32MaxChain;
+		int32_t i32Avail = (int32_t) l_u32RamEnd - (int32_t) l_u32StackBegin;
+		printf( "Stack:        %s() %ld + nested ISR's %ld = %ld bytes; available %ld bytes (0x%04lX-0x%04lX)%s\n",
+			l_pszMain, (long) i32MainStack, (long) i32MaxChain, (long) i32Total, (long) i32Avail,
+			(unsigned long) l_u32StackBegin, (unsigned long) l_u32RamEnd, (i32Total > i32Avail) ? "  STACK_IT OVERFLOW" : "");
+		if ( i32Total > i32Avail )
+		{
+			iResult = 1;
+		}
+	}
+	if ( u32Stale != 0u )
+	{
+		iResult = 3;															/* Report of an other build: Not a budget result */
+	}
+	return ( iResult );
+} /* End of main() */
+
+/* EOF */
@@ -0,0 +1,25 @@
+#!/bin/sh
+#
+# Copyright (C) 2020 Melexis N.V.
+#
+# Host build: Batch run of the plant-model over load torques and random
+# load profiles. Metrics (CSV) are collected in plant_sweep.csv.
+#
+# Usage: plant_sweep.sh ["loads [mNm]"] ["seeds"] [valve_host options]
+#
+
+LOADS=${1:-"5 10 20 40"}
+SEEDS=${2:-"0 1 2 3 4 5 6 7"}
+[ $# -gt 0 ] && shift
+[ $# -gt 0 ] && shift
+
+cd "$(dirname "$0")" || exit 1
+make -s valve_host || exit 1
+
+echo "load,seed,t,command,t-pos,pos,Ipk,contact,stall-latency,false-stalls" > plant_sweep.csv
+for LOAD in $LOADS; do
+	for SEED in $SEEDS; do
+		./valve_host -t 9000 -C -L "$LOAD" -R "$SEED" "$@" | sed -n 's/^csv,//p' >> plant_sweep.csv
+	done
+done
+echo "$(($(wc -l < plant_sweep.csv) - 1)) command(s) in plant_sweep.csv"
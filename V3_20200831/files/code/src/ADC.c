@@ -21,9 +21,13 @@
  *				GetPhaseMotor()
  *				GetChipTemperature()
  *				GetRawMotorDriverCurrent()
+ *				GetDecimatedMotorDriverCurrent()
  *				GetMotorDriverCurrent()
  *				MeasureVsupplyAndTemperature()
  *				MeasurePhaseVoltage()
+ *				ADC_StartSnapshot()
+ *				ADC_GetSnapshot()
+ *				ADC_UpdateSnapshot()
  *
  * MELEXIS Microelectronic Integrated Systems
  * 
@@ -42,6 +46,7 @@
 #include "private_mathlib.h"
 #include <mathlib.h>															/* Use Melexis math-library functions to avoid compiler warnings */
 #include "Timer.h"
+#include "Profiler.h"
 
 /* ****************************************************************************	*
  *    NORMAL FAR IMPLEMENTATION	( NEAR Memory Space >= 0x100)					*
@@ -69,6 +74,23 @@ int16 g_i16PhaseVoltage = 1200U;												/* Phase Voltage */
 
 int16 g_i16Current = 0;															/* Supply Current */
 
+#if _SUPPORT_ADC_CURRENT_OSR
+uint8 g_u8AdcCurrentDecimation = C_ADC_DECIMATION_2;							/* PWM-periods per ADC_IT (run-time: accuracy vs. ISR-load) */
+volatile uint8 l_u8AdcCurrentDecimation = C_ADC_DECIMATION_OFF;				/* Decimation of the active motor-run sequence */
+volatile uint16 l_u16AdcCurrentSumA = 0u;										/* Sum of coil A current samples (100%) */
+volatile uint16 l_u16AdcCurrentSumB = 0u;										/* Sum of coil B current samples (50%) */
+volatile uint16 l_u16AdcCurrentSamples = 0u;									/* Number of samples per coil */
+#endif /* _SUPPORT_ADC_CURRENT_OSR */
+
+#if _SUPPORT_ADC_SNAPSHOT
+T_ADC_SNAPSHOT l_aAdcSnapshot[2];												/* Double-buffered Vs/Vsm/Tj results */
+volatile uint8 l_u8AdcSnapshotIdx = 0u;											/* Index of latest completed (stable) snapshot */
+volatile uint8 l_u8AdcSnapshotBusy = FALSE;										/* TRUE: Snapshot sequence in progress; C_ADC_SNAPSHOT_SETTLE: Results discarded */
+volatile uint16 g_u16AdcSnapshotSeq = 0u;										/* Snapshot sequence-number (incremented by ADC_IT) */
+uint16 l_u16AdcSnapshotSeqRd = 0u;												/* Sequence-number of last read snapshot */
+uint8 l_u8AdcSnapshotAge = C_ADC_SNAPSHOT_MAX_AGE;								/* Number of stale snapshot reads */
+#endif /* _SUPPORT_ADC_SNAPSHOT */
+
 #pragma space none																/* __NEAR_SECTION__ */
 
 /* ****************************************************************************	*
@@ -168,8 +190,48 @@ uint16 const SBASE_INIT_4PH[6] =												/* ADC Automated measurements */
 	(ADC_MCUR | ADC_HW_TRIGGER_PWM1_CNT),										/* 13	100%	2.5V	Unfiltered Current */
 	0xFFFFu																		/* End-of-table marker */
 };
+
+#if _SUPPORT_ADC_CURRENT_OSR
+uint16 const SBASE_INIT_4PH_D2[8] =											/* ADC Automated measurements, 2 PWM-periods */
+{																				/* Ch  Trigger	Vref	Description */
+	(ADC_TJ   | ADC_HW_TRIGGER_PWM1_CMP),										/*  1	 17%	2.5V	Internal Temperature Sensor */
+	(ADC_VS   | ADC_HW_TRIGGER_PWM2_CMP),										/*  0	 33%	2.5V	Voltage Vs-filtered (divided by 14) */
+	(ADC_MCUR | ADC_HW_TRIGGER_PWM3_CMP),										/* 13	 50%	2.5V	Unfiltered Current */
+	(ADC_VSM  | ADC_HW_TRIGGER_PWM4_CMP),										/* 14	 75%	2.5V	Voltage Vsm (divided by 14) */
+	(ADC_MCUR | ADC_HW_TRIGGER_PWM1_CNT),										/* 13	100%	2.5V	Unfiltered Current */
+	(ADC_MCUR | ADC_HW_TRIGGER_PWM3_CMP),										/* 13	 50%	2.5V	Unfiltered Current (2nd period) */
+	(ADC_MCUR | ADC_HW_TRIGGER_PWM1_CNT),										/* 13	100%	2.5V	Unfiltered Current (2nd period) */
+	0xFFFFu																		/* End-of-table marker */
+};
+
+uint16 const SBASE_INIT_4PH_D4[12] =											/* ADC Automated measurements, 4 PWM-periods */
+{																				/* Ch  Trigger	Vref	Description */
+	(ADC_TJ   | ADC_HW_TRIGGER_PWM1_CMP),										/*  1	 17%	2.5V	Internal Temperature Sensor */
+	(ADC_VS   | ADC_HW_TRIGGER_PWM2_CMP),										/*  0	 33%	2.5V	Voltage Vs-filtered (divided by 14) */
+	(ADC_MCUR | ADC_HW_TRIGGER_PWM3_CMP),										/* 13	 50%	2.5V	Unfiltered Current */
+	(ADC_VSM  | ADC_HW_TRIGGER_PWM4_CMP),										/* 14	 75%	2.5V	Voltage Vsm (divided by 14) */
+	(ADC_MCUR | ADC_HW_TRIGGER_PWM1_CNT),										/* 13	100%	2.5V	Unfiltered Current */
+	(ADC_MCUR | ADC_HW_TRIGGER_PWM3_CMP),										/* 13	 50%	2.5V	Unfiltered Current (2nd period) */
+	(ADC_MCUR | ADC_HW_TRIGGER_PWM1_CNT),										/* 13	100%	2.5V	Unfiltered Current (2nd period) */
+	(ADC_MCUR | ADC_HW_TRIGGER_PWM3_CMP),										/* 13	 50%	2.5V	Unfiltered Current (3rd period) */
+	(ADC_MCUR | ADC_HW_TRIGGER_PWM1_CNT),										/* 13	100%	2.5V	Unfiltered Current (3rd period) */
+	(ADC_MCUR | ADC_HW_TRIGGER_PWM3_CMP),										/* 13	 50%	2.5V	Unfiltered Current (4th period) */
+	(ADC_MCUR | ADC_HW_TRIGGER_PWM1_CNT),										/* 13	100%	2.5V	Unfiltered Current (4th period) */
+	0xFFFFu																		/* End-of-table marker */
+};
+#endif /* _SUPPORT_ADC_CURRENT_OSR */
 #endif /* (_SUPPORT_PWM_MODE == BIPOLAR_PWM_SINGLE_INDEPENDED_VSM) || (_SUPPORT_PWM_MODE == BIPOLAR_PWM_SINGLE_INDEPENDED_GND) || (_SUPPORT_PWM_MODE == BIPOLAR_PWM_SINGLE_MIRRORSPECIAL) */
 
+#if _SUPPORT_ADC_SNAPSHOT
+uint16 const SBASE_SNAPSHOT[4] =												/* ADC measurements at motor stop (PWM-master keeps running) */
+{																				/* Ch  Trigger	Vref	Description */
+	(ADC_TJ   | ADC_HW_TRIGGER_PWM1_CMP),										/*  1	 17%	2.5V	Internal Temperature Sensor */
+	(ADC_VS   | ADC_HW_TRIGGER_PWM2_CMP),										/*  0	 33%	2.5V	Voltage Vs (divided by 14) */
+	(ADC_VSM  | ADC_HW_TRIGGER_PWM4_CMP),										/* 14	 75%	2.5V	Voltage Vsm (divided by 14) */
+	0xFFFFu																		/* End-of-table marker */
+};
+#endif /* _SUPPORT_ADC_SNAPSHOT */
+
 #if (_SUPPORT_MOTOR_SELFTEST != FALSE)
 uint16 const tAdcSelfTest4A[12] =
 {
@@ -271,6 +333,32 @@ void ADC_Start( void)
 {
 	ADC_Stop();																	/* clear the ADC control register */
 	ADC_SBASE = (uint16) SBASE_INIT_4PH;
+#if _SUPPORT_ADC_CURRENT_OSR
+	if ( g_u8AdcCurrentDecimation >= C_ADC_DECIMATION_4 )
+	{
+		ADC_SBASE = (uint16) SBASE_INIT_4PH_D4;
+		l_u8AdcCurrentDecimation = C_ADC_DECIMATION_4;
+	}
+	else if ( g_u8AdcCurrentDecimation == C_ADC_DECIMATION_2 )
+	{
+		ADC_SBASE = (uint16) SBASE_INIT_4PH_D2;
+		l_u8AdcCurrentDecimation = C_ADC_DECIMATION_2;
+	}
+	else
+	{
+		l_u8AdcCurrentDecimation = g_u8AdcCurrentDecimation;
+	}
+	l_u16AdcCurrentSumA = 0u;
+	l_u16AdcCurrentSumB = 0u;
+	l_u16AdcCurrentSamples = 0u;
+	if ( l_u8AdcCurrentDecimation != C_ADC_DECIMATION_OFF )
+	{
+		PEND = CLR_ADC_IT;
+		BEGIN_CRITICAL_SECTION();
+		MASK |= EN_ADC_IT;														/* Enable ADC Interrupt (end-of-sequence) */
+		END_CRITICAL_SECTION();
+	}
+#endif /* _SUPPORT_ADC_CURRENT_OSR */
 	ADC_DBASE = (uint16) &g_AdcMotorRunStepper4;
 	ADC_CTRL  = (ADC_LOOP | ADC_TRIG_SRC | ADC_SYNC_SOC);						/* Loop cycle of conversion is done */
 	ADC_CTRL |= ADC_START;														/* Start ADC */
@@ -305,6 +393,12 @@ void ADC_Stop(void)
 #if ((LINPROT & LINXX) != LIN2J)
 	g_u8AdcIsrMode = C_ADC_ISR_NONE;
 #endif /* ((LINPROT & LINXX) != LIN2J) */
+#if _SUPPORT_ADC_CURRENT_OSR
+	l_u8AdcCurrentDecimation = C_ADC_DECIMATION_OFF;
+#endif /* _SUPPORT_ADC_CURRENT_OSR */
+#if _SUPPORT_ADC_SNAPSHOT
+	l_u8AdcSnapshotBusy = FALSE;												/* Aborted snapshot is not published */
+#endif /* _SUPPORT_ADC_SNAPSHOT */
 } /* End of ADC_Stop() */
 
 
@@ -329,15 +423,55 @@ void ADC_PowerOff( void)
  * ADC Interrupt Service Routine
  * In case no ADC_ISR action required, this ISR has 4us overhead (is approx: 9.5% at 24kHz PWM)
  * (push/pop + check for LIN-AA + Check BEMF ZC)
+ * Motor running: Integrate the current samples of the sequence (decimation by
+ * GetDecimatedMotorDriverCurrent()); The number of PWM-periods per sequence
+ * sets the ISR-rate.
  * ****************************************************************************	*/
 __interrupt__ void ADC_IT(void) 
 {
+	PROFILER_START();
 #if ((LINPROT & LINXX) != LIN2J)
 	if ( g_u8AdcIsrMode == C_ADC_ISR_LIN_AA ) 									/* LIN-AutoAddressing sequence */
 	{
 		/* AutoAddressingReadADCResult(); */	 									/* See MELEXIS doc */
 	}
 #endif /* ((LINPROT & LINXX) != LIN2J) */
+#if _SUPPORT_ADC_CURRENT_OSR
+	if ( l_u8AdcCurrentDecimation != C_ADC_DECIMATION_OFF )
+	{
+		uint16 u16SumA = g_AdcMotorRunStepper4.UnfilteredDriverCurrent;
+		uint16 u16SumB = g_AdcMotorRunStepper4.UnfilteredDriverCurrent2;
+		uint16 u16Samples = l_u16AdcCurrentSamples;
+		const volatile uint16 *pu16Current = &g_AdcMotorRunStepper4.au16DriverCurrent[0];
+		uint16 u16Period;
+		for ( u16Period = 1u; u16Period < l_u8AdcCurrentDecimation; u16Period++ )
+		{
+			u16SumB += *pu16Current++;
+			u16SumA += *pu16Current++;
+		}
+		if ( (u16Samples + l_u8AdcCurrentDecimation) > C_ADC_CURRENT_MAX_SAMPLES )
+		{
+			u16Samples = 0u;													/* Restart integration (long micro-step) */
+			l_u16AdcCurrentSumA = 0u;
+			l_u16AdcCurrentSumB = 0u;
+		}
+		l_u16AdcCurrentSumA += u16SumA;
+		l_u16AdcCurrentSumB += u16SumB;
+		l_u16AdcCurrentSamples = u16Samples + l_u8AdcCurrentDecimation;
+	}
+#endif /* _SUPPORT_ADC_CURRENT_OSR */
+#if _SUPPORT_ADC_SNAPSHOT
+	if ( l_u8AdcSnapshotBusy != FALSE )											/* Vs/Vsm/Tj sequence completed */
+	{
+		if ( l_u8AdcSnapshotBusy == TRUE )
+		{
+			l_u8AdcSnapshotIdx ^= 1u;											/* Publish the just written buffer */
+			g_u16AdcSnapshotSeq++;
+		}
+		l_u8AdcSnapshotBusy = FALSE;
+	}
+#endif /* _SUPPORT_ADC_SNAPSHOT */
+	PROFILER_STOP( PROFILE_ADC_IT);
 } /* End of ADC_IT() */
 
 /* ****************************************************************************	*
@@ -484,6 +618,57 @@ uint16 GetRawMotorDriverCurrent( void)
 	return ( u16Current );
 } /* End of GetRawMotorDriverCurrent() */
 
+#if _SUPPORT_ADC_CURRENT_OSR
+/* ****************************************************************************	*
+ * GetDecimatedMotorDriverCurrent()
+ *
+ * Get (raw) Motor Driver Current [ADC-LSB], averaged over all samples since
+ * the previous call (boxcar/integrate-and-dump). Called once per micro-step.
+ * Falls back to the last sample, in case decimation is off or no sequence
+ * has been completed since the previous call.
+ * ****************************************************************************	*/
+uint16 GetDecimatedMotorDriverCurrent( void)
+{
+	uint16 u16SumA;
+	uint16 u16SumB;
+	uint16 u16Samples;
+	uint16 u16Offset;
+
+	ATOMIC_CODE
+	(
+		u16SumA = l_u16AdcCurrentSumA;
+		u16SumB = l_u16AdcCurrentSumB;
+		u16Samples = l_u16AdcCurrentSamples;
+		l_u16AdcCurrentSumA = 0u;
+		l_u16AdcCurrentSumB = 0u;
+		l_u16AdcCurrentSamples = 0u;
+	);
+	if ( (l_u8AdcCurrentDecimation == C_ADC_DECIMATION_OFF) || (u16Samples == 0u) )
+	{
+		return ( GetRawMotorDriverCurrent() );
+	}
+
+	u16Offset = l_u16CurrentZeroOffset * u16Samples;
+	if ( u16SumA > u16Offset )
+	{
+		g_u16CurrentMotorCoilA = divU16_U32byU16( (uint32) (u16SumA - u16Offset) + (u16Samples >> 1u), u16Samples);
+	}
+	else
+	{
+		g_u16CurrentMotorCoilA = 0u;
+	}
+	if ( u16SumB > u16Offset )
+	{
+		g_u16CurrentMotorCoilB = divU16_U32byU16( (uint32) (u16SumB - u16Offset) + (u16Samples >> 1u), u16Samples);
+	}
+	else
+	{
+		g_u16CurrentMotorCoilB = 0u;
+	}
+	return ( g_u16CurrentMotorCoilA + g_u16CurrentMotorCoilB );
+} /* End of GetDecimatedMotorDriverCurrent() */
+#endif /* _SUPPORT_ADC_CURRENT_OSR */
+
 /* ****************************************************************************	*
  * GetMotorDriverCurrent()
  *
@@ -531,6 +716,89 @@ void MeasureMotorCurrent( void)
 
 } /* End of MeasureMotorCurrent() */
 
+#if _SUPPORT_ADC_SNAPSHOT
+/* ****************************************************************************	*
+ * ADC_StartSnapshot()
+ *
+ * Start a single Vs/Vsm/Tj sequence, triggered by the PWM-master (non-blocking).
+ * The results are written into the buffer not read by ADC_GetSnapshot();
+ * ADC_IT() publishes the buffer and increments the sequence-number.
+ * Nothing is started while a sequence or motor-run measurements are active.
+ * After ADC power-off, the reference is not yet settled (MMP140618-1): Instead
+ * of waiting one PWM-period, the first sequence is armed for the next trigger
+ * and its results are discarded by ADC_IT().
+ * ****************************************************************************	*/
+void ADC_StartSnapshot( void)
+{
+	if ( (l_u8AdcSnapshotBusy == FALSE) && ((ADC_CTRL & ADC_START) == 0u) )
+	{
+		l_u8AdcSnapshotBusy = (l_u8AdcPowerOff != 0u) ? C_ADC_SNAPSHOT_SETTLE : TRUE;
+		ADC_SBASE = (uint16) SBASE_SNAPSHOT;
+		ADC_DBASE = (uint16) &l_aAdcSnapshot[l_u8AdcSnapshotIdx ^ 1u];
+		PEND = CLR_ADC_IT;
+		BEGIN_CRITICAL_SECTION();
+		MASK |= EN_ADC_IT;														/* Enable ADC Interrupt (end-of-sequence) */
+		END_CRITICAL_SECTION();
+		ADC_CTRL = (ADC_TRIG_SRC | ADC_SYNC_SOC);								/* Single cycle of conversion is done */
+		ADC_CTRL |= ADC_START;													/* Start ADC (first conversion at the next PWM1 compare) */
+		l_u8AdcPowerOff = FALSE;
+	}
+} /* End of ADC_StartSnapshot() */
+
+/* ****************************************************************************	*
+ * ADC_GetSnapshot()
+ *
+ * Copy the latest completed snapshot into g_AdcMotorRunStepper4.
+ * Returns FALSE in case no new snapshot is completed since the previous call.
+ * The sequence-number and the buffer are read in one atomic section, so they
+ * belong to the same snapshot.
+ * ****************************************************************************	*/
+uint16 ADC_GetSnapshot( void)
+{
+	uint16 u16Result = FALSE;
+
+	ATOMIC_CODE
+	(
+		uint16 u16Seq = g_u16AdcSnapshotSeq;
+		if ( u16Seq != l_u16AdcSnapshotSeqRd )
+		{
+			const T_ADC_SNAPSHOT *pSnapshot = &l_aAdcSnapshot[l_u8AdcSnapshotIdx];
+			g_AdcMotorRunStepper4.IntTemperatureSensor = pSnapshot->IntTemperatureSensor;
+			g_AdcMotorRunStepper4.FilteredSupplyVoltage = pSnapshot->SupplyVoltage;
+			g_AdcMotorRunStepper4.FilteredDriverVoltage = pSnapshot->DriverVoltage;
+			l_u16AdcSnapshotSeqRd = u16Seq;
+			u16Result = TRUE;
+		}
+	);
+	return ( u16Result );
+} /* End of ADC_GetSnapshot() */
+
+/* ****************************************************************************	*
+ * ADC_UpdateSnapshot()
+ *
+ * Take the latest snapshot and start the next sequence (motor stopped).
+ * In case the snapshot is stale for more then C_ADC_SNAPSHOT_MAX_AGE calls
+ * (e.g. first call after reset), a blocking measurement is done instead.
+ * ****************************************************************************	*/
+void ADC_UpdateSnapshot( void)
+{
+	if ( ADC_GetSnapshot() != FALSE )
+	{
+		l_u8AdcSnapshotAge = 0u;
+	}
+	else if ( l_u8AdcSnapshotAge < C_ADC_SNAPSHOT_MAX_AGE )
+	{
+		l_u8AdcSnapshotAge++;
+	}
+	else
+	{
+		MeasureVsupplyAndTemperature();
+		l_u8AdcSnapshotAge = 0u;
+	}
+	ADC_StartSnapshot();
+} /* End of ADC_UpdateSnapshot() */
+#endif /* _SUPPORT_ADC_SNAPSHOT */
+
 #if (_SUPPORT_PHASE_SHORT_DET != FALSE) || (_SUPPORT_MOTOR_SELFTEST != FALSE)
 /* ****************************************************************************	*
  * MeasurePhaseVoltage()
@@ -38,6 +38,23 @@
 
 #define C_TEMPERATURE_JUMP		10U												/* Maximum temperature "jump" per measurement-period: 10 degrees Celsius */
 
+#if _SUPPORT_ADC_CURRENT_OSR
+#if (_SUPPORT_PWM_MODE != BIPOLAR_PWM_SINGLE_INDEPENDED_VSM) && (_SUPPORT_PWM_MODE != BIPOLAR_PWM_SINGLE_INDEPENDED_GND) && (_SUPPORT_PWM_MODE != BIPOLAR_PWM_SINGLE_MIRRORSPECIAL)
+#error "ERROR: _SUPPORT_ADC_CURRENT_OSR requires a single (coil A/B) PWM mode."
+#endif
+#define C_ADC_DECIMATION_OFF	0U												/* No ADC_IT: Last current sample per micro-step */
+#define C_ADC_DECIMATION_1		1U												/* ADC_IT every PWM-period */
+#define C_ADC_DECIMATION_2		2U												/* ADC_IT every 2nd PWM-period */
+#define C_ADC_DECIMATION_4		4U												/* ADC_IT every 4th PWM-period */
+#define C_ADC_DECIMATION_MAX	C_ADC_DECIMATION_4								/* Maximum PWM-periods per ADC sequence */
+#define C_ADC_CURRENT_MAX_SAMPLES	64U											/* Maximum samples per coil per micro-step (64 x 10-bit fits 16-bit) */
+#endif /* _SUPPORT_ADC_CURRENT_OSR */
+
+#if _SUPPORT_ADC_SNAPSHOT
+#define C_ADC_SNAPSHOT_MAX_AGE	4U												/* Maximum number of stale snapshot reads, before a blocking measurement is done */
+#define C_ADC_SNAPSHOT_SETTLE	2U												/* Snapshot sequence after ADC power-off; Results discarded */
+#endif /* _SUPPORT_ADC_SNAPSHOT */
+
 /* MMP: PC-lint first typedef always fails; So create a dummy */
 typedef unsigned char lint_typedef_fail_adc_h;
 
@@ -79,6 +96,9 @@ typedef struct /* _T_ADC_MOTORRUN_STEPPER4 */
 	uint16 UnfilteredDriverCurrent2;											/* 50/50%: Unfiltered Motor Driver Current */
 	uint16 FilteredDriverVoltage;												/* 83/83%: Motor Driver Voltage */
 	uint16 UnfilteredDriverCurrent;												/*  100%:  Unfiltered Motor Driver Current */
+#if _SUPPORT_ADC_CURRENT_OSR
+	uint16 au16DriverCurrent[2u * (C_ADC_DECIMATION_MAX - 1u)];					/* Next PWM-periods: 50% and 100% Motor Driver Current */
+#endif /* _SUPPORT_ADC_CURRENT_OSR */
 } T_ADC_MOTORRUN_STEPPER4;
 #endif /* (_SUPPORT_PWM_MODE == BIPOLAR_PWM_SINGLE_INDEPENDED_VSM) || (_SUPPORT_PWM_MODE == BIPOLAR_PWM_SINGLE_INDEPENDED_GND) || (_SUPPORT_PWM_MODE == BIPOLAR_PWM_SINGLE_MIRRORSPECIAL) */
 
@@ -108,6 +128,15 @@ extern T_ADC_MOTORRUN_STEPPER4 volatile g_AdcMotorRunStepper4;					/* ADC result
 	return ( g_AdcMotorRunStepper4.FilteredDriverVoltage );
 } /* End of GetRawVsupplyMotor() */
 
+#if _SUPPORT_ADC_SNAPSHOT
+typedef struct /* _T_ADC_SNAPSHOT */
+{
+	uint16 IntTemperatureSensor;												/* 17%: Internal Temperature Sensor */
+	uint16 SupplyVoltage;														/* 33%: Supply Voltage */
+	uint16 DriverVoltage;														/* 75%: Motor Driver Voltage */
+} T_ADC_SNAPSHOT;
+#endif /* _SUPPORT_ADC_SNAPSHOT */
+
 /* ****************************************************************************	*
  *	P u b l i c   f u n c t i o n s												*
  * ****************************************************************************	*/
@@ -129,8 +158,16 @@ extern void ResetChipTemperature( void);										/* Reset Chip temperature */
 extern void GetChipTemperature( uint16 u16Init);								/* Get Chip temperature [C] (MMP131020-1) */
 extern int16  GetMotorDriverCurrent( void);										/* Get Motor Driver Current [mA] */
 extern uint16 GetRawMotorDriverCurrent( void);									/* Get raw Motor Driver Current [ADC-LSB] */
+#if _SUPPORT_ADC_CURRENT_OSR
+extern uint16 GetDecimatedMotorDriverCurrent( void);							/* Get micro-step average Motor Driver Current [ADC-LSB] */
+#endif /* _SUPPORT_ADC_CURRENT_OSR */
 extern void MeasureVsupplyAndTemperature( void);							/* Measure (filtered) Supply and (chip) temperature */
 extern void MeasureMotorCurrent( void);											/* Measure Motor-driver (filtered) current */
+#if _SUPPORT_ADC_SNAPSHOT
+extern void ADC_StartSnapshot( void);											/* Start (non-blocking) Vs/Vsm/Tj sequence */
+extern uint16 ADC_GetSnapshot( void);											/* Get latest Vs/Vsm/Tj snapshot; FALSE: stale */
+extern void ADC_UpdateSnapshot( void);											/* Get latest snapshot and start next sequence */
+#endif /* _SUPPORT_ADC_SNAPSHOT */
 #if _SUPPORT_PHASE_SHORT_DET || (_SUPPORT_MOTOR_SELFTEST != FALSE)
 void MeasurePhaseVoltage( uint16 u16AdcSbase);									/* Measure Phase voltage (MMP130919-1) */
 void MeasureSelfTest4PH(uint16 u16AdcSbase,T_ADC_SELFTEST_4PH *padcMotorSelfTest4Ph);
@@ -155,6 +192,12 @@ extern uint16 g_u16CurrentMotorCoilB;
 extern int16 g_i16SupplyVoltage;
 extern int16 g_i16MotorVoltage;
 extern int16 g_i16ChipTemperature;
+#if _SUPPORT_ADC_CURRENT_OSR
+extern uint8 g_u8AdcCurrentDecimation;											/* PWM-periods per ADC_IT (C_ADC_DECIMATION_xxx); Applied at ADC_Start() */
+#endif /* _SUPPORT_ADC_CURRENT_OSR */
+#if _SUPPORT_ADC_SNAPSHOT
+extern volatile uint16 g_u16AdcSnapshotSeq;										/* Snapshot sequence-number */
+#endif /* _SUPPORT_ADC_SNAPSHOT */
 #if _SUPPORT_PHASE_SHORT_DET || (_SUPPORT_MOTOR_SELFTEST != FALSE)
 extern int16 g_i16PhaseVoltage;										/* Phase Voltage */
 
@@ -78,8 +78,13 @@
 
 /* NOTE: Don't use below marco's with local stack-variables; The C-compiler doesn't "see" the psup/pop 
  * It's better to use ATOMIC_CODE() */
+#ifdef __MLX16__
 #define BEGIN_CRITICAL_SECTION()	__asm__("psup #0")	/*!< Set to priority 0 to block all interrupts */
 #define END_CRITICAL_SECTION()		__asm__("pop M")	/*!< Restore priority */
+#else
+#define BEGIN_CRITICAL_SECTION()	HAL_PushPriority( 0u)	/*!< Set to priority 0 to block all interrupts (host build) */
+#define END_CRITICAL_SECTION()		HAL_PopPriority()	/*!< Restore priority (host build) */
+#endif /* __MLX16__ */
 
 /* *** Section #1: Communication *** */						
 /* *** NOTE: rename the lib_lin to lib (LIN) or lib_pwm to lib (PWM) *** */
@@ -160,7 +165,7 @@
 #define _SUPPORT_TWO_LINE_TEMP_INTERPOLATION	TRUE							/* FALSE: One line linear interpolation; TRUE: Two lines lineair interpolation */
 #define _SUPPORT_AMBIENT_TEMP				FALSE								/* FALSE: Use chip temperature for compensation; TRUE: Use estimated ambient temperature for compensation */
 #define _SUPPORT_LINNETWORK_LOADER			TRUE								/* FALSE: Flash-loading via point-to-point (0x7F); TRUE: Network Flash-loading support (NAD) */
-#define _SUPPORT_MLX16_HALT					FALSE								/* FALSE: MLX16 doesn't HALT; TRUE: MLX16 enters HALT during holding mode (power-safe) */
+#define _SUPPORT_MLX16_HALT					TRUE								/* FALSE: MLX16 doesn't HALT; TRUE: MLX16 HALTs in the main-loop until the next event (tickless idle) */
 #define _SUPPORT_VSFILTERED					FALSE								/* FALSE: Unfiltered Vs (ADC Channel 0); TRUE: Filtered Vs (ADC Channel 4) (MLX81310A) */
 #define _SUPPORT_VSMFILTERED				TRUE								/* FALSE: Unfiltered Vsm (ADC Channel 14); TRUE: Filtered Vsm (ADC Channel 4) (MLX81310C) */
 #define _SUPPORT_AUTO_BAUDRATE				TRUE								/* FALSE: Fixed baudrate; TRUE: Auto-detection of baudrate */
@@ -235,6 +240,27 @@
 #define _SUPPORT_DOUBLE_USTEP				FALSE								/* FALSE: 32 or 48 micro-steps; TRUE: 64 or 96 micro-steps */
 #define _SUPPORT_PWM_DC_RAMPUP				FALSE								/* FALSE: Constant mPWM-DC; TRUE: Increasing mPWM-DC at ramp-up */
 #define _SUPPORT_PWM_DC_RAMPDOWN			TRUE								/* FALSE: Constant mPWM-DC; TRUE: Decrease mPWM-DC at ramp-down */
+#define _SUPPORT_RAMP_TABLE					TRUE								/* FALSE: Acceleration calculated per step; TRUE: Acceleration from pre-calculated velocity-timer table */
+#define _SUPPORT_COMMUT_BOTTOM_HALF			TRUE								/* FALSE: Commutation-ISR performs all; TRUE: Current/Open/Stall-checks deferred to SOFT_IT */
+#define _SUPPORT_PROFILER					FALSE								/* FALSE: No profiling; TRUE: ISR & main-loop task execution-time profiling (Timer2) */
+#define _SUPPORT_SCHEDULER					TRUE								/* FALSE: Free-running main-loop; TRUE: Main-loop tasks in 1/10/100ms rate groups and events */
+#define _SUPPORT_VOLTAGE_CORR_SCALE			TRUE								/* FALSE: Vsm division per micro-step; TRUE: Vref/Vsm reciprocal per Vsm change, multiply per micro-step */
+#define _SUPPORT_ADC_CURRENT_OSR			TRUE								/* FALSE: Last current sample per micro-step; TRUE: All current samples of a micro-step averaged (ADC_IT, run-time decimation) */
+#define _SUPPORT_ADC_SNAPSHOT				TRUE								/* FALSE: Blocking Vs/Vsm/Tj measurement at motor stop; TRUE: PWM-triggered sequence, ADC_IT double-buffered snapshot */
+#define _SUPPORT_USTEP_QUARTER_WAVE			TRUE								/* FALSE: Full-period micro-step vector table; TRUE: Quarter-wave table, folded and interpolated (4..128 micro-steps per full-step) */
+#define _SUPPORT_RAMP_SCURVE				TRUE								/* FALSE: Constant acceleration ramp; TRUE: Jerk-limited (S-curve) ramp, limited to the move distance */
+#define _SUPPORT_SEAMLESS_REVERSAL			TRUE								/* FALSE: Change of direction by ramp-down, stop and re-start; TRUE: Ramp-down and reverse at the turning-point without stop */
+#define _SUPPORT_LOAD_ADAPTIVE_CURRENT		FALSE								/* FALSE: Fixed running current; TRUE: Running current scaled with the rotor-lag at the hall-edges (See also: _SUPPORT_HALL_SENSOR, C_HALL_EDGE_PHASE); Kept FALSE till C_HALL_EDGE_PHASE is measured on the target mechanics */
+#define _SUPPORT_NVRAM_WRITE_BACK			TRUE								/* FALSE: NVRAM_Write() programs the user-page immediately; TRUE: Write-back cache, user-pages programmed at an idle point (motor stopped) or NVRAM_Flush() */
+#define _SUPPORT_NVRAM_RECORD_CRC			TRUE								/* FALSE: One CRC over the user-page; TRUE: Check-byte per 8-word record, checked at first use, a corrupted record is cleared on its own */
+#define _SUPPORT_NVRAM_LOG					TRUE								/* FALSE: No log-structured store; TRUE: Sequence-numbered records for high-frequency data (valve moves), in the free words of user-page #2 */
+#define HALL_SWITCH_IO5						0									/* Hall-switch @ IO5 (existing boards) */
+#define HALL_SWITCH_TC1						1									/* Hall-switch @ TC1 (board variant) */
+#ifndef HALL_SWITCH_PIN
+#define HALL_SWITCH_PIN						HALL_SWITCH_IO5						/* Board: Hall-switch pin; Board variant build: -DHALL_SWITCH_PIN=HALL_SWITCH_TC1 */
+#endif /* HALL_SWITCH_PIN */
+#define _SUPPORT_HALL_TMR2_CAPTURE			(HALL_SWITCH_PIN == HALL_SWITCH_TC1)	/* FALSE: Hall-switch @ IO5, edge-ISR; TRUE: Hall-switch @ TC1, Timer2 capture time-stamps (Timer2 not available for _SUPPORT_PROFILER) */
+#define _SUPPORT_USTEP_ADAPTIVE				TRUE								/* FALSE: One micro-step per commutation; TRUE: Micro-step stride doubled with speed (up to full-step), commutation ISR rate capped */
 #define _SUPPORT_PWM_100PCT					TRUE								/* FALSE: max. PWM duty-cycle: 97.5%; TRUE: max. PWM duty-cycle: 100% */
 
 /* *** Section #6: Debug *** */									/* <<<6<<< */
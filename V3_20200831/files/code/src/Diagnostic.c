@@ -12,6 +12,9 @@
  *
  * \functions	DiagnosticsInit()
  *				EXT4_IT()
+ *				HallCaptureInit()
+ *				EXT1_IT()
+ *				HallEdgeRotorLag()
  *				
  *
  * MELEXIS Microelectronic Integrated Systems
@@ -32,7 +35,18 @@
 #include "MotorDriver.h"
 #include "MotorDriverTables.h"
 #include "Timer.h"
+#include "Profiler.h"
 #include <Private_mathlib.h>
+#include <mathlib.h>															/* Use Melexis math-library functions to avoid compiler warnings */
+
+#if _SUPPORT_HALL_TMR2_CAPTURE
+#if (_SUPPORT_HALL_SENSOR == FALSE)
+#error "ERROR: Timer2 hall-edge capture requires the hall-sensor (_SUPPORT_HALL_SENSOR)"
+#endif /* (_SUPPORT_HALL_SENSOR == FALSE) */
+#if _SUPPORT_PROFILER
+#error "ERROR: Timer2 is used either by the profiler or by the hall-edge capture"
+#endif /* _SUPPORT_PROFILER */
+#endif /* _SUPPORT_HALL_TMR2_CAPTURE */
 
 
 /* Debounce error filter; An error has to be detected twice in a row */
@@ -57,6 +71,16 @@
  * ****************************************************************************	*/
 #pragma space nodp
 uint16 g_u16HallMicroStepIdx = 0xFFFFu;
+#if _SUPPORT_LOAD_ADAPTIVE_CURRENT
+T_HALL_EDGE g_HallEdge;															/* Last hall-edge (captured by the hall-edge ISR) */
+volatile uint8 g_u8HallEdgeCount = 0u;											/* Number of captured hall-edges (wrapping) */
+#endif /* _SUPPORT_LOAD_ADAPTIVE_CURRENT */
+#if _SUPPORT_HALL_TMR2_CAPTURE
+uint16 g_u16HallEdgePeriod = 0xFFFFu;											/* Time between the last two hall-edges [TIMER_CLOCK]; 0xFFFF: Too slow */
+int16 g_i16HallEdgePeriodDelta = 0;												/* Change of g_u16HallEdgePeriod; < 0: Accelerating */
+uint16 l_u16HallCaptureTime;													/* Timer2 time-stamp of the last hall-edge */
+uint8 l_u8HallCaptureOverflows = 2u;											/* Timer2 overflows since the last hall-edge (saturated at 2) */
+#endif /* _SUPPORT_HALL_TMR2_CAPTURE */
 
 uint16 l_u16HallSwitchState = 0xFFu;
 uint8  l_u8DriftCheckCount = 0u;
@@ -76,6 +100,9 @@ uint16 l_u16CoilCurrentStartDelay = 0u;
 
 
 void HandleDiagnosticEvent( uint16 u16Event);
+#if _SUPPORT_LOAD_ADAPTIVE_CURRENT
+static void HallEdgeCapture( uint16 u16Elapsed, uint16 u16Period);
+#endif /* _SUPPORT_LOAD_ADAPTIVE_CURRENT */
 
 
 /* ****************************************************************************	*
@@ -99,7 +126,11 @@ void DiagnosticsInit( void)
 	ANA_OUTG |= INACTIVE_OVT;													/* MMP150409-2 */
 #endif /* (_SUPPORT_DIAG_OVT == FALSE) */
 
-#if (_SUPPORT_HALL_SENSOR)
+#if _SUPPORT_HALL_TMR2_CAPTURE
+	XI4_PEND = C_DIAG_MASK;
+	XI4_MASK |= C_DIAG_MASK;
+	HallCaptureInit();															/* Hall-switch @ TC1: Timer2 capture */
+#elif (_SUPPORT_HALL_SENSOR)
 	XI4_PEND = (C_DIAG_MASK | XI4_IO5);
 	XI4_MASK |= (C_DIAG_MASK | XI4_IO5);										/* Enable second-level diagnostic interrupts and Hall-switch @ IO[0] */
 	l_u16HallSwitchState = (IO_IN & XI4_IO5);
@@ -116,7 +147,7 @@ void DiagnosticsInit( void)
 #else  /* (_SUPPORT_HALL_SENSOR) */
 	XI4_PEND = C_DIAG_MASK;
 	XI4_MASK |= C_DIAG_MASK;
-#endif /* (_SUPPORT_HALL_SENSOR) */
+#endif /* _SUPPORT_HALL_TMR2_CAPTURE */
 	/* PRIO = (PRIO & ~(3U << 14)) | ((3U - 3U) << 14); */							/* EXT4_IT Priority: 3 (3..6) */
 	PRIO &= ~((uint16)3u << 14u);												/* EXT4_IT Priority: 3 (3..6) */
 	PRIO |= ((uint16)(3u - 3u) << 14u);
@@ -203,6 +234,7 @@ void HandleDiagnosticEvent( uint16 u16Event)
  * ****************************************************************************	*/
 __interrupt__ void EXT4_IT(void)
 {
+	PROFILER_START();
 	uint16 u16Pending = (XI4_PEND & XI4_MASK);									/* Copy interrupt requests which are not masked   */
 	do
 	{
@@ -218,6 +250,7 @@ __interrupt__ void EXT4_IT(void)
 	{
 		HandleDiagnosticEvent( u16Pending);
 
+#if (_SUPPORT_HALL_TMR2_CAPTURE == FALSE)
 		if ( (u16Pending & XI4_IO5) != 0u )
 		{
 			l_u16HallSwitchState = (IO_IN & XI4_IO5);
@@ -233,10 +266,178 @@ __interrupt__ void EXT4_IT(void)
 			}
 
 			g_u16HallMicroStepIdx = g_u16ActuatorActPos;
+#if _SUPPORT_LOAD_ADAPTIVE_CURRENT
+			if ( g_u8MotorStartupMode != (uint8) MSM_STOP )
+			{
+				HallEdgeCapture( TMR1_CNT, (TMR1_REGB + 1u));					/* Field progress since the last commutation */
+			}
+#endif /* _SUPPORT_LOAD_ADAPTIVE_CURRENT */
 		}
+#endif /* (_SUPPORT_HALL_TMR2_CAPTURE == FALSE) */
 	}
+	PROFILER_STOP( PROFILE_EXT4_IT);
 } /* EXT4_IT() */
 
+#if _SUPPORT_LOAD_ADAPTIVE_CURRENT
+/* ****************************************************************************	*
+ * HallEdgeCapture()
+ *
+ * Hall-edge ISR part of the rotor-lag: Capture the field-phase at the edge
+ * (micro-step index and commutation-timer progress); The division is left to
+ * HallEdgeRotorLag() in the main-loop.
+ * ****************************************************************************	*/
+static void HallEdgeCapture( uint16 u16Elapsed, uint16 u16Period)
+{
+	g_HallEdge.u16MicroStepIdx = g_u16MicroStepIdx;
+	g_HallEdge.u16Elapsed = u16Elapsed;
+	g_HallEdge.u16Period = u16Period;
+#if _SUPPORT_USTEP_ADAPTIVE
+	g_HallEdge.u16Stride = l_u16MicroStepStride;
+#else  /* _SUPPORT_USTEP_ADAPTIVE */
+	g_HallEdge.u16Stride = 1u;
+#endif /* _SUPPORT_USTEP_ADAPTIVE */
+	g_HallEdge.e8MotorDirectionCCW = g_e8MotorDirectionCCW;
+	g_u8HallEdgeCount++;
+} /* End of HallEdgeCapture() */
+
+/* ****************************************************************************	*
+ * HallEdgeRotorLag()
+ *
+ * Rotor-lag at a hall-edge: The hall-sensor switches at a fixed rotor-angle
+ * within a full-step; The field-phase at the edge (micro-step index plus the
+ * progress [1/256 micro-step] since its commutation) relative to
+ * C_HALL_EDGE_PHASE is the lag. Called from the main-loop, with a copy of
+ * g_HallEdge.
+ * ****************************************************************************	*/
+int16 HallEdgeRotorLag( const T_HALL_EDGE *pHallEdge)
+{
+	uint16 u16PhaseMask = ((uint16) C_MICROSTEP_PER_FULLSTEP << 8) - 1u;
+	uint16 u16Phase = (pHallEdge->u16MicroStepIdx << 8) - (C_HALL_EDGE_PHASE << NVRAM_MICRO_STEPS_SHIFT);	/* [1/256 micro-step] */
+	uint16 u16Fraction = divU16_U32byU16( ((uint32) pHallEdge->u16Elapsed << 8), pHallEdge->u16Period) * pHallEdge->u16Stride;
+	int16 i16RotorLag;
+
+	if ( (NVRAM_MOTOR_DIR_INV != 0u) == (pHallEdge->e8MotorDirectionCCW == C_MOTOR_DIR_CCW) )
+	{
+		/* Decrementing micro-step index */
+		u16Phase = (uint16) (0u - u16Phase) + u16Fraction;
+	}
+	else
+	{
+		/* Incrementing micro-step index */
+		u16Phase = u16Phase + u16Fraction;
+	}
+	i16RotorLag = (int16) ((u16Phase & u16PhaseMask) >> NVRAM_MICRO_STEPS_SHIFT);
+	if ( i16RotorLag >= (int16) C_HALL_LAG_WRAP )
+	{
+		i16RotorLag -= 256;														/* Rotor leading the field */
+	}
+	return ( i16RotorLag );
+} /* End of HallEdgeRotorLag() */
+#endif /* _SUPPORT_LOAD_ADAPTIVE_CURRENT */
+
+#if _SUPPORT_HALL_TMR2_CAPTURE
+/* ****************************************************************************	*
+ * HallCaptureInit()
+ *
+ * Hall-switch on TC1, routed to Timer2 input A. Timer2 runs free in capture
+ * mode at the commutation-timer clock and time-stamps both edges; The
+ * overflow counts the Timer2 wrap-arounds between two edges.
+ * Timer2 ISR priority: 4 (same as the commutation ISR, no mutual pre-emption)
+ * ****************************************************************************	*/
+void HallCaptureInit( void)
+{
+	ANA_OUTG |= TC1_ENPU;														/* Open-drain hall-switch */
+	ANA_OUTI = (ANA_OUTI & ~((uint16)3u << 4u) & ~TC1_DEBOUNCE_400u) | T2_INA_TC1 | TC1_DEBOUNCE_OFF;
+	TMR2_CTRL = C_TMR2_CTRL_HALL_CAPTURE;
+	TMR2_REGA = 0u;
+	TMR2_REGB = 0u;
+	TMR2_CTRL = C_TMR2_CTRL_HALL_CAPTURE | TMRx_START;
+	l_u8HallCaptureOverflows = 2u;
+	g_u16HallEdgePeriod = 0xFFFFu;
+	g_i16HallEdgePeriodDelta = 0;
+
+	XI1_PEND = (CLR_T2_INT1 | CLR_T2_INT3);
+	XI1_MASK |= (EN_T2_INT1 | EN_T2_INT3);										/* Capture A and overflow */
+	PRIO &= ~((uint16)3u << 8u);												/* EXT1_IT Priority: 4 (3..6) */
+	PRIO |= ((uint16)(4u - 3u) << 8u);
+	PEND = CLR_EXT1_IT;
+	MASK |= EN_EXT1_IT;
+} /* End of HallCaptureInit() */
+
+/* ****************************************************************************	*
+ * EXT1_IT()
+ *
+ * Timer2 Interrupt Service Routine: Hall-edge captured (TMR2_REGA) or Timer2
+ * overflow. The edge time-stamp gives the hall-edge period (speed) and its
+ * change (acceleration) and, against the time-stamp of the last commutation,
+ * the field-phase at the edge with sub-micro-step resolution.
+ * ****************************************************************************	*/
+__interrupt__ void EXT1_IT(void)
+{
+	uint16 u16Pending = (XI1_PEND & XI1_MASK);
+	do
+	{
+		XI1_PEND = u16Pending;
+	} while ((XI1_PEND & u16Pending) != 0u);
+
+	if ( (u16Pending & EN_T2_INT3) != 0u )
+	{
+		if ( l_u8HallCaptureOverflows < 2u )
+		{
+			l_u8HallCaptureOverflows++;
+		}
+	}
+	if ( (u16Pending & EN_T2_INT1) != 0u )
+	{
+		uint16 u16CaptureTime = TMR2_REGA;
+		uint16 u16EdgePeriod = u16CaptureTime - l_u16HallCaptureTime;
+		uint8 u8Overflows = l_u8HallCaptureOverflows;
+
+		if ( (u8Overflows == 1u) && ((u16Pending & EN_T2_INT3) != 0u) && (u16CaptureTime >= 0x8000u) )
+		{
+			u8Overflows = 0u;															/* Edge captured before the (simultaneous) overflow */
+		}
+		if ( (u8Overflows == 0u) || ((u8Overflows == 1u) && (u16CaptureTime < l_u16HallCaptureTime)) )
+		{
+			g_i16HallEdgePeriodDelta = (int16) (u16EdgePeriod - g_u16HallEdgePeriod);
+			g_u16HallEdgePeriod = u16EdgePeriod;
+		}
+		else
+		{
+			g_i16HallEdgePeriodDelta = 0;
+			g_u16HallEdgePeriod = 0xFFFFu;												/* (Almost) standstill */
+		}
+		l_u16HallCaptureTime = u16CaptureTime;
+		l_u8HallCaptureOverflows = 0u;
+
+		g_u16HallMicroStepIdx = g_u16ActuatorActPos;
+#if _SUPPORT_LOAD_ADAPTIVE_CURRENT
+		if ( g_u8MotorStartupMode != (uint8) MSM_STOP )
+		{
+			/* Field progress from the last commutation to the edge; The commutation ISR
+			 * can't pre-empt, but may be pending (edge after the commutation-timer expired) */
+			uint16 u16Period = TMR1_REGB + 1u;
+			uint16 u16Elapsed = u16CaptureTime - g_u16CommutTimeStamp;
+			if ( u16Elapsed >= 0x8000u )
+			{
+				/* Edge before the last commutation: Time-stamp of the ISR latency-compensated commutation */
+				u16Elapsed = 0u;
+			}
+			else if ( u16Elapsed >= u16Period )
+			{
+				u16Elapsed = u16Period - 1u;											/* Commutation pending */
+			}
+			else
+			{
+				/* MISRA C:2012 Rule-15.7:All if ... else if constructs shall be terminated with an else statement */
+			}
+			HallEdgeCapture( u16Elapsed, u16Period);
+		}
+#endif /* _SUPPORT_LOAD_ADAPTIVE_CURRENT */
+	}
+} /* End of EXT1_IT() */
+#endif /* _SUPPORT_HALL_TMR2_CAPTURE */
+
 void MotorDiagnosticCheckInit(void)
 {
 	l_u16CoilCurrentStartDelay = C_MOVAVG_SZ;
@@ -299,7 +500,11 @@ void MotorDiagnosticVsupplyAndTemperature(void)
 	/* Perform Vbat/Temperature measurement incase motor is stopped */
 	if(g_u8MotorStartupMode == (uint8) MSM_STOP)	
 	{
+#if _SUPPORT_ADC_SNAPSHOT
+		ADC_UpdateSnapshot();
+#else  /* _SUPPORT_ADC_SNAPSHOT */
 		MeasureVsupplyAndTemperature();
+#endif /* _SUPPORT_ADC_SNAPSHOT */
 	}
 	/***************************************************
 	 * p. Motor over/under temperature
@@ -48,10 +48,27 @@
 #define C_COIL_CURRENT_START_DELAY			128U
 
 
+#if _SUPPORT_LOAD_ADAPTIVE_CURRENT
+typedef struct /* _T_HALL_EDGE */
+{
+	uint16 u16MicroStepIdx;														/* Micro-step index at the hall-edge */
+	uint16 u16Elapsed;															/* Commutation-timer clocks from the last commutation to the edge */
+	uint16 u16Period;															/* Commutation-timer period */
+	uint16 u16Stride;															/* Micro-steps per commutation */
+	uint8 e8MotorDirectionCCW;													/* Motor direction at the edge */
+} T_HALL_EDGE;
+#endif /* _SUPPORT_LOAD_ADAPTIVE_CURRENT */
+
 /* ****************************************************************************	*
  *	P u b l i c   f u n c t i o n s												*
  * ****************************************************************************	*/
 extern void DiagnosticsInit( void);
+#if _SUPPORT_LOAD_ADAPTIVE_CURRENT
+extern int16 HallEdgeRotorLag( const T_HALL_EDGE *pHallEdge);					/* Rotor-lag at a hall-edge [1/256 full-step] */
+#endif /* _SUPPORT_LOAD_ADAPTIVE_CURRENT */
+#if _SUPPORT_HALL_TMR2_CAPTURE
+extern void HallCaptureInit( void);
+#endif /* _SUPPORT_HALL_TMR2_CAPTURE */
 
 extern void MotorDiagnosticSelfTest( void);
 void MotorDiagnosticVsupplyAndTemperature(void);
@@ -64,6 +81,14 @@ uint8 MotorDiagnosticOpenCheck(void);
  * ****************************************************************************	*/
 #pragma space nodp
 extern uint16 g_u16HallMicroStepIdx;
+#if _SUPPORT_LOAD_ADAPTIVE_CURRENT
+extern T_HALL_EDGE g_HallEdge;													/* Last hall-edge (captured by the hall-edge ISR) */
+extern volatile uint8 g_u8HallEdgeCount;										/* Number of captured hall-edges (wrapping) */
+#endif /* _SUPPORT_LOAD_ADAPTIVE_CURRENT */
+#if _SUPPORT_HALL_TMR2_CAPTURE
+extern uint16 g_u16HallEdgePeriod;												/* Time between the last two hall-edges [TIMER_CLOCK]; 0xFFFF: Too slow */
+extern int16 g_i16HallEdgePeriodDelta;											/* Change of g_u16HallEdgePeriod; < 0: Accelerating */
+#endif /* _SUPPORT_HALL_TMR2_CAPTURE */
 #pragma space none
 
 #endif /* DIAGNOSTIC_H_ */
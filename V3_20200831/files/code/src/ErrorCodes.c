@@ -12,8 +12,11 @@
  *
  * \functions	ErrorLogInit()
  *				SetLastError()
+ *				GetLastErrorEntry()
  *				GetLastError()
- *				
+ *				ErrorLog_MainFunction()
+ *				ErrorLog_Flush()
+ *
  *
  * MELEXIS Microelectronic Integrated Systems
  * 
@@ -29,11 +32,39 @@
 #include "Build.h"
 #include "ErrorCodes.h"
 #include "NVRAM_UserPage.h"
+#include "Timer.h"																/* Error time-stamp */
+
+#define C_ERR_LOG_MASK	(C_ERR_LOG_SZ - 1u)
+
+#if ((C_ERR_LOG_SZ & C_ERR_LOG_MASK) != 0u)
+#error "ERROR: C_ERR_LOG_SZ must be a power of 2"
+#endif /* ((C_ERR_LOG_SZ & C_ERR_LOG_MASK) != 0u) */
+#if (C_ERR_LOG_SZ < 2u)
+#error "ERROR: C_ERR_LOG_SZ must be at least 2 (reader owns the tail entry)"
+#endif /* (C_ERR_LOG_SZ < 2u) */
+
+/* Ring-buffer; Head only written by SetLastError(), Tail only by GetLastErrorEntry() (free-running).
+ * SetLastError() never writes the entry at the tail (the one GetLastErrorEntry() may be reading) */
+ERR_LOG_ENTRY l_aErrorLog[C_ERR_LOG_SZ];
+volatile uint8 l_u8ErrorLogHead = 0u;
+volatile uint8 l_u8ErrorLogTail = 0u;
+
+#if (_DEBUG > 0u) && (_DEBUG_NVRAM_ERRORLOG > 0u)
+#define C_ERR_NVRAM_MASK	(C_ERR_NVRAM_QUEUE_SZ - 1u)
 
-#define C_ERR_LOG_SZ	10u
+#if ((C_ERR_NVRAM_QUEUE_SZ & C_ERR_NVRAM_MASK) != 0u)
+#error "ERROR: C_ERR_NVRAM_QUEUE_SZ must be a power of 2"
+#endif /* ((C_ERR_NVRAM_QUEUE_SZ & C_ERR_NVRAM_MASK) != 0u) */
 
-uint8 l_au8FiFoErrorLog[C_ERR_LOG_SZ];
-uint8 l_u8ErrorLogIdx = 0u;
+/* Serious error-codes to be stored in NVRAM by ErrorLog_MainFunction() */
+uint8 l_au8ErrorNvramQueue[C_ERR_NVRAM_QUEUE_SZ];
+volatile uint8 l_u8ErrorNvramHead = 0u;
+volatile uint8 l_u8ErrorNvramTail = 0u;
+uint8 l_au8ErrorNvramRecent[C_ERR_NVRAM_QUEUE_SZ];								/* Error-codes stored in NVRAM recently (C_ERR_NONE: None) */
+uint16 l_au16ErrorNvramRecentTime[C_ERR_NVRAM_QUEUE_SZ];						/* Tick-counter at the NVRAM store */
+uint8 l_u8ErrorNvramRecentIdx = 0u;												/* Oldest entry; Last NVRAM store at index - 1 */
+uint8 g_u8ErrorNvramDropped = 0u;												/* Serious errors not stored (queue full or duplicate), saturated */
+#endif /* (_DEBUG > 0u) && (_DEBUG_NVRAM_ERRORLOG > 0u) */
 
 /* ****************************************************************************	*
  * ErrorLogInit
@@ -48,12 +79,8 @@ void ErrorLogInit( void)
 {
 	if ( (AWD_CTRL & AWD_RST) != 0u )
 	{
-		uint16 i;
-		for ( i = 0u; i < C_ERR_LOG_SZ; i++ )
-		{
-			l_au8FiFoErrorLog[i] = (uint8)C_ERR_NONE;
-		}
-		l_u8ErrorLogIdx = 0u;
+		l_u8ErrorLogHead = 0u;
+		l_u8ErrorLogTail = 0u;
 	}
 } /* End of ErrorLogInit() */
 
@@ -63,49 +90,185 @@ void ErrorLogInit( void)
  *	Pre:		uint8 u8ErrorCode: Error-code (8-bits)
  *	Post:		Nothing
  *
- *	Comments:	Save error-code in Error-FiFo-buffer, unless last error is the 
- *				same as error posted.
+ *	Comments:	Save error-code in Error-FiFo-buffer. The same error as the last
+ *				error only increments its occurrence counter, unless that entry
+ *				is the oldest one (may be read by GetLastErrorEntry()): A new
+ *				entry is used then. Buffer full: The last error is replaced.
+ *				Constant-time; The critical section only serializes the
+ *				producers (ISR's of any level and the main-loop; The MLX16 has
+ *				no compare-and-swap), the reader never blocks them.
  * ****************************************************************************	*/
 void SetLastError( uint8 u8ErrorCode)
 {
-	if ( (l_u8ErrorLogIdx == 0u) || (l_au8FiFoErrorLog[l_u8ErrorLogIdx - 1u] != u8ErrorCode) )
-	{
-		/* Don't log the same error over and over again */
-		l_au8FiFoErrorLog[l_u8ErrorLogIdx] = u8ErrorCode;
-		if ( l_u8ErrorLogIdx < (C_ERR_LOG_SZ - 1u) )
+	uint16 u16NewError = FALSE;
+
+	ATOMIC_CODE
+	(
+		uint8 u8Head = l_u8ErrorLogHead;
+		PERR_LOG_ENTRY pEntry = &l_aErrorLog[(uint8) (u8Head - 1u) & C_ERR_LOG_MASK];
+		uint8 u8Tail = l_u8ErrorLogTail;
+		if ( ((uint8) (u8Head - u8Tail) >= 2u) && (pEntry->u8ErrorCode == u8ErrorCode) )
 		{
-			l_u8ErrorLogIdx++;
+			/* Don't log the same error over and over again */
+			if ( pEntry->u8Count != 0xFFu )
+			{
+				pEntry->u8Count++;
+			}
 		}
-#if (_DEBUG > 0u) && (_DEBUG_NVRAM_ERRORLOG > 0u)
-		/* Log serious error-codes also in NVRAM */
-		/* Serious errors are:
-		  * Unsupported IRQ's   or C_ERR_INV_MLXPAGE_CRC1..4, CAL_GN or Over-temperature                   or 'Fatal'-errors */
-		if ( (u8ErrorCode < 0x20u) || ((u8ErrorCode & 0xC8u) == 0xC8u) || (u8ErrorCode == (uint8) C_ERR_DIAG_OVER_TEMP) || ((u8ErrorCode & 0xF0u) == 0xF0u) ) /*lint !e845 */
+		else
 		{
-			(void) NVRAM_LogError( u8ErrorCode);
+			if ( (uint8) (u8Head - u8Tail) < C_ERR_LOG_SZ )
+			{
+				pEntry = &l_aErrorLog[u8Head & C_ERR_LOG_MASK];
+				u8Head++;
+			}
+			pEntry->u8ErrorCode = u8ErrorCode;									/* Full: Last entry (not the tail, C_ERR_LOG_SZ >= 2) */
+			pEntry->u8Count = 1u;
+			u16NewError = TRUE;
 		}
-#endif
+		pEntry->u16TimeStamp = g_u16TimerTicks;
+		l_u8ErrorLogHead = u8Head;												/* Publish entry */
+	);
+#if (_DEBUG > 0u) && (_DEBUG_NVRAM_ERRORLOG > 0u)
+	/* Log serious error-codes also in NVRAM (queued, stored by ErrorLog_MainFunction()) */
+	/* Serious errors are:
+	  * Unsupported IRQ's   or C_ERR_INV_MLXPAGE_CRC1..4, CAL_GN or Over-temperature                   or 'Fatal'-errors */
+	if ( (u16NewError != FALSE) &&
+		 ((u8ErrorCode < 0x20u) || ((u8ErrorCode & 0xC8u) == 0xC8u) || (u8ErrorCode == (uint8) C_ERR_DIAG_OVER_TEMP) || ((u8ErrorCode & 0xF0u) == 0xF0u)) ) /*lint !e845 */
+	{
+		ATOMIC_CODE
+		(
+			uint8 u8Idx = l_u8ErrorNvramTail;
+			while ( (u8Idx != l_u8ErrorNvramHead) && (l_au8ErrorNvramQueue[u8Idx & C_ERR_NVRAM_MASK] != u8ErrorCode) )
+			{
+				u8Idx++;
+			}
+			if ( (u8Idx == l_u8ErrorNvramHead) && ((uint8) (u8Idx - l_u8ErrorNvramTail) < C_ERR_NVRAM_QUEUE_SZ) )
+			{
+				l_au8ErrorNvramQueue[u8Idx & C_ERR_NVRAM_MASK] = u8ErrorCode;
+				l_u8ErrorNvramHead = (uint8) (u8Idx + 1u);
+			}
+			else if ( g_u8ErrorNvramDropped != 0xFFu )
+			{
+				g_u8ErrorNvramDropped++;										/* Already queued, or queue full */
+			}
+		);
 	}
+#else
+	(void) u16NewError;
+#endif
 } /* End of SetLastError() */
 
+/* ****************************************************************************	*
+ * GetLastErrorEntry
+ *
+ *	Pre:		pEntry: Oldest error-log entry (unchanged if empty)
+ *	Post:		FALSE: Error-log empty; TRUE: Entry removed from Error-FiFo-buffer
+ *
+ *	Comments:	Single reader (LIN diagnostics); Constant-time, lock-free: The
+ *				entry at the tail is owned by the reader until the tail is
+ *				released; SetLastError() doesn't update it.
+ * ****************************************************************************	*/
+uint16 GetLastErrorEntry( PERR_LOG_ENTRY pEntry)
+{
+	uint16 u16Result = FALSE;
+	uint8 u8Tail = l_u8ErrorLogTail;
+
+	if ( u8Tail != l_u8ErrorLogHead )
+	{
+		*pEntry = l_aErrorLog[u8Tail & C_ERR_LOG_MASK];
+		l_u8ErrorLogTail = (uint8) (u8Tail + 1u);								/* Release entry */
+		u16Result = TRUE;
+	}
+	return ( u16Result );
+} /* End of GetLastErrorEntry() */
+
+/* ****************************************************************************	*
+ * GetLastError
+ *
+ *	Pre:		Nothing
+ *	Post:		Oldest error-code (C_ERR_NONE: Error-log empty)
+ * ****************************************************************************	*/
 uint8 GetLastError( void)
 {
-	uint8 u8Reply = l_au8FiFoErrorLog[0];
-	if ( l_u8ErrorLogIdx != 0u )
+	ERR_LOG_ENTRY sEntry;
+	sEntry.u8ErrorCode = (uint8) C_ERR_NONE;
+	(void) GetLastErrorEntry( &sEntry);
+	return ( sEntry.u8ErrorCode );
+} /* End of GetLastError() */
+
+#if (_DEBUG > 0u) && (_DEBUG_NVRAM_ERRORLOG > 0u)
+/* ****************************************************************************	*
+ * ErrorLog_MainFunction
+ *
+ *	Pre:		Nothing
+ *	Post:		Nothing
+ *
+ *	Comments:	Store the queued serious error-codes in NVRAM, out of interrupt
+ *				context: At most one NVRAM_LogError() per C_ERR_NVRAM_INTERVAL.
+ *				An error-code of the last C_ERR_NVRAM_QUEUE_SZ stores is not
+ *				stored again within C_ERR_NVRAM_DUP_WINDOW.
+ * ****************************************************************************	*/
+void ErrorLog_MainFunction( void)
+{
+	uint16 u16Now = g_u16TimerTicks;
+	uint16 u16Last = (uint8) (l_u8ErrorNvramRecentIdx - 1u) & C_ERR_NVRAM_MASK;
+
+	if ( (l_au8ErrorNvramRecent[u16Last] != (uint8) C_ERR_NONE) &&
+		 ((uint16) (u16Now - l_au16ErrorNvramRecentTime[u16Last]) < C_ERR_NVRAM_INTERVAL) )
 	{
-		uint16 i;
-		ATOMIC_CODE
-		(
-			for ( i = 1u; i < l_u8ErrorLogIdx; i++ )
+		return;																	/* Rate limit */
+	}
+	while ( l_u8ErrorNvramTail != l_u8ErrorNvramHead )
+	{
+		uint16 u16Idx;
+		uint8 u8ErrorCode = l_au8ErrorNvramQueue[l_u8ErrorNvramTail & C_ERR_NVRAM_MASK];
+		l_u8ErrorNvramTail++;													/* Release entry */
+		for ( u16Idx = 0u; u16Idx < C_ERR_NVRAM_QUEUE_SZ; u16Idx++ )
+		{
+			if ( (l_au8ErrorNvramRecent[u16Idx] == u8ErrorCode) &&
+				 ((uint16) (u16Now - l_au16ErrorNvramRecentTime[u16Idx]) < C_ERR_NVRAM_DUP_WINDOW) )
 			{
-				l_au8FiFoErrorLog[i - 1u] = l_au8FiFoErrorLog[i];
+				break;
 			}
-			l_u8ErrorLogIdx--;
-			l_au8FiFoErrorLog[l_u8ErrorLogIdx] = C_ERR_NONE;
-		);
+		}
+		if ( u16Idx == C_ERR_NVRAM_QUEUE_SZ )
+		{
+			(void) NVRAM_LogError( u8ErrorCode);
+			u16Idx = l_u8ErrorNvramRecentIdx & C_ERR_NVRAM_MASK;
+			l_au8ErrorNvramRecent[u16Idx] = u8ErrorCode;
+			l_au16ErrorNvramRecentTime[u16Idx] = u16Now;
+			l_u8ErrorNvramRecentIdx++;
+			break;
+		}
+		if ( g_u8ErrorNvramDropped != 0xFFu )
+		{
+			g_u8ErrorNvramDropped++;											/* Duplicate within window */
+		}
 	}
-	return ( u8Reply );
-} /* End of GetLastError() */
+} /* End of ErrorLog_MainFunction() */
+
+/* ****************************************************************************	*
+ * ErrorLog_Flush
+ *
+ *	Pre:		Nothing
+ *	Post:		Nothing
+ *
+ *	Comments:	Store all queued serious error-codes in NVRAM now, before a
+ *				reset or fatal stop; Returns after the programs are completed.
+ *				No rate limit nor duplicate window.
+ * ****************************************************************************	*/
+void ErrorLog_Flush( void)
+{
+	while ( l_u8ErrorNvramTail != l_u8ErrorNvramHead )
+	{
+		uint8 u8ErrorCode = l_au8ErrorNvramQueue[l_u8ErrorNvramTail & C_ERR_NVRAM_MASK];
+		l_u8ErrorNvramTail++;													/* Release entry */
+		(void) NVRAM_LogError( u8ErrorCode);
+	}
+	NVRAM_WaitReady();															/* NVRAM_LogError() doesn't wait */
+} /* End of ErrorLog_Flush() */
+#endif /* (_DEBUG > 0u) && (_DEBUG_NVRAM_ERRORLOG > 0u) */
 
 
 /* EOF */
@@ -25,6 +25,8 @@
 #define ERRORCODES_H_
 
 #include <syslib.h>
+#include "Build.h"
+#include "Timer.h"
 
 #define C_ERR_NONE				0x00
 											/* Unsupported MLX16 IRQ's */
@@ -124,12 +126,34 @@
 #define C_ERR_IOREG				0xFC		/* I/O-registers error */
 #define C_ERR_FATAL_EMRUN		0xFE		/* Fatal Emergency-run */
 
+#define C_ERR_LOG_SZ			16u			/* Error-log entries (power of 2, at least the 10 of the former FiFo) */
+
+typedef struct _ERR_LOG_ENTRY
+{
+	uint8 u8ErrorCode;									/* Error-code */
+	uint8 u8Count;										/* Occurrences (saturated at 0xFF) */
+	uint16 u16TimeStamp;								/* Tick-counter at the last occurrence */
+} ERR_LOG_ENTRY, *PERR_LOG_ENTRY;
+
+#if (_DEBUG > 0u) && (_DEBUG_NVRAM_ERRORLOG > 0u)
+#define C_ERR_NVRAM_QUEUE_SZ	4u			/* Serious errors pending for NVRAM (power of 2) */
+#define C_ERR_NVRAM_INTERVAL	(1u * PI_TICKS_PER_SECOND)	/* Minimum time between two NVRAM error-log stores */
+#define C_ERR_NVRAM_DUP_WINDOW	(30u * PI_TICKS_PER_SECOND)	/* Same error-code within window: Stored once */
+
+extern uint8 g_u8ErrorNvramDropped;
+#endif /* (_DEBUG > 0u) && (_DEBUG_NVRAM_ERRORLOG > 0u) */
+
 /* ****************************************************************************	*
  *	P u b l i c   f u n c t i o n s												*
  * ****************************************************************************	*/
 void ErrorLogInit( void );
 void SetLastError( uint8 u8ErrorCode );
 uint8 GetLastError( void );
+uint16 GetLastErrorEntry( PERR_LOG_ENTRY pEntry );
+#if (_DEBUG > 0u) && (_DEBUG_NVRAM_ERRORLOG > 0u)
+void ErrorLog_MainFunction( void );
+void ErrorLog_Flush( void );
+#endif /* (_DEBUG > 0u) && (_DEBUG_NVRAM_ERRORLOG > 0u) */
 
 #endif /* ERRORCODES_H_ */
 
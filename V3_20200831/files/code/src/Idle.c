@@ -0,0 +1,152 @@
+/*! ----------------------------------------------------------------------------
+ * \file		Idle.c
+ * \brief		MLX81310 Main-loop idle manager (tickless MLX16 HALT)
+ *
+ * \note		project MLX81310
+ *
+ * \author 		Marcel Braat
+ *
+ * \date 		2020-10-05
+ *
+ * \version 	1.0 - preliminary
+ *
+ * \functions	Idle_Init()
+ *				Idle_MainFunction()
+ *
+ * At the end of each main-loop pass, the MLX16 HALTs until the next
+ * interrupt, unless a received LIN frame or scheduler event is still to be
+ * handled (re-checked by Timer_Halt() with interrupts disabled):
+ * - Motor running: The commutation timer (EXT0_IT) and the core timer wake-up
+ *   the MLX16 within one tick;
+ * - Motor stopped: The core timer is reprogrammed up to the first software
+ *   timer deadline (Timer_GetIdleTicks()), at most C_IDLE_MAX_TICKS. Not
+ *   during C_IDLE_HOLDOFF_TICKS after motor activity or an early wake-up
+ *   (e.g. LIN frame), to keep the main-loop state-machine transitions within
+ *   one tick.
+ * - _SUPPORT_SCHEDULER: Not beyond the next rate group release.
+ * The HALT time is measured per window of C_IDLE_WINDOW_TICKS.
+ *
+ * MELEXIS Microelectronic Integrated Systems
+ *
+ * Copyright (C) 2020-2020 Melexis N.V.
+ * The Software is being delivered 'AS IS' and Melexis, whether explicitly or
+ * implicitly, makes no warranty as to its Use or performance.
+ * The user accepts the Melexis Firmware License Agreement.
+ *
+ * Melexis confidential & proprietary
+ * ****************************************************************************	*/
+
+#include "Build.h"
+
+#if _SUPPORT_MLX16_HALT
+
+#include "Idle.h"
+#include "Timer.h"
+#include "MotorDriver.h"
+#include "LIN_Communication.h"
+#include "Scheduler.h"
+#include "ADC.h"
+#include <mathlib.h>															/* Use Melexis math-library functions to avoid compiler warnings */
+
+/* ****************************************************************************	*
+ *	NORMAL FAR IMPLEMENTATION	( NEAR Memory Space >= 0x100)					*
+ * ****************************************************************************	*/
+#pragma space nodp																/* __NEAR_SECTION__ */
+uint8 g_u8IdlePercentage = 0u;													/* MLX16 HALT-time [%] of the last window */
+uint32 l_u32IdleTime = 0u;														/* HALT-time [us] of the current window */
+uint16 l_u16IdleWindowStart = 0u;												/* Tick-counter at start of the current window */
+uint16 l_u16IdleActive = 0u;													/* Tick-counter at last early wake-up or motor activity */
+#pragma space none																/* __NEAR_SECTION__ */
+
+/* ****************************************************************************	*
+ * Idle_IsBusy()
+ *
+ * Returns non-zero if main-loop work is pending (received LIN frame or
+ * scheduler event); Called by Timer_Halt() with interrupts disabled.
+ * ****************************************************************************	*/
+static uint16 Idle_IsBusy( void)
+{
+#if _SUPPORT_SCHEDULER
+	if ( g_u8SchedulerEvents != C_SCHED_EVENT_NONE )
+	{
+		return ( 1u );
+	}
+#endif /* _SUPPORT_SCHEDULER */
+	return ( (l_u8LinInFrameBufState != (uint8) C_LIN_IN_FREE) ? 1u : 0u );
+} /* End of Idle_IsBusy() */
+
+/* ****************************************************************************	*
+ * Idle_Init()
+ *
+ * Start the idle percentage measurement; Timer_Init() must be called first.
+ * ****************************************************************************	*/
+void Idle_Init( void)
+{
+	g_u8IdlePercentage = 0u;
+	l_u32IdleTime = 0u;
+	l_u16IdleWindowStart = g_u16TimerTicks;
+	l_u16IdleActive = g_u16TimerTicks;
+} /* End of Idle_Init() */
+
+/* ****************************************************************************	*
+ * Idle_MainFunction()
+ *
+ * HALT the MLX16 until the next event (interrupt or software timer deadline).
+ * ****************************************************************************	*/
+void Idle_MainFunction( void)
+{
+	uint16 u16Window;
+
+	if ( (l_u8LinInFrameBufState != (uint8) C_LIN_IN_FREE) || (g_u8MotorStartupMode != (uint8) MSM_STOP) )
+	{
+		l_u16IdleActive = g_u16TimerTicks;
+	}
+	if ( l_u8LinInFrameBufState == (uint8) C_LIN_IN_FREE )						/* No pending LIN work */
+	{
+		uint16 u16Ticks = 1u;													/* Next interrupt (commutation or tick) */
+		if ( (uint16) (g_u16TimerTicks - l_u16IdleActive) >= C_IDLE_HOLDOFF_TICKS )
+		{
+			u16Ticks = Timer_GetIdleTicks( C_IDLE_MAX_TICKS);					/* Next timer deadline */
+		}
+#if _SUPPORT_SCHEDULER
+		{
+			uint16 u16SchedTicks = Scheduler_GetIdleTicks();					/* Next rate group release */
+			if ( u16SchedTicks < u16Ticks )
+			{
+				u16Ticks = u16SchedTicks;
+			}
+		}
+#endif /* _SUPPORT_SCHEDULER */
+		if ( u16Ticks != 0u )
+		{
+			uint16 u16Start = g_u16TimerTicks;
+#if _SUPPORT_ADC_SNAPSHOT
+			uint16 u16AdcSeq = g_u16AdcSnapshotSeq;
+#endif /* _SUPPORT_ADC_SNAPSHOT */
+			l_u32IdleTime += Timer_Halt( u16Ticks, Idle_IsBusy);
+			if ( (u16Ticks > 1u) && ((uint16) (g_u16TimerTicks - u16Start) < u16Ticks) )
+			{
+#if _SUPPORT_ADC_SNAPSHOT
+				if ( g_u16AdcSnapshotSeq == u16AdcSeq )							/* Not woken-up by the ADC snapshot */
+#endif /* _SUPPORT_ADC_SNAPSHOT */
+				{
+					l_u16IdleActive = g_u16TimerTicks;							/* Woken-up by an event */
+				}
+			}
+		}
+	}
+
+	u16Window = (uint16) (g_u16TimerTicks - l_u16IdleWindowStart);
+	if ( u16Window >= C_IDLE_WINDOW_TICKS )
+	{
+		/* HALT [us] * 100% / (window [ticks] * CT_PERIODIC_RATE [us]) */
+		uint16 u16Percentage = divU16_U32byU16( l_u32IdleTime, (uint16) (u16Window * (CT_PERIODIC_RATE/100u)));
+		g_u8IdlePercentage = (u16Percentage > 100u) ? 100u : (uint8) u16Percentage;
+		l_u32IdleTime = 0u;
+		l_u16IdleWindowStart += u16Window;
+	}
+} /* End of Idle_MainFunction() */
+
+#endif /* _SUPPORT_MLX16_HALT */
+
+/* EOF */
@@ -0,0 +1,53 @@
+/*! \file		Idle.h
+ *  \brief		MLX81310 Main-loop idle manager (tickless MLX16 HALT)
+ *
+ * \note		project MLX81310
+ *
+ * \author 		Marcel Braat
+ *
+ * \date 		2020-10-05
+ *
+ * \version 	1.0 - preliminary
+ *
+ *
+ * MELEXIS Microelectronic Integrated Systems
+ *
+ * Copyright (C) 2020-2020 Melexis N.V.
+ * The Software is being delivered 'AS IS' and Melexis, whether explicitly or
+ * implicitly, makes no warranty as to its Use or performance.
+ * The user accepts the Melexis Firmware License Agreement.
+ *
+ * Melexis confidential & proprietary
+ *
+ * ****************************************************************************	*/
+
+#ifndef IDLE_H_
+#define IDLE_H_
+
+#include "Build.h"
+#include "Timer.h"
+
+#if _SUPPORT_MLX16_HALT
+
+#define C_IDLE_MAX_TICKS			(10u * PI_TICKS_PER_MILLISECOND)			/* Maximum HALT period: Main-loop diagnostics (Vs, temperature) at least each 10ms */
+#define C_IDLE_HOLDOFF_TICKS		(50u * PI_TICKS_PER_MILLISECOND)			/* No tickless HALT after an event or motor activity (state-machine transitions) */
+#define C_IDLE_WINDOW_TICKS			PI_TICKS_PER_SECOND							/* Idle percentage measurement window */
+
+/* ****************************************************************************	*
+ *	P u b l i c   v a r i a b l e s												*
+ * ****************************************************************************	*/
+#pragma space nodp																/* __NEAR_SECTION__ */
+extern uint8 g_u8IdlePercentage;												/*!< MLX16 HALT-time [%] of the last window */
+#pragma space none																/* __NEAR_SECTION__ */
+
+/* ****************************************************************************	*
+ *	P u b l i c   f u n c t i o n s												*
+ * ****************************************************************************	*/
+extern void Idle_Init( void);													/*!< Start the idle percentage measurement */
+extern void Idle_MainFunction( void);											/*!< HALT the MLX16 until the next event */
+
+#endif /* _SUPPORT_MLX16_HALT */
+
+#endif /* IDLE_H_ */
+
+/* EOF */
@@ -26,6 +26,7 @@
  *				AutoAddressingReadADCResult()
  *				ml_AutoAddressingCfgADC()
  *				ClearAAData()
+ *				ml_LinInterruptHandler()
  *				
  *
  * MELEXIS Microelectronic Integrated Systems
@@ -82,6 +83,8 @@
 #include <plib.h>
 
 #include "Timer.h"
+#include "Profiler.h"
+#include "Scheduler.h"
 #include "ErrorCodes.h"															/* Error-logging support */
 
 #include "NVRAM_UserPage.h"
@@ -387,6 +390,24 @@ void LIN_Init(void)
 	}
 } /* End of LIN_Init() */
 
+#if _SUPPORT_PROFILER
+/* ****************************************************************************	*
+ * ml_LinInterruptHandler()
+ *
+ * LIN (MLX4) event interrupt handler; Replaces the platform default handler
+ * to allow profiling of the LIN ISR. Same code placement (.mlx_text) as the
+ * platform handler.
+ * ****************************************************************************	*/
+__MLX_TEXT__ void __interrupt__ ml_LinInterruptHandler(void);
+__MLX_TEXT__ void ml_LinInterruptHandler(void)
+{
+	PROFILER_START();
+	ml_GetLinEventData();
+	ml_ProccessLinEvent();
+	PROFILER_STOP( PROFILE_LIN_IT);
+} /* End of ml_LinInterruptHandler() */
+#endif /* _SUPPORT_PROFILER */
+
 /* ****************************************************************************	*
  *  LIN API event: mlu_ApplicationStop
  * ****************************************************************************	*/
@@ -547,6 +568,9 @@ void mlu_MessageReceived( ml_MessageID MessageIndex)
 			*pu16Target = *pu16Source;
 		}
 		l_u8LinInFrameBufState = (uint8) C_LIN_IN_FULL;
+#if _SUPPORT_SCHEDULER
+		Scheduler_SetEvent( C_SCHED_EVENT_LIN);									/* Handle frame by LIN_MainFunction() */
+#endif /* _SUPPORT_SCHEDULER */
 	
 		LinFrame[0] = 0x00;														/* Clear NAD address */
 	}
@@ -84,6 +84,7 @@ extern uint8 g_u8NAD;
 extern uint8 g_u8ControlFrameID;
 extern uint8 g_u8StatusFrameID;
 extern uint8 g_u8BufferOutID;													/* LIN output buffer is invalid */
+extern uint8 l_u8LinInFrameBufState;											/* LIN input frame-buffer status (C_LIN_IN_xxx) */
 extern LININBUF g_LinCmdFrameBuffer;											/* (Copy of) LIN input frame-buffer */
 extern RFR_DIAG g_DiagResponse;                                                 /* diagnostic response buffer */
 
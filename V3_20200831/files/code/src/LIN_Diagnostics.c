@@ -43,6 +43,13 @@
 #include "ErrorCodes.h"															/* Error-logging support */
 
 #include "Timer.h"
+#include "Profiler.h"
+#if _SUPPORT_MLX16_HALT
+#include "Idle.h"																/* Idle percentage */
+#endif /* _SUPPORT_MLX16_HALT */
+#if _SUPPORT_SCHEDULER
+#include "Scheduler.h"															/* Task statistics */
+#endif /* _SUPPORT_SCHEDULER */
 #include "private_mathlib.h"
 #include <mathlib.h>															/* Use Melexis math-library functions to avoid compiler warnings */
 
@@ -152,6 +159,7 @@ uint16 ValidSupplierFunctionID( uint16 const u16SupplierID, uint16 const u16Func
 
 static __inline__ void StoreD1to2( uint16 a)
 {
+#ifdef __MLX16__
 	__asm__ __volatile__
 	(
 		"mov dp:_g_DiagResponse+3, AL\n\t"
@@ -159,12 +167,17 @@ static __inline__ void StoreD1to2( uint16 a)
 		:
 		: "a" (a)
 	);
+#else
+	g_DiagResponse.byD1 = (uint8) a;
+	g_DiagResponse.byD2 = (uint8) (a >> 8);
+#endif /* __MLX16__ */
 	g_u8BufferOutID = (uint8) QR_RFR_DIAG;									/* LIN Output buffer is valid (RFR_DIAG) */
 	return;
 } /* End of StoreD1to2() */
 
 static __inline__ void StoreD1to4( uint16 a, uint16 b)
 {
+#ifdef __MLX16__
 	__asm__ __volatile__
 	(
 		"mov dp:_g_DiagResponse+3, AL\n\t"
@@ -174,12 +187,19 @@ static __inline__ void StoreD1to4( uint16 a, uint16 b)
 		:
 		: "b" (a), "y" (b)
 	);
+#else
+	g_DiagResponse.byD1 = (uint8) a;
+	g_DiagResponse.byD2 = (uint8) (a >> 8);
+	g_DiagResponse.byD3 = (uint8) b;
+	g_DiagResponse.byD4 = (uint8) (b >> 8);
+#endif /* __MLX16__ */
 	g_u8BufferOutID = (uint8) QR_RFR_DIAG;									/* LIN Output buffer is valid (RFR_DIAG) */
 	return;
 } /* End of StoreD1to4() */
 
 static __inline__ void StoreD2to5( uint16 a, uint16 b)
 {
+#ifdef __MLX16__
 	__asm__ __volatile__
 	(
 		"mov dp:_g_DiagResponse+4, AL\n\t"
@@ -189,6 +209,12 @@ static __inline__ void StoreD2to5( uint16 a, uint16 b)
 		:
 		: "b" (a), "y" (b)
 	);
+#else
+	g_DiagResponse.byD2 = (uint8) a;
+	g_DiagResponse.byD3 = (uint8) (a >> 8);
+	g_DiagResponse.byD4 = (uint8) b;
+	g_DiagResponse.byD5 = (uint8) (b >> 8);
+#endif /* __MLX16__ */
 	g_u8BufferOutID = (uint8) QR_RFR_DIAG;									/* LIN Output buffer is valid (RFR_DIAG) */
 	return;
 } /* End of StoreD2to5() */
@@ -612,6 +638,9 @@ void handleDataDump(const DFR_DIAG *pDiag)
 void handleTargetReset(const DFR_DIAG *pDiag)
 {
 	/* Reset Target */
+#if (_DEBUG > 0u) && (_DEBUG_NVRAM_ERRORLOG > 0u)
+	ErrorLog_Flush();													/* Queued error-codes */
+#endif /* (_DEBUG > 0u) && (_DEBUG_NVRAM_ERRORLOG > 0u) */
 	MLX4_RESET();														/* Reset the Mlx4	*/
 	bistResetInfo = C_CHIP_STATE_LIN_CMD_RESET;
 	MLX16_RESET();														/* Reset the Mlx16	*/
@@ -896,6 +925,7 @@ void handleMLXDebug(const DFR_DIAG *pDiag)
 		 * -0xAC: ADC Temperature/Voltage sensor (raw)
 		 * -0xAE: Ambient-environment: Temperature, S/W Build ID
 		 * -0xAF: Get PWM-IN Period & Low-Time (_SHRINK_CODE_SIZE == FALSE)
+		 * 0xB0: Get ISR/Task execution-time profile (_SUPPORT_PROFILER == TRUE)
 		 * 0xC0: Get CPU-clock (MMP140527-1)
 		 * 0xC1: Get Chip-ID
 		 * 0xC2: Get HW/SW-ID of chip
@@ -939,6 +969,163 @@ void handleMLXDebug(const DFR_DIAG *pDiag)
 			uint16 u16Index = (uint16) (pDiag->byD3 & 0x0F);
 			StoreD1to2( tMlxDbgSupport[u16Index]);
 		}																/* MMP140519-2 - End */
+#if _SUPPORT_PROFILER
+		else if ( pDiag->byD5 == (uint8) C_DBG_SUBFUNC_PROFILER )
+		{
+			/* Get ISR/Task execution-time profile [CPU-cycles]
+			 *	+-----+-----+------+----------+----------+----------+----------+----------+
+			 *	| NAD | PCI |  SID |	D1	  |    D2	 |	  D3	|	 D4    |	D5	  |
+			 *	+-----+-----+------+----------+----------+----------+----------+----------+
+			 *	| NAD | 0x06| Debug| Supplier | Supplier | Profile  |  Request |   FUNC   |
+			 *	|	  | 	| 0xDB | ID (LSB) | ID (MSB) |	 ID 	|  0,1,2   |   0xB0   |
+			 *	+-----+-----+------+----------+----------+----------+----------+----------+
+			 * Response (Request = 0: Min/Max, 1: Mean/Count, 2: Clear (0xFF: All))
+			 *	+-----+-----+------+----------+----------+----------+----------+----------+
+			 *	| NAD | PCI | RSID |	D1	  |    D2	 |	  D3	|	 D4    |	D5	  |
+			 *	+-----+-----+------+----------+----------+----------+----------+----------+
+			 *	| NAD | 0x06| 0xDB | Profile  | Min/Mean | Min/Mean |Max/Count |Max/Count |
+			 *	|	  | 	|	   |	ID	  |   (LSB)  |	 (MSB)	|   (LSB)  |   (MSB)  |
+			 *	+-----+-----+------+----------+----------+----------+----------+----------+
+			 */
+			uint16 u16ProfileID = (uint16) pDiag->byD3;
+			if ( pDiag->byD4 == (uint8) C_DBG_PROFILER_CLEAR )
+			{
+				Profiler_Clear( u16ProfileID);
+				g_DiagResponse.byD1 = pDiag->byD3;
+				StoreD2to5( 0u, 0u);
+			}
+			else if ( u16ProfileID < (uint16) MAX_PROFILE )
+			{
+				PROFILE_DATA sProfileData;
+				Profiler_Get( u16ProfileID, &sProfileData);
+				g_DiagResponse.byD1 = pDiag->byD3;
+				if ( pDiag->byD4 == (uint8) C_DBG_PROFILER_MINMAX )
+				{
+					StoreD2to5( sProfileData.u16Min, sProfileData.u16Max);
+				}
+				else
+				{
+					uint16 u16Mean = 0u;
+					if ( sProfileData.u16Count != 0u )
+					{
+						u16Mean = divU16_U32byU16( sProfileData.u32Sum, sProfileData.u16Count);
+					}
+					StoreD2to5( u16Mean, sProfileData.u16Count);
+				}
+			}
+			else
+			{
+				SetupDiagResponse( g_u8NAD, pDiag->bySID, (uint8) C_ERRCODE_SFUNC_NOSUP);	/* Status = Negative feedback */
+			}
+		}
+#endif /* _SUPPORT_PROFILER */
+#if _SUPPORT_NVRAM_WRITE_BACK
+		else if ( pDiag->byD5 == (uint8) C_DBG_SUBFUNC_NVRAM_CACHE )
+		{
+			/* Get NVRAM write-back cache statistics
+			 *	+-----+-----+------+----------+----------+----------+----------+----------+
+			 *	| NAD | PCI |  SID |	D1	  |    D2	 |	  D3	|	 D4    |	D5	  |
+			 *	+-----+-----+------+----------+----------+----------+----------+----------+
+			 *	| NAD | 0x06| Debug| Supplier | Supplier | Reserved |  Request |   FUNC   |
+			 *	|	  | 	| 0xDB | ID (LSB) | ID (MSB) |	 0xFF	|  0,1,2   |   0xB1   |
+			 *	+-----+-----+------+----------+----------+----------+----------+----------+
+			 * Response (Request = 0: Writes/Commits, 1: Max. commit delay [ticks], 2: Flush)
+			 *	+-----+-----+------+----------+----------+----------+----------+----------+
+			 *	| NAD | PCI | RSID |	D1	  |    D2	 |	  D3	|	 D4    |	D5	  |
+			 *	+-----+-----+------+----------+----------+----------+----------+----------+
+			 *	| NAD | 0x06| 0xDB |  Dirty   |  Writes/ |  Writes/ | Commits  | Commits  |
+			 *	|	  | 	|	   |  pages   | Delay(L) | Delay(H) |   (LSB)  |   (MSB)  |
+			 *	+-----+-----+------+----------+----------+----------+----------+----------+
+			 */
+			NVRAM_CACHE_STATS sCacheStats;
+			if ( pDiag->byD4 == (uint8) C_DBG_NVRAM_CACHE_FLUSH )
+			{
+				NVRAM_Flush();
+			}
+			NVRAM_GetCacheStats( &sCacheStats);
+			g_DiagResponse.byD1 = g_u8NvramDirtyPages;
+			if ( pDiag->byD4 == (uint8) C_DBG_NVRAM_CACHE_DIRTY )
+			{
+				StoreD2to5( sCacheStats.u16MaxDirtyTicks, sCacheStats.u16Commits);
+			}
+			else
+			{
+				StoreD2to5( sCacheStats.u16Writes, sCacheStats.u16Commits);
+			}
+		}
+#endif /* _SUPPORT_NVRAM_WRITE_BACK */
+#if _SUPPORT_MLX16_HALT
+		else if ( pDiag->byD5 == (uint8) C_DBG_SUBFUNC_IDLE )
+		{
+			/* Get main-loop idle manager statistics
+			 *	+-----+-----+------+----------+----------+----------+----------+----------+
+			 *	| NAD | PCI |  SID |	D1	  |    D2	 |	  D3	|	 D4    |	D5	  |
+			 *	+-----+-----+------+----------+----------+----------+----------+----------+
+			 *	| NAD | 0x06| Debug| Supplier | Supplier | Reserved | Reserved |   FUNC   |
+			 *	|	  | 	| 0xDB | ID (LSB) | ID (MSB) |	 0xFF	|	0xFF   |   0xB2   |
+			 *	+-----+-----+------+----------+----------+----------+----------+----------+
+			 * Response
+			 *	+-----+-----+------+----------+----------+----------+----------+----------+
+			 *	| NAD | PCI | RSID |	D1	  |    D2	 |	  D3	|	 D4    |	D5	  |
+			 *	+-----+-----+------+----------+----------+----------+----------+----------+
+			 *	| NAD | 0x06| 0xDB |  HALT-   |  Window  |  Window  | Max.HALT | Max.HALT |
+			 *	|	  | 	|	   | time [%] | [ms](LSB)| [ms](MSB)| [ms](LSB)| [ms](MSB)|
+			 *	+-----+-----+------+----------+----------+----------+----------+----------+
+			 */
+			g_DiagResponse.byD1 = g_u8IdlePercentage;
+			StoreD2to5( (uint16) (C_IDLE_WINDOW_TICKS / PI_TICKS_PER_MILLISECOND), (uint16) (C_IDLE_MAX_TICKS / PI_TICKS_PER_MILLISECOND));
+		}
+#endif /* _SUPPORT_MLX16_HALT */
+#if _SUPPORT_SCHEDULER
+		else if ( pDiag->byD5 == (uint8) C_DBG_SUBFUNC_SCHEDULER )
+		{
+			/* Get main-loop scheduler task statistics
+			 *	+-----+-----+------+----------+----------+----------+----------+----------+
+			 *	| NAD | PCI |  SID |	D1	  |    D2	 |	  D3	|	 D4    |	D5	  |
+			 *	+-----+-----+------+----------+----------+----------+----------+----------+
+			 *	| NAD | 0x06| Debug| Supplier | Supplier | Task/    |  Request |   FUNC   |
+			 *	|	  | 	| 0xDB | ID (LSB) | ID (MSB) | Group ID |  0,1,2   |   0xB3   |
+			 *	+-----+-----+------+----------+----------+----------+----------+----------+
+			 * Response (Request = 0: Runs/Max.ticks, 1: Max.cycles/Task overruns, 2: Group overruns)
+			 *	+-----+-----+------+----------+----------+----------+----------+----------+
+			 *	| NAD | PCI | RSID |	D1	  |    D2	 |	  D3	|	 D4    |	D5	  |
+			 *	+-----+-----+------+----------+----------+----------+----------+----------+
+			 *	| NAD | 0x06| 0xDB | Task/    | Runs/Max | Runs/Max | Max/Over-| Max/Over-|
+			 *	|	  | 	|	   | Group ID | cyc.(LSB)| cyc.(MSB)| runs(LSB)| runs(MSB)|
+			 *	+-----+-----+------+----------+----------+----------+----------+----------+
+			 * Max.cycles is 0xFFFF without the profiler (Timer2) or in case longer
+			 * than C_SCHED_CYCLES_MAX_TICKS.
+			 */
+			uint16 u16ID = (uint16) pDiag->byD3;
+			if ( (pDiag->byD4 == (uint8) C_DBG_SCHED_GROUP_OVERRUNS) && (u16ID < (uint16) C_SCHED_MAX_GROUP) )
+			{
+				g_DiagResponse.byD1 = pDiag->byD3;
+				StoreD2to5( (uint16) g_au8SchedulerGroupOverruns[u16ID], 0u);
+			}
+			else if ( (pDiag->byD4 != (uint8) C_DBG_SCHED_GROUP_OVERRUNS) && (u16ID < (uint16) MAX_SCHED_TASK) )
+			{
+				SCHED_DATA sSchedData;
+				Scheduler_Get( u16ID, &sSchedData);
+				g_DiagResponse.byD1 = pDiag->byD3;
+				if ( pDiag->byD4 == (uint8) C_DBG_SCHED_COUNT_TICKS )
+				{
+					StoreD2to5( sSchedData.u16Count, sSchedData.u16MaxTicks);
+				}
+				else
+				{
+#if _SUPPORT_PROFILER
+					StoreD2to5( sSchedData.u16MaxCycles, (uint16) sSchedData.u8Overruns);
+#else  /* _SUPPORT_PROFILER */
+					StoreD2to5( 0xFFFFu, (uint16) sSchedData.u8Overruns);
+#endif /* _SUPPORT_PROFILER */
+				}
+			}
+			else
+			{
+				SetupDiagResponse( g_u8NAD, pDiag->bySID, (uint8) C_ERRCODE_SFUNC_NOSUP);	/* Status = Negative feedback */
+			}
+		}
+#endif /* _SUPPORT_SCHEDULER */
 		else if ( pDiag->byD5 == (uint8) C_DBG_SUBFUNC_MLX16_CLK )		/* MMP140527-1 - Begin */
 		{
 			/* Get MLX16 Clock
@@ -1048,7 +1235,7 @@ void handleMLXDebug(const DFR_DIAG *pDiag)
 #endif /* _SUPPORT_TESTMODE_OFF */
 
 #if _SUPPORT_MLX16_HALT
-											& ~(1U << 6)				/* bit 6: MLX16 enters HALT during holding mode (power-safe) support */
+											& ~(1U << 6)				/* bit 6: MLX16 HALTs in the main-loop until the next event (idle manager, tickless) support */
 #endif /* _SUPPORT_MLX16_HALT */
 
 #if _SUPPORT_CHIP_TEMP_PROFILE
@@ -1269,6 +1456,9 @@ void handleMLXDebug(const DFR_DIAG *pDiag)
 			{
 				/* Function ID = Chip reset */
 				(void) mlu_ApplicationStop();
+#if (_DEBUG > 0u) && (_DEBUG_NVRAM_ERRORLOG > 0u)
+				ErrorLog_Flush();										/* Queued error-codes */
+#endif /* (_DEBUG > 0u) && (_DEBUG_NVRAM_ERRORLOG > 0u) */
 				MLX4_RESET();											/* Reset the Mlx4	*/
 				bistResetInfo = C_CHIP_STATE_LIN_CMD_RESET;
 				MLX16_RESET();											/* Reset the Mlx16	*/
@@ -1318,6 +1508,7 @@ extern uint16 stack;
 			 */
 			uint8 u8NvramID = pDiag->byD3;
 			uint16 u16Pattern = (((uint16) pDiag->byD4) << 8) | ((uint16) pDiag->byD4);
+			NVRAM_WaitReady();											/* Shadow-RAM of a page being programmed */
 			if ( u8NvramID & 0x01 )
 			{
 				/* Fill NVRAM #1, 1 */
@@ -1451,15 +1642,39 @@ void handleReadErrorCodes(const DFR_DIAG *pDiag)
 	 *	+-----+-----+------+----------+----------+----------+----------+----------+
 	 *	| NAD | 0x06| 0xEC | Error[0] | Error[1] | Error[2] | Error[3] | Error[4] |
 	 *	+-----+-----+------+----------+----------+----------+----------+----------+
+	 *
+	 * Error-log entry (D1 = C_ERR_SUBFUNC_ENTRY)
+	 *	+-----+-----+------+----------+----------+----------+----------+----------+
+	 *	| NAD | PCI | RSID |    D1    |    D2    |    D3    |    D4    |    D5    |
+	 *	+-----+-----+------+----------+----------+----------+----------+----------+
+	 *	| NAD | 0x06| 0xEC | Error[0] |  Count   |TimeStamp |TimeStamp | Reserved |
+	 *	|     |     |      |          |          |  (LSB)   |  (MSB)   |          |
+	 *	+-----+-----+------+----------+----------+----------+----------+----------+
 	 */
 	g_DiagResponse.byNAD = g_u8NAD;
 	g_DiagResponse.byPCI = 0x06;
 	g_DiagResponse.byRSID = (uint8) C_SID_MLX_ERROR_CODES;
-	g_DiagResponse.byD1 = GetLastError();													/* Oldest Error-code */
-	g_DiagResponse.byD2 = GetLastError();
-	g_DiagResponse.byD3 = GetLastError();
-	g_DiagResponse.byD4 = GetLastError();
-	g_DiagResponse.byD5 = GetLastError();
+	if ( pDiag->byD1 == (uint8) C_ERR_SUBFUNC_ENTRY )
+	{
+		ERR_LOG_ENTRY sEntry;
+		sEntry.u8ErrorCode = (uint8) C_ERR_NONE;
+		sEntry.u8Count = 0u;
+		sEntry.u16TimeStamp = 0u;
+		(void) GetLastErrorEntry( &sEntry);													/* Oldest Error-log entry */
+		g_DiagResponse.byD1 = sEntry.u8ErrorCode;
+		g_DiagResponse.byD2 = sEntry.u8Count;
+		g_DiagResponse.byD3 = (uint8) (sEntry.u16TimeStamp & 0xFFu);
+		g_DiagResponse.byD4 = (uint8) (sEntry.u16TimeStamp >> 8);
+		g_DiagResponse.byD5 = 0xFFu;
+	}
+	else
+	{
+		g_DiagResponse.byD1 = GetLastError();												/* Oldest Error-code */
+		g_DiagResponse.byD2 = GetLastError();
+		g_DiagResponse.byD3 = GetLastError();
+		g_DiagResponse.byD4 = GetLastError();
+		g_DiagResponse.byD5 = GetLastError();
+	}
 
 	g_u8BufferOutID = (uint8) QR_RFR_DIAG;													/* LIN Output buffer is valid (RFR_DIAG) */
 }
@@ -1584,6 +1799,9 @@ void handleMLXEEStore(const DFR_DIAG *pDiag)
 		if ( (pDiag->byD2 != 0xFFu) && ((pDiag->byD2 & C_NVRAM_USER_PAGE_RESET) != 0u) )
 		{
 			(void) mlu_ApplicationStop();
+#if (_DEBUG > 0u) && (_DEBUG_NVRAM_ERRORLOG > 0u)
+			ErrorLog_Flush();											/* Queued error-codes */
+#endif /* (_DEBUG > 0u) && (_DEBUG_NVRAM_ERRORLOG > 0u) */
 			MLX4_RESET();												/* Reset the Mlx4   */
 			MLX16_RESET();												/* Reset the Mlx16  */
 		}
@@ -116,7 +116,27 @@
 #define C_SID_MLX_DEBUG								0xDBU		/* Debug Support */
 #define C_DBG_SUBFUNC_SUPPORT						0x00U		/* Support 0xA0-0xFE (MMP140519-2) */
 #define C_DBG_SUBFUNC_SUPPORT_A						0xD0FF		/* F, E, C, 7, 6, 5, 4, 3, 2, 1, 0 */
-#define C_DBG_SUBFUNC_SUPPORT_B						0x0000		/* - */
+#if _SUPPORT_PROFILER
+#define C_DBG_SUBFUNC_SUPPORT_B0					0x0001		/* 0 */
+#else  /* _SUPPORT_PROFILER */
+#define C_DBG_SUBFUNC_SUPPORT_B0					0x0000
+#endif /* _SUPPORT_PROFILER */
+#if _SUPPORT_NVRAM_WRITE_BACK
+#define C_DBG_SUBFUNC_SUPPORT_B1					0x0002		/* 1 */
+#else  /* _SUPPORT_NVRAM_WRITE_BACK */
+#define C_DBG_SUBFUNC_SUPPORT_B1					0x0000
+#endif /* _SUPPORT_NVRAM_WRITE_BACK */
+#if _SUPPORT_MLX16_HALT
+#define C_DBG_SUBFUNC_SUPPORT_B2					0x0004		/* 2 */
+#else  /* _SUPPORT_MLX16_HALT */
+#define C_DBG_SUBFUNC_SUPPORT_B2					0x0000
+#endif /* _SUPPORT_MLX16_HALT */
+#if _SUPPORT_SCHEDULER
+#define C_DBG_SUBFUNC_SUPPORT_B3					0x0008		/* 3 */
+#else  /* _SUPPORT_SCHEDULER */
+#define C_DBG_SUBFUNC_SUPPORT_B3					0x0000
+#endif /* _SUPPORT_SCHEDULER */
+#define C_DBG_SUBFUNC_SUPPORT_B						(C_DBG_SUBFUNC_SUPPORT_B0 | C_DBG_SUBFUNC_SUPPORT_B1 | C_DBG_SUBFUNC_SUPPORT_B2 | C_DBG_SUBFUNC_SUPPORT_B3)
 #define C_DBG_SUBFUNC_SUPPORT_C						0xFF87		/* F, E, D, C, B, A, 9, 8, 7, 2, 1, 0 */
 #define C_DBG_SUBFUNC_SUPPORT_D						0xC0FF		/* F, E, (C), (B), 7, 6, 5, 4, 3, 2, 1, 0 */
 #define C_DBG_SUBFUNC_SUPPORT_E						0x0001		/* 0 */
@@ -133,6 +153,19 @@
 #define C_DBG_SUBFUNC_ADC_RAW						0xACU		/* ADC Temperature & voltage (raw) */
 #define C_DBG_SUBFUNC_AMBJENV						0xAEU		/* Ambient Environment */
 #define C_DBG_SUBFUNC_PWM_IN						0xAFU		/* PWM-In period & duty-cycle */
+#define C_DBG_SUBFUNC_PROFILER						0xB0U		/* ISR/Task execution-time profiler */
+#define C_DBG_PROFILER_MINMAX						0x00U		/* Profiler: Get minimum & maximum time */
+#define C_DBG_PROFILER_MEAN_COUNT					0x01U		/* Profiler: Get mean time & count */
+#define C_DBG_PROFILER_CLEAR						0x02U		/* Profiler: Clear statistics */
+#define C_DBG_SUBFUNC_NVRAM_CACHE					0xB1U		/* NVRAM write-back cache */
+#define C_DBG_NVRAM_CACHE_STATS						0x00U		/* NVRAM cache: Get writes & commits */
+#define C_DBG_NVRAM_CACHE_DIRTY						0x01U		/* NVRAM cache: Get longest commit delay */
+#define C_DBG_NVRAM_CACHE_FLUSH						0x02U		/* NVRAM cache: Commit changes now */
+#define C_DBG_SUBFUNC_IDLE							0xB2U		/* Main-loop idle manager (MLX16 HALT-time) */
+#define C_DBG_SUBFUNC_SCHEDULER						0xB3U		/* Main-loop scheduler task statistics */
+#define C_DBG_SCHED_COUNT_TICKS						0x00U		/* Scheduler: Get runs & maximum time [ticks] */
+#define C_DBG_SCHED_CYCLES_OVERRUNS					0x01U		/* Scheduler: Get maximum time [CPU-cycles] & task overruns */
+#define C_DBG_SCHED_GROUP_OVERRUNS					0x02U		/* Scheduler: Get rate group missed releases */
 #define C_DBG_SUBFUNC_MLX16_CLK						0xC0U		/* MLX16 Clock (MMP140527-1) */
 #define C_DBG_SUBFUNC_CHIPID						0xC1U		/* Chip ID */
 #define C_DBG_SUBFUNC_HWSWID						0xC2U		/* HW/SW ID */
@@ -171,6 +204,7 @@
 #define C_DBG_SUBFUNC_GET_IO_REG					0xFDU		/* Read I/O-register */
 #define C_DBG_SUBFUNC_FATAL_ERRORCODES				0xFEU		/* Fatal-error logging */
 #define C_SID_MLX_ERROR_CODES						0xECU		/* Error Logging */
+#define C_ERR_SUBFUNC_ENTRY							0x01U		/* Oldest error-log entry, with occurrence count and time-stamp */
 #define C_SID_MLX_EE_PATCH							0xEDU		/* EEPROM/NVRAM Patch Read/Write */
 #define C_SID_MLX_EE_USERPG1						0xEEU		/* EEPROM/NVRAM UserPage #1 Read/Write */
 #define C_SID_MLX_EE_STORE							0xEFU		/* EEPROM/NVRAM Store into */
@@ -14,11 +14,15 @@
  *				MotorDriverSelfTest()
  *				MotorDriverCurrentMeasureInit()
  *				MotorDriverCurrentMeasure()
+ *				MotorDriver_PwmDutyCycleRatio()
  *				MotorDriver_InitialPwmDutyCycle()
  *				MotorDriver_4PhaseStepper()
+ *				MotorDriverRampTableInit()
  *				MotorDriverStart()
+ *				MotorDriverReverse()
  *				MotorDriverStop()
  *				Commutation_ISR()
+ *				Commutation_BottomHalf_ISR()
  *
  * MELEXIS Microelectronic Integrated Systems
  * 
@@ -47,6 +51,7 @@
 #include "NVRAM_UserPage.h"														/* NVRAM User-page support */
 #include "PID_Control.h"														/* PID-controller support */
 #include "Timer.h"																/* Periodic IRQ Timer support */
+#include "Profiler.h"
 #include "private_mathlib.h"
 #include <mathlib.h>															/* Use Melexis math-library functions to avoid compiler warnings */
 #include "lib_mlx315_misc.h"
@@ -56,8 +61,14 @@
  * ****************************************************************************	*/
 #pragma space dp
 uint8 l_u8VTIdx = 0u;
+#if _SUPPORT_USTEP_ADAPTIVE
+uint16 l_u16MicroStepStride = 1u;												/* Micro-steps per commutation (1, 2, 4 .. full-step) */
+#endif /* _SUPPORT_USTEP_ADAPTIVE */
 volatile uint16 g_u16CorrectionRatio;											/* Motor correction ratio, depend on temperature and voltage */
 uint16 g_u16MicroStepIdx;														/* (Micro)step index */
+#if _SUPPORT_HALL_TMR2_CAPTURE
+uint16 g_u16CommutTimeStamp;													/* Timer2 time-stamp of the last commutation */
+#endif /* _SUPPORT_HALL_TMR2_CAPTURE */
 uint16 g_u16CommutTimerPeriod;													/* Commutation timer period */
 uint16 g_u16TargetCommutTimerPeriod;											/* Target commutation timer period (target speed) */
 uint16 g_u16StartupDelay = 2u * C_MOVAVG_SZ;
@@ -90,6 +101,10 @@ volatile Motor_FaultStatus g_sMotorFault =
 /* MMP151118-2 */
 #pragma space none
 
+#if _SUPPORT_USTEP_ADAPTIVE && (_SUPPORT_RAMP_TABLE == FALSE)
+#error "ERROR: _SUPPORT_USTEP_ADAPTIVE requires _SUPPORT_RAMP_TABLE."
+#endif
+
 /* ****************************************************************************	*
  *	NORMAL FAR IMPLEMENTATION	( NEAR Memory Space >= 0x100)					*
  * ****************************************************************************	*/
@@ -121,9 +136,27 @@ uint8 g_u8ValveInitState = 0;
 uint16 g_u16falg = 0;
 uint16 g_u16PosFlag = 0;
 
-#if (USE_MULTI_PURPOSE_BUFFER == FALSE)
-uint16 l_au16VelocityTimer[VT_BUF_SZ];
-#endif /* (USE_MULTI_PURPOSE_BUFFER == FALSE) */
+#if _SUPPORT_SEAMLESS_REVERSAL
+volatile uint8 l_u8ReversalPending = FALSE;										/* Change of direction at the turning-point (g_u16ActuatorTgtPos) */
+volatile uint16 l_u16ReversalTgtPos;											/* Target-position after the turning-point */
+uint16 l_u16ReversalPidCtrlRatio;												/* PWM duty-cycle ratios after the turning-point (pre-calculated) */
+uint16 l_u16ReversalCorrectionRatio;
+#endif /* _SUPPORT_SEAMLESS_REVERSAL */
+
+#if _SUPPORT_COMMUT_BOTTOM_HALF
+uint8 l_u8CommutBottomHalfPending = FALSE;										/* Commutation bottom-half requested, not yet handled */
+uint16 g_u16CommutBottomHalfOverrun = 0u;										/* Number of commutations with bottom-half still pending */
+#endif /* _SUPPORT_COMMUT_BOTTOM_HALF */
+
+#if _SUPPORT_RAMP_TABLE
+uint16 l_au16VelocityTimer[VT_BUF_SZ];											/* Acceleration table: commutation-timer period per l_u8VTIdx */
+uint8 l_u8VTIdxMax;																/* Last valid l_au16VelocityTimer[] index */
+uint16 l_u16VTSpeedRPM;															/* Motor-speed at l_au16VelocityTimer[l_u8VTIdxMax] */
+#if _SUPPORT_RAMP_SCURVE
+volatile uint8 l_u8VTIdxCapped = FALSE;											/* Table ends below target speed because of the move distance */
+volatile uint8 l_u8VTReplan = FALSE;											/* Turning-point passed: Table to be planned for the new move */
+#endif /* _SUPPORT_RAMP_SCURVE */
+#endif /* _SUPPORT_RAMP_TABLE */
 
 #if _DEBUG_MOTOR_CURRENT_FLT
 uint8 l_au8MotorCurrRaw[C_MOTOR_CURR_SZ];										/* Raw (un-filtered) motor current measurement */
@@ -234,12 +267,20 @@ const MOTOR_CALIBPARAMS MotorCalibParamsDefault =
 /* ****************************************************************************	*
  *	local functions declaration												*
  * ****************************************************************************	*/
+void MotorDriverRampTableInit( void );
 void MotorDriverStart( void );
+#if _SUPPORT_SEAMLESS_REVERSAL
+void MotorDriverReverse( uint16 u16TgtPos );
+#endif /* _SUPPORT_SEAMLESS_REVERSAL */
 void MotorDriverStop( uint16 u16Immediate );
 void MotorDriver_InitialPwmDutyCycle( uint16 u16CurrentLevel, uint16 u16MotorSpeed );
+void MotorDriver_PwmDutyCycleRatio( uint16 u16CurrentLevel, uint16 u16MotorSpeed, uint16 *pu16PidCtrlRatio, uint16 *pu16CorrectionRatio );
 void MotorDriverCurrentMeasureInit( void );
 void MotorDriverCurrentMeasure( void );
 void MotorDriver_4PhaseStepper( void );
+#if (_SUPPORT_COMMUT_BOTTOM_HALF == FALSE)
+extern void _fatal (void);
+#endif /* (_SUPPORT_COMMUT_BOTTOM_HALF == FALSE) */
 
 
 /* public functions implementation */
@@ -286,6 +327,9 @@ void MotorDriver_MainFunction(void)
 {
 	/* Diagnostic */
 	MotorDiagnosticVsupplyAndTemperature();
+#if _SUPPORT_VOLTAGE_CORR_SCALE
+	VoltageCorrectionScale();													/* Vref/Vsm for the commutation ISR */
+#endif /* _SUPPORT_VOLTAGE_CORR_SCALE */
 
 	/* Diagnostic protection:motor transfer to degrade mode */
 	if((g_sMotorFault.UV != 0u) || (g_sMotorFault.OV != 0u) || 
@@ -309,6 +353,9 @@ void MotorDriver_MainFunction(void)
 				PID_Control();													/* PID-control (Current) */
 				Timer_Start(PID_CTRL_TIMER,(uint16)NVRAM_PID_RUNNINGCTRL_PER);
 			}
+#if _SUPPORT_LOAD_ADAPTIVE_CURRENT
+			LoadAdaptiveCurrentControl();										/* Running current based on hall-edge rotor-lag */
+#endif /* _SUPPORT_LOAD_ADAPTIVE_CURRENT */
 			/* update target speed,may be overwitten by ISR */
 			{
 				uint32 u32Temp;
@@ -317,6 +364,12 @@ void MotorDriver_MainFunction(void)
 				g_u16MotorSpeedRPS = divU16_U32byU16( (uint32)(uint16)(l_u16ActuatorBufferedSpdRPM + 30U), 60U);
 				g_u16TargetCommutTimerPeriod = divU16_U32byU16( u32Temp, l_u16ActuatorBufferedSpdRPM) - 1U;	
 			}
+#if _SUPPORT_RAMP_SCURVE && _SUPPORT_SEAMLESS_REVERSAL
+			if ( l_u8VTReplan != FALSE )
+			{
+				MotorDriverRampTableInit();										/* Distance from the turning-point to the new target-position */
+			}
+#endif /* _SUPPORT_RAMP_SCURVE && _SUPPORT_SEAMLESS_REVERSAL */
 			/* need change new direction? */
 			if(l_u8MotorRequest == C_MOTOR_CTRL_START)
 			{
@@ -326,12 +379,26 @@ void MotorDriver_MainFunction(void)
 				/* update new target position:commutation if direction inversed with current direction */
 				if ( u8NewMotorDirectionCCW != g_e8MotorDirectionCCW )
 		     	{
+#if _SUPPORT_SEAMLESS_REVERSAL
+					/* Changing direction; Ramp-down and reverse at the turning-point */
+					MotorDriverReverse( l_u16ActuatorBufferedTgtPos);
+#else  /* _SUPPORT_SEAMLESS_REVERSAL */
 		        	/* Changing direction; Stop motor first before starting in opposite direction */
 		        	MotorDriverStop( (uint16) C_STOP_RAMPDOWN);					/* Change of direction */
+#endif /* _SUPPORT_SEAMLESS_REVERSAL */
 		       	}
 				else
 				{
 					/* only update target position */
+#if _SUPPORT_SEAMLESS_REVERSAL
+					l_u8ReversalPending = FALSE;								/* Cancel a pending change of direction */
+#endif /* _SUPPORT_SEAMLESS_REVERSAL */
+#if _SUPPORT_RAMP_SCURVE
+					if ( g_u16ActuatorTgtPos != l_u16ActuatorBufferedTgtPos )
+					{
+						l_u8VTIdxCapped = FALSE;								/* Continue beyond the (distance limited) table */
+					}
+#endif /* _SUPPORT_RAMP_SCURVE */
 					g_u16ActuatorTgtPos = l_u16ActuatorBufferedTgtPos;
 				}
 			}
@@ -591,6 +658,113 @@ void MotorDriverInit( void)
 										
 } /* End of MotorDriverInit */
 
+#if _SUPPORT_RAMP_TABLE
+/* ****************************************************************************	*
+ * MotorDriverRampTableInit()
+ *
+ * Fill the velocity-timer table with the commutation-timer periods of the
+ * acceleration ramp, starting at NVRAM_MIN_SPEED. Each entry is one acceleration
+ * step (l_u8VTIdx), using the same speed-increment as the commutation ISR did.
+ * The table ends at the (buffered) target speed or at VT_BUF_SZ entries; beyond
+ * the table the commutation ISR calculates the speed from l_u16VTSpeedRPM.
+ * _SUPPORT_RAMP_SCURVE: The ramp consists of constant-jerk segments; the
+ * acceleration level rises by one per ramp step up to (1 << C_RAMP_JERK_SHIFT),
+ * is held, and is lowered to zero at the end of the table. A level is only
+ * raised or held if the jerk-down to zero still fits the remaining speed and
+ * distance; The last entry closes the residual to the target speed (less than
+ * one level-1 step). The speed is accumulated in 1/256 RPM.
+ * The table is limited to the move distance (acceleration entries every
+ * acceleration-points, deceleration entries every micro-step), so also a short
+ * move ends the acceleration at zero jerk before deceleration starts; the
+ * braking distance equals l_u8VTIdx micro-steps. At a seamless reversal the
+ * commutation ISR holds the start-up speed till the main-loop has re-planned
+ * the table for the distance from the turning-point (l_u8VTReplan).
+ * Pre: l_u32Temp calculated, g_u16ActuatorActPos and g_u16ActuatorTgtPos set.
+ * Performance: VT_BUF_SZ x 2 divisions (main-loop, not in commutation ISR)
+ * ****************************************************************************	*/
+void MotorDriverRampTableInit( void)
+{
+	uint16 u16SpeedRPM = NVRAM_MIN_SPEED;
+	uint16 u16Idx = 0u;
+
+	l_au16VelocityTimer[0] = divU16_U32byU16( l_u32Temp, u16SpeedRPM) - 1U;
+#if _SUPPORT_RAMP_SCURVE
+/* Speed-square gained by the jerk-down from acceleration level L to zero (ramp steps at level L-1 .. 1) */
+#define RAMP_SPEED_SQR_GAIN(L)	(mulU32_U16byU16( 2u * NVRAM_ACCELERATION_CONST, (uint16) ((L) * ((L) - 1u))) >> C_RAMP_JERK_SHIFT)
+	uint8 u8VTIdxCapped;
+	{
+		uint16 u16AccLevel = 0u;
+		uint16 u16IdxMax = VT_BUF_SZ - 1u;
+		uint16 u16IdxEnd;														/* Ramp steps within the move distance */
+		uint32 u32SpeedRPM = ((uint32) u16SpeedRPM << 8);						/* [1/256 RPM] */
+		uint32 u32TargetSpeedSqr = mulU32_U16byU16( l_u16ActuatorBufferedSpdRPM, l_u16ActuatorBufferedSpdRPM);
+		{
+			uint16 u16Distance = (g_u16ActuatorTgtPos > g_u16ActuatorActPos) ? (g_u16ActuatorTgtPos - g_u16ActuatorActPos) : (g_u16ActuatorActPos - g_u16ActuatorTgtPos);
+			u16IdxEnd = divU16_U32byU16( (uint32) u16Distance, NVRAM_ACCELERATION_POINTS + 2u);
+			if ( u16IdxEnd < u16IdxMax )
+			{
+				u16IdxMax = u16IdxEnd;
+			}
+		}
+		while ( (u16SpeedRPM < l_u16ActuatorBufferedSpdRPM) && (u16Idx < u16IdxMax) )
+		{
+			uint32 u32SpeedSqr = mulU32_U16byU16( u16SpeedRPM, u16SpeedRPM);
+			uint16 u16StepsLeft = u16IdxEnd - u16Idx;
+			if ( (u16AccLevel < (1u << C_RAMP_JERK_SHIFT)) && (u16StepsLeft > u16AccLevel) &&
+				 ((u32SpeedSqr + RAMP_SPEED_SQR_GAIN( u16AccLevel + 2u)) < u32TargetSpeedSqr) )
+			{
+				/* Jerk-up segment */
+				u16AccLevel++;
+			}
+			else if ( (u16AccLevel != 0u) && (u16StepsLeft >= u16AccLevel) &&
+					  ((u32SpeedSqr + RAMP_SPEED_SQR_GAIN( u16AccLevel + 1u)) < u32TargetSpeedSqr) )
+			{
+				/* Constant acceleration segment */
+			}
+			else if ( u16AccLevel > 1u )
+			{
+				/* Jerk-down segment */
+				u16AccLevel--;
+			}
+			else
+			{
+				/* Acceleration reaches zero: Last entry at the target speed */
+				u16SpeedRPM = l_u16ActuatorBufferedSpdRPM;
+				u16Idx++;
+				l_au16VelocityTimer[u16Idx] = divU16_U32byU16( l_u32Temp, u16SpeedRPM) - 1U;
+				break;
+			}
+			u32SpeedRPM += divU16_U32byU16( mulU32_U16byU16( 2u * NVRAM_ACCELERATION_CONST, u16AccLevel) << (8u - C_RAMP_JERK_SHIFT), u16SpeedRPM);
+			u16SpeedRPM = (uint16) (u32SpeedRPM >> 8);
+			u16Idx++;
+			l_au16VelocityTimer[u16Idx] = divU16_U32byU16( l_u32Temp, u16SpeedRPM) - 1U;
+		}
+		u8VTIdxCapped = (u16SpeedRPM < l_u16ActuatorBufferedSpdRPM) && (u16Idx == u16IdxMax) && (u16IdxMax < (VT_BUF_SZ - 1u));
+	}
+#undef RAMP_SPEED_SQR_GAIN
+#else  /* _SUPPORT_RAMP_SCURVE */
+	while ( (u16SpeedRPM < l_u16ActuatorBufferedSpdRPM) && (u16Idx < (VT_BUF_SZ - 1u)) )
+	{
+		u16SpeedRPM = u16SpeedRPM + divU16_U32byU16( (uint32) 2*NVRAM_ACCELERATION_CONST, u16SpeedRPM);
+		u16Idx++;
+		l_au16VelocityTimer[u16Idx] = divU16_U32byU16( l_u32Temp, u16SpeedRPM) - 1U;
+	}
+#endif /* _SUPPORT_RAMP_SCURVE */
+#if _SUPPORT_RAMP_SCURVE
+	ATOMIC_CODE
+	(
+		l_u8VTIdxMax = (uint8) u16Idx;
+		l_u16VTSpeedRPM = u16SpeedRPM;
+		l_u8VTIdxCapped = u8VTIdxCapped;
+		l_u8VTReplan = FALSE;
+	);
+#else  /* _SUPPORT_RAMP_SCURVE */
+	l_u8VTIdxMax = (uint8) u16Idx;
+	l_u16VTSpeedRPM = u16SpeedRPM;
+#endif /* _SUPPORT_RAMP_SCURVE */
+} /* End of MotorDriverRampTableInit() */
+#endif /* _SUPPORT_RAMP_TABLE */
+
 /* ****************************************************************************	*
  * MotorDriverStart()
  *
@@ -606,7 +780,12 @@ void MotorDriverStart( void)
 		{
 			l_u16SpeedRPM = NVRAM_MIN_SPEED;
 			l_u32Temp = divU32_U32byU16( (TIMER_CLOCK * 60U), g_u16MotorMicroStepsPerMechRotation);
+#if _SUPPORT_RAMP_TABLE
+			MotorDriverRampTableInit();
+			l_u16LowSpeedPeriod = l_au16VelocityTimer[0];
+#else  /* _SUPPORT_RAMP_TABLE */
 			l_u16LowSpeedPeriod = divU16_U32byU16( l_u32Temp, l_u16SpeedRPM) - 1U;
+#endif /* _SUPPORT_RAMP_TABLE */
 		}
 #endif /* USE_MULTI_PURPOSE_BUFFER */
 
@@ -634,6 +813,10 @@ void MotorDriverStart( void)
 		u16MotorVoltIdx = 0u;
 #endif /* _DEBUG_VOLTAGE_COMPENSATION */
 
+#if _SUPPORT_LOAD_ADAPTIVE_CURRENT
+		LoadAdaptiveCurrentInit();													/* Start-up at the full running current */
+#endif /* _SUPPORT_LOAD_ADAPTIVE_CURRENT */
+
 		/* Connect drivers */
 		/* Stepper 4-phase/32-steps */
 		{
@@ -654,6 +837,12 @@ void MotorDriverStart( void)
 
 		g_u8MotorStartupMode = (uint8) MSM_STEPPER_A;								/* Start-up in Acceleration stepper mode */
 		l_u8VTIdx = 0;
+#if _SUPPORT_USTEP_ADAPTIVE
+		l_u16MicroStepStride = 1u;													/* Start-up at full micro-step resolution */
+#endif /* _SUPPORT_USTEP_ADAPTIVE */
+#if _SUPPORT_SEAMLESS_REVERSAL
+		l_u8ReversalPending = FALSE;
+#endif /* _SUPPORT_SEAMLESS_REVERSAL */
 		if ( g_u8MotorStartupMode == (uint8) MSM_STEPPER_A )
 		{
 			if ( g_u16TargetCommutTimerPeriod < l_u16LowSpeedPeriod )
@@ -677,6 +866,51 @@ void MotorDriverStart( void)
 	return;
 } /* End of MotorDriverStart */
 
+#if _SUPPORT_SEAMLESS_REVERSAL
+/* ****************************************************************************	*
+ * MotorDriverReverse()
+ *
+ * Change of direction while running, without stop and re-start: the target-
+ * position is set to the turning-point (actual position plus braking distance),
+ * where the commutation ISR reverses the direction and accelerates again from
+ * the start of the velocity-timer table towards u16TgtPos. The drivers stay
+ * energised. A later call before the turning-point only updates u16TgtPos.
+ * The (start-up) PWM duty-cycle after the turning-point is calculated here,
+ * so the commutation ISR only has to load it.
+ * ****************************************************************************	*/
+void MotorDriverReverse( uint16 u16TgtPos)
+{
+	uint16 u16PidCtrlRatio, u16CorrectionRatio;
+
+	MotorDriver_PwmDutyCycleRatio( g_u16PidRunningThreshold, g_au16MotorSpeedRPS[1], &u16PidCtrlRatio, &u16CorrectionRatio);	/* Without the BEMF-part of the running PWM duty-cycle */
+	ATOMIC_CODE
+	(
+		if ( l_u8ReversalPending == FALSE )
+		{
+			uint16 u16BrakeDistance = (l_u8VTIdx != 0u) ? (uint16) l_u8VTIdx : 1u;
+			if ( g_e8MotorDirectionCCW == C_MOTOR_DIR_CCW )
+			{
+				if ( (g_u16ActuatorActPos - g_u16ActuatorTgtPos) > u16BrakeDistance )
+				{
+					g_u16ActuatorTgtPos = g_u16ActuatorActPos - u16BrakeDistance;
+				}
+			}
+			else
+			{
+				if ( (g_u16ActuatorTgtPos - g_u16ActuatorActPos) > u16BrakeDistance )
+				{
+					g_u16ActuatorTgtPos = g_u16ActuatorActPos + u16BrakeDistance;
+				}
+			}
+		}
+		l_u16ReversalTgtPos = u16TgtPos;
+		l_u16ReversalPidCtrlRatio = u16PidCtrlRatio;
+		l_u16ReversalCorrectionRatio = u16CorrectionRatio;
+		l_u8ReversalPending = TRUE;
+	);
+} /* End of MotorDriverReverse() */
+#endif /* _SUPPORT_SEAMLESS_REVERSAL */
+
 /* ****************************************************************************	*
  * MotorDriverStop()
  *
@@ -688,6 +922,9 @@ void MotorDriverStart( void)
  * ****************************************************************************	*/
 void MotorDriverStop( uint16 u16Immediate )
 {
+#if _SUPPORT_SEAMLESS_REVERSAL
+	l_u8ReversalPending = FALSE;												/* Any stop cancels a pending change of direction */
+#endif /* _SUPPORT_SEAMLESS_REVERSAL */
 	if(g_u8MotorStartupMode != (uint8) MSM_STOP)
 	{
 		if(u16Immediate == (uint16) C_STOP_RAMPDOWN) /*lint !e845 */	/* MMP150922-1 */
@@ -810,7 +1047,11 @@ void MotorDriverCurrentMeasureInit( void)
 void MotorDriverCurrentMeasure( void)
 {
 	uint16 u16MotorCurrentAcc;
+#if _SUPPORT_ADC_CURRENT_OSR
+	uint16 u16MicroStepMotorCurrent = GetDecimatedMotorDriverCurrent();
+#else  /* _SUPPORT_ADC_CURRENT_OSR */
 	uint16 u16MicroStepMotorCurrent = GetRawMotorDriverCurrent();
+#endif /* _SUPPORT_ADC_CURRENT_OSR */
 #if _DEBUG_SPI
 	SpiDebugWriteFirst(g_u16PidRunningThreshold|0x8000u);
 	SpiDebugWriteNext(g_u16MotorCurrentMovAvgxN);
@@ -863,35 +1104,53 @@ void MotorDriverCurrentMeasure( void)
 } /* End of MotorDriverCurrentMeasure() */
 
 /* ****************************************************************************	*
- * MotorDriver_InitialPwmDutyCycle()
+ * MotorDriver_PwmDutyCycleRatio()
  *
- * Calculate Motor PWM (initial) Duty-cycle, based on current threshold level and speed
+ * Calculate the Motor PWM (initial) ratios, based on current threshold level
+ * and speed: *pu16PidCtrlRatio at NVRAM_VSUP_REF, *pu16CorrectionRatio at the
+ * actual motor voltage.
  * ****************************************************************************	*/
-void MotorDriver_InitialPwmDutyCycle( uint16 u16CurrentLevel, uint16 u16MotorSpeed)
+void MotorDriver_PwmDutyCycleRatio( uint16 u16CurrentLevel, uint16 u16MotorSpeed, uint16 *pu16PidCtrlRatio, uint16 *pu16CorrectionRatio)
 {
+	uint16 u16Voltage;
+
 	if ( u16MotorSpeed == 0u )														/* MMP140228-1 - Begin */
 	{
-		g_u16CorrectionRatio  = ((NVRAM_MOTOR_COIL_RTOT + (2u * C_FETS_RTOT)) * u16CurrentLevel);
-		g_u16CorrectionRatio /= 4u;
+		u16Voltage  = ((NVRAM_MOTOR_COIL_RTOT + (2u * C_FETS_RTOT)) * u16CurrentLevel);
+		u16Voltage /= 4u;
 	}																				/* MMP140228-1 - End */
 	else
 	{
 		/* Ohmic losses: Ur-losses = (0.5 * R[ohm] * I[mA])/10 [10mV] = (R[ohm] * I[mA])/20 [10mV]
 		 * FET losses: Ufet-losses = (Rfet * I[mA])/10 [10mV] = (2 * Rfet * I[mA])/20 [10mV]*/
-		g_u16CorrectionRatio  = ((NVRAM_MOTOR_COIL_RTOT + (2u * C_FETS_RTOT)) * u16CurrentLevel);
-		g_u16CorrectionRatio /= 20u;													/* Divided by 20 */
-		g_u16CorrectionRatio += (NVRAM_MOTOR_CONSTANT * u16MotorSpeed);				/* BEMF = Kmotor[10mV/RPS] * Speed[RPS] */
+		u16Voltage  = ((NVRAM_MOTOR_COIL_RTOT + (2u * C_FETS_RTOT)) * u16CurrentLevel);
+		u16Voltage /= 20u;																/* Divided by 20 */
+		u16Voltage += (NVRAM_MOTOR_CONSTANT * u16MotorSpeed);						/* BEMF = Kmotor[10mV/RPS] * Speed[RPS] */
 	}
-	g_u16PidCtrlRatio =  muldivU16_U16byU16byU16( g_u16CorrectionRatio << 3u, (uint16)PWM_REG_PERIOD << (1u + PWM_PRESCALER_N), NVRAM_VSUP_REF);
-	g_u16PID_I = g_u16PidCtrlRatio;
+	*pu16PidCtrlRatio = muldivU16_U16byU16byU16( u16Voltage << 3u, (uint16)PWM_REG_PERIOD << (1u + PWM_PRESCALER_N), NVRAM_VSUP_REF);
 	if ( g_i16MotorVoltage > 0 )
 	{
-		g_u16CorrectionRatio = muldivU16_U16byU16byU16( g_u16CorrectionRatio << 3u, (uint16)PWM_REG_PERIOD << (1u + PWM_PRESCALER_N), (uint16) g_i16MotorVoltage);
+		*pu16CorrectionRatio = muldivU16_U16byU16byU16( u16Voltage << 3u, (uint16)PWM_REG_PERIOD << (1u + PWM_PRESCALER_N), (uint16) g_i16MotorVoltage);
 	}
 	else
 	{
-		g_u16CorrectionRatio = g_u16PidCtrlRatio;
+		*pu16CorrectionRatio = *pu16PidCtrlRatio;
 	}
+} /* End of MotorDriver_PwmDutyCycleRatio() */
+
+/* ****************************************************************************	*
+ * MotorDriver_InitialPwmDutyCycle()
+ *
+ * Calculate Motor PWM (initial) Duty-cycle, based on current threshold level and speed
+ * ****************************************************************************	*/
+void MotorDriver_InitialPwmDutyCycle( uint16 u16CurrentLevel, uint16 u16MotorSpeed)
+{
+	uint16 u16PidCtrlRatio, u16CorrectionRatio;
+
+	MotorDriver_PwmDutyCycleRatio( u16CurrentLevel, u16MotorSpeed, &u16PidCtrlRatio, &u16CorrectionRatio);
+	g_u16PidCtrlRatio = u16PidCtrlRatio;
+	g_u16PID_I = u16PidCtrlRatio;
+	g_u16CorrectionRatio = u16CorrectionRatio;
 	g_i16PID_D = 0;
 	g_i16PID_E = 0;
 } /* End of MotorDriver_InitialPwmDutyCycle() */
@@ -902,11 +1161,12 @@ void MotorDriver_InitialPwmDutyCycle( uint16 u16CurrentLevel, uint16 u16MotorSpe
  * Performance: 13.5us @ 28MHz (BIPOLAR_PWM_SINGLE_INDEPENDED_GND)
  *
  * Based on a 32-step c_ai16MicroStepVector4PH-table!!
+ * _SUPPORT_USTEP_QUARTER_WAVE: Vector folded from the quarter-wave table.
  * ****************************************************************************	*/
 void MotorDriver_4PhaseStepper( void)
 {
 #if (_SUPPORT_PWM_MODE == BIPOLAR_PWM_DOUBLE_MIRROR)
-	register int16 iPwm = (int16) (mulI32_I16byU16( c_ai16MicroStepVector4PH[g_u16MicroStepIdx], g_u16CorrectionRatio) >> (20 + PWM_PRESCALER_N));
+	register int16 iPwm = (int16) (mulI32_I16byU16( MICRO_STEP_VECTOR_4PH(g_u16MicroStepIdx), g_u16CorrectionRatio) >> (20 + PWM_PRESCALER_N));
 #if (_SUPPORT_BIPOLAR_MODE == BIPOLAR_MODE_UW_VT)
 	PWM4_LT = (uint16) ((int16) PWM_SCALE_OFFSET + iPwm);	/* U */
 	PWM2_LT = (uint16) ((int16) PWM_SCALE_OFFSET - iPwm);	/* W */
@@ -915,7 +1175,7 @@ void MotorDriver_4PhaseStepper( void)
 	PWM3_LT = (uint16) ((int16) PWM_SCALE_OFFSET + iPwm);	/* V */
 	PWM2_LT = (uint16) ((int16) PWM_SCALE_OFFSET - iPwm);	/* W */
 #endif /* (_SUPPORT_BIPOLAR_MODE == BIPOLAR_MODE_UT_VW) */
-	iPwm = (int16) (mulI32_I16byU16( c_ai16MicroStepVector4PH[g_u16MicroStepIdx + C_MICROSTEP_PER_FULLSTEP], g_u16CorrectionRatio) >> (20 + PWM_PRESCALER_N));
+	iPwm = (int16) (mulI32_I16byU16( MICRO_STEP_VECTOR_4PH(g_u16MicroStepIdx + C_MICROSTEP_PER_FULLSTEP), g_u16CorrectionRatio) >> (20 + PWM_PRESCALER_N));
 #if (_SUPPORT_BIPOLAR_MODE == BIPOLAR_MODE_UW_VT)
 	PWM3_LT = (uint16) ((int16) PWM_SCALE_OFFSET + iPwm);	/* V */
 	PWM5_LT = (uint16) ((int16) PWM_SCALE_OFFSET - iPwm);	/* T */
@@ -928,7 +1188,7 @@ void MotorDriver_4PhaseStepper( void)
 
 #if (_SUPPORT_PWM_MODE == BIPOLAR_PWM_SINGLE_MIRROR_VSM)
 	/* Sines */
-	register int16 iPwm = (int16) (mulI32_I16byU16( c_ai16MicroStepVector4PH[u16MicroStepIdx], g_u16CorrectionRatio) >> (19 + PWM_PRESCALER_N));
+	register int16 iPwm = (int16) (mulI32_I16byU16( MICRO_STEP_VECTOR_4PH(u16MicroStepIdx), g_u16CorrectionRatio) >> (19 + PWM_PRESCALER_N));
 	if ( iPwm >= 0 )
 	{
 		/* 1st and 2nd Quadrant */
@@ -968,7 +1228,7 @@ void MotorDriver_4PhaseStepper( void)
 #endif /* (_SUPPORT_BIPOLAR_MODE == BIPOLAR_MODE_UT_VW) */
 	}
 	/* Cosines */
-	iPwm = (int16) (mulI32_I16byU16( c_ai16MicroStepVector4PH[u16MicroStepIdx + C_MICROSTEP_PER_FULLSTEP], g_u16CorrectionRatio) >> (19 + PWM_PRESCALER_N));
+	iPwm = (int16) (mulI32_I16byU16( MICRO_STEP_VECTOR_4PH(u16MicroStepIdx + C_MICROSTEP_PER_FULLSTEP), g_u16CorrectionRatio) >> (19 + PWM_PRESCALER_N));
 	if ( iPwm >= 0 )
 	{
 		/* 1st and 4th Quadrant */
@@ -1011,7 +1271,7 @@ void MotorDriver_4PhaseStepper( void)
 
 #if (_SUPPORT_PWM_MODE == BIPOLAR_PWM_SINGLE_MIRROR_GND)
 	/* Sines */
-	register int16 iPwm = (int16) (mulI32_I16byU16( c_ai16MicroStepVector4PH[g_u16MicroStepIdx], g_u16CorrectionRatio) >> (19 + PWM_PRESCALER_N));
+	register int16 iPwm = (int16) (mulI32_I16byU16( MICRO_STEP_VECTOR_4PH(g_u16MicroStepIdx), g_u16CorrectionRatio) >> (19 + PWM_PRESCALER_N));
 	if ( iPwm >= 0 )
 	{
 		/* 1st and 2nd Quadrant */
@@ -1051,7 +1311,7 @@ void MotorDriver_4PhaseStepper( void)
 #endif /* (_SUPPORT_BIPOLAR_MODE == BIPOLAR_MODE_UT_VW) */
 	}
 	/* Cosines */
-	iPwm = (int16) (mulI32_I16byU16( c_ai16MicroStepVector4PH[g_u16MicroStepIdx + C_MICROSTEP_PER_FULLSTEP], g_u16CorrectionRatio) >> (19 + PWM_PRESCALER_N));
+	iPwm = (int16) (mulI32_I16byU16( MICRO_STEP_VECTOR_4PH(g_u16MicroStepIdx + C_MICROSTEP_PER_FULLSTEP), g_u16CorrectionRatio) >> (19 + PWM_PRESCALER_N));
 	if ( iPwm >= 0 )
 	{
 		/* 1st and 4th Quadrant */
@@ -1095,23 +1355,19 @@ void MotorDriver_4PhaseStepper( void)
 #if (_SUPPORT_PWM_MODE == BIPOLAR_PWM_SINGLE_INDEPENDED_VSM)
 	/* EMC CE/RE reduction */
 	int16 iPwm1, iPwm2;
-	int16 *pi16Vector = (int16 *) &c_ai16MicroStepVector4PH[g_u16MicroStepIdx];
 	if (PWM_REG_PERIOD >= (128U << (4U - PWM_PRESCALER_N)))						/* (((PWM_REG_PERIOD * 256U) >> (4U - PWM_PRESCALER_N)) > 32767U) */
 	{
-		iPwm1 = (int16) (mulI32_I16byU16( *pi16Vector, g_u16CorrectionRatio) >> (20 + PWM_PRESCALER_N));
-		pi16Vector += C_MICROSTEP_PER_FULLSTEP;
-		iPwm2 = (int16) (mulI32_I16byU16( *pi16Vector, g_u16CorrectionRatio) >> (20 + PWM_PRESCALER_N));
+		iPwm1 = (int16) (mulI32_I16byU16( MICRO_STEP_VECTOR_4PH(g_u16MicroStepIdx), g_u16CorrectionRatio) >> (20 + PWM_PRESCALER_N));
+		iPwm2 = (int16) (mulI32_I16byU16( MICRO_STEP_VECTOR_4PH(g_u16MicroStepIdx + C_MICROSTEP_PER_FULLSTEP), g_u16CorrectionRatio) >> (20 + PWM_PRESCALER_N));
 	}
 	else
 	{
 #if (PWM_PRESCALER_N == 0)
-		iPwm1 = mulI16_I16byI16Shft4( *pi16Vector, (int16) g_u16CorrectionRatio);	/* U */
-		pi16Vector += C_MICROSTEP_PER_FULLSTEP;
-		iPwm2 = mulI16_I16byI16Shft4( *pi16Vector, (int16) g_u16CorrectionRatio);	/* V */
+		iPwm1 = mulI16_I16byI16Shft4( MICRO_STEP_VECTOR_4PH(g_u16MicroStepIdx), (int16) g_u16CorrectionRatio);	/* U */
+		iPwm2 = mulI16_I16byI16Shft4( MICRO_STEP_VECTOR_4PH(g_u16MicroStepIdx + C_MICROSTEP_PER_FULLSTEP), (int16) g_u16CorrectionRatio);	/* V */
 #else
-		i16PwmU = (int16) (mulI16_I16byI16( *pi16Vector, (int16) g_u16CorrectionRatio) >> (4 + PWM_PRESCALER_N));	/* U */
-		pi16Vector += C_MICROSTEP_PER_FULLSTEP;
-		i16PwmV = (int16) (mulI16_I16byI16( *pi16Vector, (int16) g_u16CorrectionRatio) >> (4 + PWM_PRESCALER_N));	/* V */
+		i16PwmU = (int16) (mulI16_I16byI16( MICRO_STEP_VECTOR_4PH(g_u16MicroStepIdx), (int16) g_u16CorrectionRatio) >> (4 + PWM_PRESCALER_N));	/* U */
+		i16PwmV = (int16) (mulI16_I16byI16( MICRO_STEP_VECTOR_4PH(g_u16MicroStepIdx + C_MICROSTEP_PER_FULLSTEP), (int16) g_u16CorrectionRatio) >> (4 + PWM_PRESCALER_N));	/* V */
 #endif
 	}
 	if ( u16MicroStepIdx & (2*C_MICROSTEP_PER_FULLSTEP) )
@@ -1372,19 +1628,15 @@ void MotorDriver_4PhaseStepper( void)
 #if (_SUPPORT_PWM_MODE == BIPOLAR_PWM_SINGLE_INDEPENDED_GND)					/* MMP150515-1 */
 	/* EMC CE/RE reduction */
 	int16 iPwm1, iPwm2;
-	const int16 *pi16Vector = &c_ai16MicroStepVector4PH[g_u16MicroStepIdx];
 #if (PWM_REG_PERIOD >= (128U << (4U - PWM_PRESCALER_N)))						/* (((PWM_REG_PERIOD * 256U) >> (4U - PWM_PRESCALER_N)) > 32767U) */
-	iPwm1 = (int16) (mulI32_I16byU16( *pi16Vector, g_u16CorrectionRatio) >> (20 + PWM_PRESCALER_N));
-	pi16Vector += C_MICROSTEP_PER_FULLSTEP;
-	iPwm2 = (int16) (mulI32_I16byU16( *pi16Vector, g_u16CorrectionRatio) >> (20 + PWM_PRESCALER_N));
+	iPwm1 = (int16) (mulI32_I16byU16( MICRO_STEP_VECTOR_4PH(g_u16MicroStepIdx), g_u16CorrectionRatio) >> (20 + PWM_PRESCALER_N));
+	iPwm2 = (int16) (mulI32_I16byU16( MICRO_STEP_VECTOR_4PH(g_u16MicroStepIdx + C_MICROSTEP_PER_FULLSTEP), g_u16CorrectionRatio) >> (20 + PWM_PRESCALER_N));
 #elif (PWM_PRESCALER_N == 0U)
-	iPwm1 = mulI16_I16byI16Shft4( *pi16Vector, (int16) g_u16CorrectionRatio);	/* U */
-	pi16Vector += C_MICROSTEP_PER_FULLSTEP;
-	iPwm2 = mulI16_I16byI16Shft4( *pi16Vector, (int16) g_u16CorrectionRatio);	/* V */
+	iPwm1 = mulI16_I16byI16Shft4( MICRO_STEP_VECTOR_4PH(g_u16MicroStepIdx), (int16) g_u16CorrectionRatio);	/* U */
+	iPwm2 = mulI16_I16byI16Shft4( MICRO_STEP_VECTOR_4PH(g_u16MicroStepIdx + C_MICROSTEP_PER_FULLSTEP), (int16) g_u16CorrectionRatio);	/* V */
 #else
-	i16PwmU = (int16) (mulI16_I16byI16( *pi16Vector, (int16) g_u16CorrectionRatio) >> (4 + PWM_PRESCALER_N));	/* U */
-	pi16Vector += C_MICROSTEP_PER_FULLSTEP;
-	i16PwmV = (int16) (mulI16_I16byI16( *pi16Vector, (int16) g_u16CorrectionRatio) >> (4 + PWM_PRESCALER_N));	/* V */
+	i16PwmU = (int16) (mulI16_I16byI16( MICRO_STEP_VECTOR_4PH(g_u16MicroStepIdx), (int16) g_u16CorrectionRatio) >> (4 + PWM_PRESCALER_N));	/* U */
+	i16PwmV = (int16) (mulI16_I16byI16( MICRO_STEP_VECTOR_4PH(g_u16MicroStepIdx + C_MICROSTEP_PER_FULLSTEP), (int16) g_u16CorrectionRatio) >> (4 + PWM_PRESCALER_N));	/* V */
 #endif
 	if ( (g_u16MicroStepIdx & (2u*C_MICROSTEP_PER_FULLSTEP)) != 0u )
 	{
@@ -1504,7 +1756,7 @@ void MotorDriver_4PhaseStepper( void)
 #endif /* (_SUPPORT_PWM_MODE == BIPOLAR_PWM_SINGLE_INDEPENDED_GND) */
 
 #if (_SUPPORT_PWM_MODE == BIPOLAR_PWM_SINGLE_MIRRORSPECIAL)
-	register int16 iPwm = (int16) (mulI32_I16byU16( c_ai16MicroStepVector4PH[u16MicroStepIdx], g_u16CorrectionRatio) >> (19 + PWM_PRESCALER_N));
+	register int16 iPwm = (int16) (mulI32_I16byU16( MICRO_STEP_VECTOR_4PH(u16MicroStepIdx), g_u16CorrectionRatio) >> (19 + PWM_PRESCALER_N));
 	if ( iPwm >= 0 )
 	{
 		/* 1st and 2nd Quadrant */
@@ -1543,7 +1795,7 @@ void MotorDriver_4PhaseStepper( void)
 		PWM3_LT = (uint16) ((int16) PWM_REG_PERIOD + iPwm);	/* V = PWM */
 #endif /* (_SUPPORT_BIPOLAR_MODE == BIPOLAR_MODE_UT_VW) */
 	}
-	iPwm = (int16) (mulI32_I16byU16( c_ai16MicroStepVector4PH[u16MicroStepIdx + C_MICROSTEP_PER_FULLSTEP], g_u16CorrectionRatio) >> (19 + PWM_PRESCALER_N));
+	iPwm = (int16) (mulI32_I16byU16( MICRO_STEP_VECTOR_4PH(u16MicroStepIdx + C_MICROSTEP_PER_FULLSTEP), g_u16CorrectionRatio) >> (19 + PWM_PRESCALER_N));
 	if ( iPwm >= 0 )
 	{
 		/* 1st and 4th Quadrant */
@@ -1601,6 +1853,7 @@ void MotorDriver_4PhaseStepper( void)
  * ****************************************************************************	*/
 __interrupt__ void EXT0_IT(void)
 {
+	PROFILER_START();
 #if (_DEBUG_COMMUT_ISR != FALSE)
 	DEBUG_SET_IO_B();
 #endif /* (_DEBUG_COMMUT_ISR != FALSE) && (_DEBUG_HALLLATCH_ISR == FALSE) */
@@ -1610,32 +1863,85 @@ __interrupt__ void EXT0_IT(void)
 	{
 		XI0_PEND = pending;														/* Clear requests which are going to be processed */
 	} while ((XI0_PEND & pending) != 0u);
+#if _SUPPORT_HALL_TMR2_CAPTURE
+	g_u16CommutTimeStamp = TMR2_CNT - TMR1_CNT;									/* Commutation-timer expired TMR1_CNT ago */
+#endif /* _SUPPORT_HALL_TMR2_CAPTURE */
 
 	if ( g_u8MotorStartupMode == (uint8) MSM_STOP )
 	{
+		PROFILER_STOP( PROFILE_EXT0_IT);
 		return;		/* Used for CPU wake-up */
 	}
 
 	if ( g_e8MotorDirectionCCW == C_MOTOR_DIR_CCW)												/* Motor direction counter clockwise is true? */
 	{
+#if _SUPPORT_USTEP_ADAPTIVE
+		g_u16ActuatorActPos -= l_u16MicroStepStride;							/* Closing */
+#else  /* _SUPPORT_USTEP_ADAPTIVE */
 		g_u16ActuatorActPos--;													/* Closing */
+#endif /* _SUPPORT_USTEP_ADAPTIVE */
 	}
 	else
 	{
+#if _SUPPORT_USTEP_ADAPTIVE
+		g_u16ActuatorActPos += l_u16MicroStepStride;							/* Opening */
+#else  /* _SUPPORT_USTEP_ADAPTIVE */
 		g_u16ActuatorActPos++;													/* Opening */
+#endif /* _SUPPORT_USTEP_ADAPTIVE */
 	}
 
+#if _SUPPORT_USTEP_ADAPTIVE
+	uint16 u16DeltaPosition;
+#endif /* _SUPPORT_USTEP_ADAPTIVE */
 	{
 		int32 i32DeltaPosition = (int32)g_u16ActuatorActPos - (int32)g_u16ActuatorTgtPos;
 		if ( i32DeltaPosition == 0 )
 		{
+#if _SUPPORT_SEAMLESS_REVERSAL
+			if ( (l_u8ReversalPending != FALSE) && (l_u16ReversalTgtPos != g_u16ActuatorActPos) )
+			{
+				/* Turning-point: reverse and accelerate towards the new target-position (as MotorDriverStart) */
+				l_u8ReversalPending = FALSE;
+				g_u16ActuatorTgtPos = l_u16ReversalTgtPos;
+				g_e8MotorDirectionCCW = (g_u16ActuatorTgtPos < g_u16ActuatorActPos) ? C_MOTOR_DIR_CCW : C_MOTOR_DIR_CW;
+				g_u8MotorStartupMode = (uint8) MSM_STEPPER_A;
+				l_u8VTIdx = 0u;
+#if _SUPPORT_RAMP_SCURVE
+				/* Table planned for the previous move: Hold the start-up speed (l_au16VelocityTimer[0]) till re-planned */
+				l_u8VTIdxMax = 0u;
+				l_u16VTSpeedRPM = NVRAM_MIN_SPEED;
+				l_u8VTIdxCapped = TRUE;
+				l_u8VTReplan = TRUE;
+#endif /* _SUPPORT_RAMP_SCURVE */
+#if _SUPPORT_USTEP_ADAPTIVE
+				l_u16MicroStepStride = 1u;
+#endif /* _SUPPORT_USTEP_ADAPTIVE */
+				g_u16CommutTimerPeriod = (g_u16TargetCommutTimerPeriod < l_u16LowSpeedPeriod) ? l_u16LowSpeedPeriod : g_u16TargetCommutTimerPeriod;
+				TMR1_REGB = g_u16CommutTimerPeriod;
+				g_u16PidCtrlRatio = l_u16ReversalPidCtrlRatio;					/* Pre-calculated by MotorDriverReverse() */
+				g_u16PID_I = l_u16ReversalPidCtrlRatio;
+				g_u16CorrectionRatio = l_u16ReversalCorrectionRatio;
+				g_i16PID_D = 0;
+				g_i16PID_E = 0;
+				g_u16StartupDelay = l_u16StartupDelayInit;						/* Stall detection post-poned */
+#if _SUPPORT_STALLDET_H
+				MotorStallInitH();
+#endif /* _SUPPORT_STALLDET_H */
+				PROFILER_STOP( PROFILE_EXT0_IT);
+				return;
+			}
+#endif /* _SUPPORT_SEAMLESS_REVERSAL */
 			MotorDriverStop( (uint16) C_STOP_IMMEDIATE);
+			PROFILER_STOP( PROFILE_EXT0_IT);
 			return;
 		}
 		if ( i32DeltaPosition < 0 )
 		{
 			i32DeltaPosition = -i32DeltaPosition;
 		}
+#if _SUPPORT_USTEP_ADAPTIVE
+		u16DeltaPosition = (uint16) i32DeltaPosition;
+#endif /* _SUPPORT_USTEP_ADAPTIVE */
 		if ( i32DeltaPosition <= (int16) l_u8VTIdx )
 		{
 			/* Decelerate motor speed (almost at target-position) */
@@ -1644,13 +1950,35 @@ __interrupt__ void EXT0_IT(void)
 		}
 	}
 
+#if (_SUPPORT_COMMUT_BOTTOM_HALF == FALSE)
 	/* Current measurement used for Stall-detector "A" and current control (PID) */
 	MotorDriverCurrentMeasure();
 
 	/* open coil detection */
 	(void)MotorDiagnosticOpenCheck();
+#endif /* (_SUPPORT_COMMUT_BOTTOM_HALF == FALSE) */
 
 	/* Update micro-step index */
+#if _SUPPORT_USTEP_ADAPTIVE
+	if ( (NVRAM_MOTOR_DIR_INV != 0u) == (g_e8MotorDirectionCCW == C_MOTOR_DIR_CCW) )
+	{
+		/* Decrement the PWM vector pointer by the micro-step stride */
+		if ( g_u16MicroStepIdx < l_u16MicroStepStride )
+		{
+			g_u16MicroStepIdx += g_u16MotorMicroStepsPerElecRotation;
+		}
+		g_u16MicroStepIdx -= l_u16MicroStepStride;
+	}
+	else
+	{
+		/* Increment the PWM vector pointer by the micro-step stride */
+		g_u16MicroStepIdx += l_u16MicroStepStride;
+		if ( g_u16MicroStepIdx >= g_u16MotorMicroStepsPerElecRotation )
+		{
+			g_u16MicroStepIdx -= g_u16MotorMicroStepsPerElecRotation;
+		}
+	}
+#else  /* _SUPPORT_USTEP_ADAPTIVE */
 	{
 		/* Motor Direction Inverse */
 		if(NVRAM_MOTOR_DIR_INV != 0u)
@@ -1696,6 +2024,7 @@ __interrupt__ void EXT0_IT(void)
 			}
 		}
 	}
+#endif /* _SUPPORT_USTEP_ADAPTIVE */
 
 	/* Check for speed update required */
 	if ( g_u16CommutTimerPeriod == g_u16TargetCommutTimerPeriod )
@@ -1705,14 +2034,56 @@ __interrupt__ void EXT0_IT(void)
 	else
 	{
 		/* Update speed */
+#if _SUPPORT_RAMP_TABLE
+		uint16 u16Compensation = g_u16CommutTimerPeriod;
+#else  /* _SUPPORT_RAMP_TABLE */
 		uint16 u16Compensation = l_u16SpeedRPM;							/* MMP160606-1 */
+#endif /* _SUPPORT_RAMP_TABLE */
 		if ( g_u16CommutTimerPeriod < g_u16TargetCommutTimerPeriod )
 		{
 			/* Deceleration per micro-step */
 			g_u8MotorStartupMode = (uint8) MSM_STEPPER_D;					/* Too fast, decelerate */
+#if _SUPPORT_USTEP_ADAPTIVE
+			/* One deceleration step per micro-step of the stride */
+			if ( l_u8VTIdx > l_u8VTIdxMax )
+			{
+				/* Beyond velocity-timer table */
+				l_u16SpeedRPM = l_u16SpeedRPM - (l_u16MicroStepStride * divU16_U32byU16( (uint32) 2*NVRAM_ACCELERATION_CONST, l_u16SpeedRPM));
+				g_u16CommutTimerPeriod = divU16_U32byU16( l_u32Temp, l_u16SpeedRPM) - 1u;
+			}
+			if ( l_u8VTIdx > l_u16MicroStepStride )
+			{
+				l_u8VTIdx = (uint8) (l_u8VTIdx - l_u16MicroStepStride);
+			}
+			else
+			{
+				l_u8VTIdx = 0u;
+			}
+			if ( l_u8VTIdx <= l_u8VTIdxMax )
+			{
+				g_u16CommutTimerPeriod = l_au16VelocityTimer[l_u8VTIdx];
+			}
+#elif _SUPPORT_RAMP_TABLE
+			if ( l_u8VTIdx > l_u8VTIdxMax )
+			{
+				/* Beyond velocity-timer table */
+				l_u16SpeedRPM = l_u16SpeedRPM - divU16_U32byU16( (uint32) 2*NVRAM_ACCELERATION_CONST, l_u16SpeedRPM);
+				g_u16CommutTimerPeriod = divU16_U32byU16( l_u32Temp, l_u16SpeedRPM) - 1u;
+				l_u8VTIdx--;
+			}
+			else
+			{
+				if ( l_u8VTIdx != 0u )
+				{
+					l_u8VTIdx--;
+				}
+				g_u16CommutTimerPeriod = l_au16VelocityTimer[l_u8VTIdx];
+			}
+#else  /* _SUPPORT_RAMP_TABLE */
 			l_u16SpeedRPM = l_u16SpeedRPM - divU16_U32byU16( (uint32) 2*NVRAM_ACCELERATION_CONST, l_u16SpeedRPM);	/* MMP160606-1 */
 			g_u16CommutTimerPeriod = divU16_U32byU16( l_u32Temp, l_u16SpeedRPM) - 1u;	/* MMP160606-1 */
 			l_u8VTIdx--;
+#endif /* _SUPPORT_RAMP_TABLE */
 			if ( g_u16StartupDelay < l_u8VTIdx )
 			{
 				g_u16StartupDelay = l_u16StartupDelayInit;						/* MMP130627-1/MMP140331-2: Speed reduction, stall detection post-poned */
@@ -1723,7 +2094,11 @@ __interrupt__ void EXT0_IT(void)
 			}
 			TMR1_REGB = g_u16CommutTimerPeriod;
 #if (_SUPPORT_PWM_DC_RAMPDOWN != FALSE)											/* MMP140903-2 - Begin */
+#if _SUPPORT_RAMP_TABLE
+			g_u16PidCtrlRatio = muldivU16_U16byU16byU16( g_u16PidCtrlRatio, u16Compensation, g_u16CommutTimerPeriod);	/* Speed-ratio = inverse period-ratio */
+#else  /* _SUPPORT_RAMP_TABLE */
 			g_u16PidCtrlRatio = muldivU16_U16byU16byU16( g_u16PidCtrlRatio, l_u16SpeedRPM, u16Compensation);	/* MMP160606-2 */
+#endif /* _SUPPORT_RAMP_TABLE */
 			g_u16PID_I = g_u16PidCtrlRatio;
 #endif /* (_SUPPORT_PWM_DC_RAMPDOWN != FALSE) */								/* MMP140903-2 - Begin */
 
@@ -1732,16 +2107,74 @@ __interrupt__ void EXT0_IT(void)
 		{
 			/* Acceleration per acceleration_points ((multiple) full-step) */
 			g_u8MotorStartupMode = (uint8) MSM_STEPPER_A;						/* Too slow, accelerate */
+#if _SUPPORT_USTEP_ADAPTIVE
+			/* One acceleration step per acceleration-points of the stride */
+			uint16 u16RampSteps = l_u16MicroStepStride / (NVRAM_ACCELERATION_POINTS + 1u);
+			if ( u16RampSteps == 0u )
+			{
+				u16RampSteps = 1u;
+			}
+			if ( l_u8VTIdx < l_u8VTIdxMax )
+			{
+				l_u8VTIdx = (uint8) (l_u8VTIdx + u16RampSteps);
+				if ( l_u8VTIdx > l_u8VTIdxMax )
+				{
+					l_u8VTIdx = l_u8VTIdxMax;
+				}
+				g_u16CommutTimerPeriod = l_au16VelocityTimer[l_u8VTIdx];
+			}
+#if _SUPPORT_RAMP_SCURVE
+			else if ( l_u8VTIdxCapped == FALSE )								/* Distance limited table: hold the speed */
+#else  /* _SUPPORT_RAMP_SCURVE */
+			else
+#endif /* _SUPPORT_RAMP_SCURVE */
+			{
+				/* Target speed beyond velocity-timer table (e.g. changed while running) */
+				if ( l_u8VTIdx == l_u8VTIdxMax )
+				{
+					l_u16SpeedRPM = l_u16VTSpeedRPM;
+				}
+				l_u16SpeedRPM = l_u16SpeedRPM + (u16RampSteps * divU16_U32byU16( (uint32) 2*NVRAM_ACCELERATION_CONST, l_u16SpeedRPM));
+				g_u16CommutTimerPeriod = divU16_U32byU16( l_u32Temp, l_u16SpeedRPM) - 1u;
+				l_u8VTIdx = (uint8) (l_u8VTIdx + u16RampSteps);
+			}
+#elif _SUPPORT_RAMP_TABLE
+			if ( l_u8VTIdx < l_u8VTIdxMax )
+			{
+				l_u8VTIdx++;
+				g_u16CommutTimerPeriod = l_au16VelocityTimer[l_u8VTIdx];
+			}
+#if _SUPPORT_RAMP_SCURVE
+			else if ( l_u8VTIdxCapped == FALSE )								/* Distance limited table: hold the speed */
+#else  /* _SUPPORT_RAMP_SCURVE */
+			else
+#endif /* _SUPPORT_RAMP_SCURVE */
+			{
+				/* Target speed beyond velocity-timer table (e.g. changed while running) */
+				if ( l_u8VTIdx == l_u8VTIdxMax )
+				{
+					l_u16SpeedRPM = l_u16VTSpeedRPM;
+				}
+				l_u16SpeedRPM = l_u16SpeedRPM + divU16_U32byU16( (uint32) 2*NVRAM_ACCELERATION_CONST, l_u16SpeedRPM);
+				g_u16CommutTimerPeriod = divU16_U32byU16( l_u32Temp, l_u16SpeedRPM) - 1u;
+				l_u8VTIdx++;
+			}
+#else  /* _SUPPORT_RAMP_TABLE */
 			l_u16SpeedRPM = l_u16SpeedRPM + divU16_U32byU16( (uint32) 2*NVRAM_ACCELERATION_CONST, l_u16SpeedRPM);	/* MMP160606-1 */
 			g_u16CommutTimerPeriod = divU16_U32byU16( l_u32Temp, l_u16SpeedRPM) - 1u;	/* MMP160606-1 */
 			l_u8VTIdx++;
+#endif /* _SUPPORT_RAMP_TABLE */
 			if ( g_u16CommutTimerPeriod < g_u16TargetCommutTimerPeriod )		/* MMP150923-1 */
 			{
 				g_u16CommutTimerPeriod = g_u16TargetCommutTimerPeriod;
 			}
 			TMR1_REGB = g_u16CommutTimerPeriod;
 #if (_SUPPORT_PWM_DC_RAMPUP != FALSE)											/* MMP140903-2 - Begin */
+#if _SUPPORT_RAMP_TABLE
+			g_u16PidCtrlRatio = muldivU16_U16byU16byU16( g_u16PidCtrlRatio, u16Compensation, g_u16CommutTimerPeriod);	/* Speed-ratio = inverse period-ratio */
+#else  /* _SUPPORT_RAMP_TABLE */
 			g_u16PidCtrlRatio = muldivU16_U16byU16byU16( g_u16PidCtrlRatio, l_u16SpeedRPM, u16Compensation);	/* MMP160606-2 */
+#endif /* _SUPPORT_RAMP_TABLE */
 			g_u16PID_I = g_u16PidCtrlRatio;
 #endif /* (_SUPPORT_PWM_DC_RAMPUP != FALSE) */									/* MMP140903-2 - End */
 		}
@@ -1751,10 +2184,50 @@ __interrupt__ void EXT0_IT(void)
 		}
 	}
 
+#if _SUPPORT_USTEP_ADAPTIVE
+	/* Micro-step stride of the next commutation: doubled while the commutation ISR period
+	 * would be shorter than C_USTEP_ADAPTIVE_MIN_PERIOD, halved when half the stride is
+	 * long enough. Only doubled at a stride-aligned index, so the vectors stay on the
+	 * same micro-step grid (electric angle preserved); never beyond the target-position. */
+	{
+		uint32 u32IsrPeriod = mulU32_U16byU16( g_u16CommutTimerPeriod + 1u, l_u16MicroStepStride);
+		if ( (u32IsrPeriod < C_USTEP_ADAPTIVE_MIN_PERIOD) && (l_u16MicroStepStride < C_USTEP_ADAPTIVE_MAX_STRIDE) &&
+			((g_u16MicroStepIdx & ((l_u16MicroStepStride << 1u) - 1u)) == 0u) )
+		{
+			l_u16MicroStepStride <<= 1u;
+		}
+		else if ( (l_u16MicroStepStride > 1u) && ((u32IsrPeriod >> 1u) >= C_USTEP_ADAPTIVE_MIN_PERIOD) )
+		{
+			l_u16MicroStepStride >>= 1u;
+		}
+		else
+		{
+			/* MISRA C:2012 Rule-15.7:All if ... else if constructs shall be terminated with an else statement */
+		}
+		while ( l_u16MicroStepStride > u16DeltaPosition )
+		{
+			l_u16MicroStepStride >>= 1u;
+		}
+		TMR1_REGB = (uint16) mulU32_U16byU16( g_u16CommutTimerPeriod + 1u, l_u16MicroStepStride) - 1u;
+	}
+#endif /* _SUPPORT_USTEP_ADAPTIVE */
+
 	VoltageCorrection();
 
 	MotorDriver_4PhaseStepper();
 	
+#if _SUPPORT_COMMUT_BOTTOM_HALF
+	/* Current measurement, open-coil and stall detection by Commutation_BottomHalf_ISR() */
+	if ( l_u8CommutBottomHalfPending != FALSE )
+	{
+		g_u16CommutBottomHalfOverrun++;											/* Previous bottom-half not handled within one commutation period */
+	}
+	else
+	{
+		l_u8CommutBottomHalfPending = TRUE;
+		VARIOUS_L |= SWI;														/* Request SOFT_IT */
+	}
+#else  /* _SUPPORT_COMMUT_BOTTOM_HALF */
 #if _SUPPORT_STALLDET_A
 	if ( MotorStallCheckA() != (uint16) C_STALL_NOT_FOUND )						/* Stall-detector "A" */
 	{
@@ -1777,10 +2250,80 @@ __interrupt__ void EXT0_IT(void)
 		MotorDriverStop( (uint16) C_STOP_EMERGENCY);							/* ... stop motor (Stall) */
 	}
 #endif /* _SUPPORT_STALLDET_H */
+#endif /* _SUPPORT_COMMUT_BOTTOM_HALF */
 
+	PROFILER_STOP( PROFILE_EXT0_IT);
 #if _DEBUG_COMMUT_ISR
 	DEBUG_CLR_IO_B();
 #endif /* _DEBUG_COMMUT_ISR */
 } /* End of Commutation_ISR() */
+
+/* ****************************************************************************	*
+ * Commutation_BottomHalf_ISR()
+ *
+ * Software interrupt (lowest priority), requested by the Commutation_ISR() after
+ * the PWM update of each micro-step. Performs the non time-critical part of the
+ * commutation: current measurement, open-coil check and stall detection.
+ * LIN communication, Commutation_ISR() and diagnostics can pre-empt this ISR.
+ * The bottom-half must be handled within one commutation period; otherwise
+ * the next request is skipped and g_u16CommutBottomHalfOverrun is incremented.
+ * Latency: SOFT_IT is requested at level 7 and runs at priority 6; It pre-empts
+ * the main-loop (priority 7) at once, except within an ATOMIC_CODE() section.
+ * Bound: Longest main-loop atomic section plus the run-time of the pending
+ * higher priority ISR's (EXT4_IT 3, EXT0_IT/EXT1_IT 4, ADC_IT 5, LIN 5,
+ * TIMER_IT 6). A stall stop is done atomically: Commutation_ISR() never runs
+ * against a partly stopped motor driver.
+ * ****************************************************************************	*/
+__interrupt__ void SOFT_IT(void)
+{
+#if _SUPPORT_COMMUT_BOTTOM_HALF
+	PROFILER_START();
+
+	if ( g_u8MotorStartupMode != (uint8) MSM_STOP )
+	{
+		uint16 u16StallFound = 0u;
+
+		/* Current measurement used for Stall-detector "A" and current control (PID) */
+		MotorDriverCurrentMeasure();
+
+		/* open coil detection */
+		(void)MotorDiagnosticOpenCheck();
+
+#if _SUPPORT_STALLDET_A
+		if ( MotorStallCheckA() != (uint16) C_STALL_NOT_FOUND )					/* Stall-detector "A" */
+		{
+			u16StallFound |= (uint16)C_STALL_FOUND_A;
+		}
+#endif
+#if _SUPPORT_STALLDET_O
+		if ( MotorStallCheckO() != (uint16)C_STALL_NOT_FOUND )					/* Stall-detector "O" (MMP140428-1) */
+		{
+			u16StallFound |= (uint16)C_STALL_FOUND_O;
+		}
+#endif /* _SUPPORT_STALLDET_O */
+#if _SUPPORT_STALLDET_H
+		/* Stall detection based on hall-sensor(s) */
+		if ( MotorStallCheckH() != (uint16) C_STALL_NOT_FOUND )					/* Stall-detector "H" */
+		{
+			u16StallFound |= (uint16)C_STALL_FOUND_H;
+		}
+#endif /* _SUPPORT_STALLDET_H */
+		if ( u16StallFound != 0u )
+		{
+			/* Not pre-empted by the Commutation_ISR() */
+			ATOMIC_CODE
+			(
+				g_sMotorFault.ST |= u16StallFound;
+				MotorDriverStop( (uint16) C_STOP_EMERGENCY);					/* ... stop motor (Stall) */
+			);
+		}
+	}
+	l_u8CommutBottomHalfPending = FALSE;
+	PROFILER_STOP( PROFILE_SOFT_IT);
+#else  /* _SUPPORT_COMMUT_BOTTOM_HALF */
+	asm( "mov yl, #18");
+	_fatal();
+#endif /* _SUPPORT_COMMUT_BOTTOM_HALF */
+} /* End of Commutation_BottomHalf_ISR() */
   
 /* EOF */
@@ -121,6 +121,7 @@ enum TACHO_MODES
 #define NVRAM_MOTOR_COIL_RTOT				((uint16) MotorParams.MotorCoilRtot)
 
 #define NVRAM_MICRO_STEPS					((uint16) 1u << MotorParams.MicroSteps)
+#define NVRAM_MICRO_STEPS_SHIFT				((uint16) MotorParams.MicroSteps)
 #define NVRAM_MOTOR_DIR_INV					((uint16) MotorParams.MotorDirectionINV)
 #define NVRAM_TACHO_MODE					((uint16) MotorParams.TachoMode)
 
@@ -212,6 +213,7 @@ enum TACHO_MODES
 #define NVRAM_MOTOR_COIL_RTOT				((uint16) C_COILS_RTOT)
 
 #define NVRAM_MICRO_STEPS					((uint16) 1u << MOTOR_MICROSTEPS)				/* Must be shift-factor */
+#define NVRAM_MICRO_STEPS_SHIFT				((uint16) MOTOR_MICROSTEPS)
 #define NVRAM_MOTOR_DIR_INV					((uint16) MOTOR_DIR_INV)
 #define NVRAM_TACHO_MODE					((uint16) C_TACHO_MODE)
 
@@ -291,6 +293,23 @@ enum TACHO_MODES
 #define C_MOTOR_HALL_REBOUND_STEP_MIN		(1u * C_MICROSTEP_PER_FULLSTEP)
 #define C_MOTOR_HALL_REBOUND_STEO_MAX		(3u * C_MICROSTEP_PER_FULLSTEP)
 
+/* Load-adaptive running current; Rotor-lag at the hall-edges [1/256 full-step] */
+#define C_HALL_EDGE_PHASE					112u									/* Field phase within a full-step at a hall-edge with zero rotor-lag (7/16 FS; hall-sensor mounting); Simulator value, to be measured on the target mechanics before _SUPPORT_LOAD_ADAPTIVE_CURRENT is enabled */
+#define C_HALL_LAG_LOW						64u										/* Below 1/4 FS (22.5 degrees electric): Decrease running current */
+#define C_HALL_LAG_HIGH						96u										/* Above 3/8 FS (33.75 degrees electric): Increase running current */
+#define C_HALL_LAG_WRAP						192u									/* Lag modulo full-step; Above 3/4 FS taken as lead */
+
+/* Acceleration/deceleration table (velocity-timer values) */
+#define VT_BUF_SZ							64u										/* Commutation-timer periods, indexed by l_u8VTIdx */
+#define C_RAMP_JERK_SHIFT					3u										/* S-curve: 8 (1 << 3) ramp steps from zero to full acceleration (1..4) */
+#if (C_RAMP_JERK_SHIFT < 1u) || (C_RAMP_JERK_SHIFT > 4u)
+#error "ERROR: C_RAMP_JERK_SHIFT out of range (1..4)"
+#endif
+
+/* Speed-adaptive micro-step stride */
+#define C_USTEP_ADAPTIVE_MIN_PERIOD			((uint16) (TIMER_CLOCK / 2000UL))		/* Minimum commutation ISR period: 500us (2kHz) */
+#define C_USTEP_ADAPTIVE_MAX_STRIDE			C_MICROSTEP_PER_FULLSTEP				/* Coarsest stride: full-step */
+
 /* Motor running average filter length:4FS */
 #define C_MOVAVG_SZ							((uint16)1u << C_MOVAVG_SSZ)		
 
@@ -336,6 +355,12 @@ typedef struct
 #pragma space dp
 extern volatile uint16 g_u16CorrectionRatio;									/* Motor correction ratio, depend on temperature and voltage */
 extern uint16 g_u16MicroStepIdx;												/* (Micro)step index */
+#if _SUPPORT_USTEP_ADAPTIVE
+extern uint16 l_u16MicroStepStride;												/* Micro-steps per commutation (1, 2, 4 .. full-step) */
+#endif /* _SUPPORT_USTEP_ADAPTIVE */
+#if _SUPPORT_HALL_TMR2_CAPTURE
+extern uint16 g_u16CommutTimeStamp;												/* Timer2 time-stamp of the last commutation */
+#endif /* _SUPPORT_HALL_TMR2_CAPTURE */
 extern uint16 g_u16CommutTimerPeriod;											/* (Actual) commutation timer period (Commutation-ISR) */
 extern uint16 g_u16TargetCommutTimerPeriod;										/* Target commutation timer period (target speed) */
 extern uint16 g_u16StartupDelay;
@@ -364,6 +389,9 @@ extern uint8 g_u8MotorStartupMode;
 extern uint8 g_u8ValveInitState;
 extern uint8 g_u8MotorStatusSpeed;						/* (Status) Actual motor-speed */
 
+#if _SUPPORT_COMMUT_BOTTOM_HALF
+extern uint16 g_u16CommutBottomHalfOverrun;										/* Number of commutations with bottom-half still pending */
+#endif /* _SUPPORT_COMMUT_BOTTOM_HALF */
 extern uint16 g_u16falg;
 extern uint16 g_u16PosFlag;
 
@@ -29,6 +29,7 @@
 #include "MotorDriver.h"
 #include "MotorParams.h"
 #include "MotorDriverTables.h"
+#include <mathlib.h>															/* Use Melexis math-library functions to avoid compiler warnings */
 
 #define   Q15(A)      (int16) ((A) * 32768.0)
 
@@ -73,6 +74,62 @@ uint8 const c_au8DrvCfgSelfTestB4[10] =											/* MMP130916-2 */
 #define SPACE_VECTOR_FIFTH_SINUS		FALSE									/* 43mA  4-5% extra vs. SPACE_VECTOR_TRIPPLE_SINUS */
 #define SPACE_VECTOR_TRAPIZE			FALSE									/* 48mA  */
 #define SPACE_VECTOR_BLOCK				FALSE									/* 58mA  */
+#if _SUPPORT_USTEP_QUARTER_WAVE
+#if (SPACE_VECTOR_SINUS == FALSE)
+#error "ERROR: Quarter-wave micro-step table only supports the SPACE_VECTOR_SINUS waveform"
+#endif /* (SPACE_VECTOR_SINUS == FALSE) */
+#if (MOTOR_PARAMS == MP_CONST) && ((MOTOR_MICROSTEPS < 2u) || (MOTOR_MICROSTEPS > 7u))
+#error "ERROR: Quarter-wave micro-step table supports 4 to 128 micro-steps per full-step"
+#endif /* (MOTOR_PARAMS == MP_CONST) */
+/* *** Quarter-wave, sinus-waveform; [n] = sin(n * 2.8125 degrees) *** */
+int16 const c_ai16MicroStepQuarterWave[SZ_MICRO_VECTOR_QUARTER_WAVE] =
+{
+	Q15(0.000000),	Q15(0.049068),	Q15(0.098017),	Q15(0.146730),				/* [ 0: 3] */
+	Q15(0.195090),	Q15(0.242980),	Q15(0.290285),	Q15(0.336890),				/* [ 4: 7] */
+	Q15(0.382683),	Q15(0.427555),	Q15(0.471397),	Q15(0.514103),				/* [ 8:11] */
+	Q15(0.555570),	Q15(0.595699),	Q15(0.634393),	Q15(0.671559),				/* [12:15] */
+	Q15(0.707107),	Q15(0.740951),	Q15(0.773010),	Q15(0.803208),				/* [16:19] */
+	Q15(0.831470),	Q15(0.857729),	Q15(0.881921),	Q15(0.903989),				/* [20:23] */
+	Q15(0.923880),	Q15(0.941544),	Q15(0.956940),	Q15(0.970031),				/* [24:27] */
+	Q15(0.980785),	Q15(0.989177),	Q15(0.995185),	Q15(0.998795),				/* [28:31] */
+	Q15(0.999969)																/* [32]    */
+};
+
+/* ****************************************************************************	*
+ * MotorDriver_MicroStepVector4PH
+ *
+ * Returns the Q15 coil-vector of a micro-step (0 .. 5/4 electric period).
+ * The quarter-wave table is mirrored (2nd/4th quadrant) and negated (3rd/4th
+ * quadrant); the half-step offset position (2n+1)/(2N) is interpolated between
+ * two table entries. Entries are exact up to 16 micro-steps per full-step.
+ * ****************************************************************************	*/
+int16 MotorDriver_MicroStepVector4PH( uint16 u16MicroStepIdx)
+{
+	const int16 *pi16Vector;
+	int16 i16Vector;
+	uint16 u16Pos = u16MicroStepIdx & (C_MICROSTEP_PER_FULLSTEP - 1u);
+	if ( (u16MicroStepIdx & C_MICROSTEP_PER_FULLSTEP) != 0u )
+	{
+		/* 2nd and 4th Quadrant: mirrored */
+		u16Pos = (C_MICROSTEP_PER_FULLSTEP - 1u) - u16Pos;
+	}
+	/* Position in 1/256 table-intervals; Quarter-wave = 32 * 256 = (1 << 13) */
+	u16Pos = ((u16Pos << 1u) + 1u) << (12u - NVRAM_MICRO_STEPS_SHIFT);
+	pi16Vector = &c_ai16MicroStepQuarterWave[u16Pos >> 8u];
+	i16Vector = pi16Vector[0];
+	u16Pos &= 0xFFu;
+	if ( u16Pos != 0u )
+	{
+		i16Vector += (int16) (mulI32_I16byU16( pi16Vector[1] - pi16Vector[0], u16Pos) >> 8u);
+	}
+	if ( (u16MicroStepIdx & (2u * C_MICROSTEP_PER_FULLSTEP)) != 0u )
+	{
+		/* 3rd and 4th Quadrant: negative */
+		i16Vector = -i16Vector;
+	}
+	return ( i16Vector );
+} /* End of MotorDriver_MicroStepVector4PH() */
+#else  /* _SUPPORT_USTEP_QUARTER_WAVE */
 /* *** 4-phase, 32-steps per rotation, sinus-waveform *** */
 int16 const c_ai16MicroStepVector4PH[SZ_MICRO_VECTOR_TABLE_4PH] =
 {
@@ -294,5 +351,6 @@ int16 const c_ai16MicroStepVector4PH[SZ_MICRO_VECTOR_TABLE_4PH] =
 #endif /* SPACE_VECTOR_BLOCK */
 #endif /* (_SUPPORT_DOUBLE_USTEP == FALSE) */
 };
+#endif /* _SUPPORT_USTEP_QUARTER_WAVE */
 
 /* EOF */
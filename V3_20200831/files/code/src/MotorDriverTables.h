@@ -29,5 +29,12 @@ extern uint8 const c_au8DrvCfgSelfTestA[8];
 extern uint16 const c_au16DrvAdcSelfTestA[4][2];								/* MMP130919-1 */
 
 extern uint8 const c_au8DrvCfgSelfTestB4[10];									/* MMP130916-2 */
+#if _SUPPORT_USTEP_QUARTER_WAVE
+extern int16 const c_ai16MicroStepQuarterWave[SZ_MICRO_VECTOR_QUARTER_WAVE];
+extern int16 MotorDriver_MicroStepVector4PH( uint16 u16MicroStepIdx);
+#define MICRO_STEP_VECTOR_4PH(idx)		MotorDriver_MicroStepVector4PH(idx)
+#else  /* _SUPPORT_USTEP_QUARTER_WAVE */
 extern int16 const c_ai16MicroStepVector4PH[SZ_MICRO_VECTOR_TABLE_4PH];
+#define MICRO_STEP_VECTOR_4PH(idx)		c_ai16MicroStepVector4PH[idx]
+#endif /* _SUPPORT_USTEP_QUARTER_WAVE */
 
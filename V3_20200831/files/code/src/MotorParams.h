@@ -266,6 +266,7 @@ typedef struct
  * ****************************************************************************	*/
 //#define SZ_MICRO_VECTOR_TABLE_4PH	80		/* 2*2*16uStep * (1 + 1/4) */
 #define SZ_MICRO_VECTOR_TABLE_4PH	40		/* 2*2*8uStep*(1 + 1/4) */
+#define SZ_MICRO_VECTOR_QUARTER_WAVE	33		/* 32 intervals of 2.8125 degrees (0..90 degrees) */
 
 #pragma space nodp
 extern MOTOR_CALIBPARAMS MotorParams;
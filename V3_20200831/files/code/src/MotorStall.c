@@ -344,7 +344,7 @@ uint16 MotorStallCheckH( void)
 				u16DeltaPosition = l_u16HallMicroStepIdxPre - g_u16HallMicroStepIdx;
 			}
 			/* Normal 6 full steps for one hall signal. */
-			if((u16DeltaPosition <= ((uint16)10)) || (u16DeltaPosition >= ((uint16)22)))
+			if((u16DeltaPosition <= ((uint16)C_STALL_H_EDGE_MIN)) || (u16DeltaPosition >= ((uint16)C_STALL_H_EDGE_MAX)))
 			{
 				g_u16falg += 1;
 				l_u8StallCountReboundH++;
@@ -34,6 +34,10 @@
 #define C_STALL_FOUND				0x01
 #define C_STALL_NOT_FOUND			0x00
 
+/* Stall "H" rebound: Micro-steps between two hall-edges <= MIN or >= MAX */
+#define C_STALL_H_EDGE_MIN			10u
+#define C_STALL_H_EDGE_MAX			22u
+
 /* ****************************************************************************	*
  *	P u b l i c   f u n c t i o n s												*
  * ****************************************************************************	*/
@@ -12,7 +12,23 @@
  * \functions	NVRAM_CRC8()
  *				NVRAM_CountCRC8()
  *				NVRAM_PageVerify()
+ *				NVRAM_RecordInitPage()
+ *				NVRAM_RecordUpdate()
+ *				NVRAM_RecordCheck()
+ *				NVRAM_RecordRange()
+ *				NVRAM_WaitReady()
+ *				NVRAM_CommitPage()
  *				NVRAM_Store()
+ *				NVRAM_MainFunction()
+ *				NVRAM_Flush()
+ *				NVRAM_GetCacheStats()
+ *				NVRAM_LogSlot()
+ *				NVRAM_LogCheck()
+ *				NVRAM_LogFreeSlot()
+ *				NVRAM_LogCommitted()
+ *				NVRAM_LogMount()
+ *				NVRAM_LogPut()
+ *				NVRAM_LogGet()
  *				NVRAM_LoadUserPage()
  *				PlaceError()
  *				NVRAM_LogError()
@@ -38,6 +54,10 @@
 #include "LIN_Protocol.h"														/* LIN configuration default */
 #include "MotorParams.h"														/* Motor-driver support */
 #include "ErrorCodes.h"															/* Error-logging support */
+#if _SUPPORT_NVRAM_WRITE_BACK
+#include "MotorDriver.h"														/* Idle point: Motor stopped */
+#include "Timer.h"																/* Commit delay */
+#endif /* _SUPPORT_NVRAM_WRITE_BACK */
 
 
 /* ****************************************************************************	*
@@ -48,7 +68,25 @@
 #pragma space none
 
 #pragma space nodp
-
+#if _SUPPORT_NVRAM_RECORD_CRC
+uint8 l_au8NvramRecordChecked[2];												/* Per user-page: Bit n: Record #n checked (deferred from NVRAM_Init()) */
+uint8 g_u8NvramRecordErrors = 0u;												/* Records found corrupted (and cleared), saturated */
+#endif /* _SUPPORT_NVRAM_RECORD_CRC */
+#if _SUPPORT_NVRAM_WRITE_BACK
+uint8 g_u8NvramDirtyPages = 0u;													/* C_NVRAM_USER_PAGE_x: Shadow-RAM changed, not yet programmed */
+uint16 l_u16NvramFirstChange;													/* Tick-counter at the first change since the last commit */
+uint16 l_u16NvramLastChange;													/* Tick-counter at the last change */
+NVRAM_CACHE_STATS l_sNvramCacheStats;											/* Write-back cache statistics */
+#endif /* _SUPPORT_NVRAM_WRITE_BACK */
+#if _SUPPORT_NVRAM_LOG
+uint16 l_u16NvramLogSequence;													/* Sequence-number of the newest record */
+uint8 l_u8NvramLogHead;															/* Slot of the newest record */
+uint8 l_au8NvramLogTagSlot[C_NVRAM_LOG_TAGS];									/* Slot of the newest record per tag (C_NVRAM_LOG_NONE: None) */
+#if _SUPPORT_NVRAM_WRITE_BACK
+uint8 l_au8NvramLogTagCommitted[C_NVRAM_LOG_TAGS];								/* Slot of the newest programmed record per tag (C_NVRAM_LOG_NONE: None) */
+uint16 l_u16NvramLogUncommitted = 0u;											/* Bit n: Slot #n written, its user-page not yet programmed */
+#endif /* _SUPPORT_NVRAM_WRITE_BACK */
+#endif /* _SUPPORT_NVRAM_LOG */
 #pragma space none
 
 const NVRAM_PAGEINTEGRITY PageIntegerityDefault = 
@@ -63,6 +101,25 @@ uint8 NVRAM_CRC8( const uint16 *pRAM, uint16 size);
 /* error log */
 uint8 NVRAM_CountCRC8( PNVRAM_ERRORLOG pNVERRLOG, uint8 byReplaceCRC);
 void PlaceError( uint16 *pu16ErrorElement, uint16 u16OddEven, uint8 u8ErrorCode);
+static void NVRAM_CommitPage( uint16 u16Page, uint16 u16Wait);
+#if _SUPPORT_NVRAM_LOG && _SUPPORT_NVRAM_WRITE_BACK
+static void NVRAM_LogCommitted( void);
+#endif /* _SUPPORT_NVRAM_LOG && _SUPPORT_NVRAM_WRITE_BACK */
+#if _SUPPORT_NVRAM_RECORD_CRC
+static void NVRAM_RecordInitPage( uint16 u16PageIdx);
+static void NVRAM_RecordUpdate( uint16 *pPage, uint16 u16Record);
+static void NVRAM_RecordCheck( uint16 u16PageIdx, uint16 u16Record);
+static void NVRAM_RecordRange( uint16 u16PageIdx, uint16 u16Word, uint16 u16Size, uint16 u16Update);
+#endif /* _SUPPORT_NVRAM_RECORD_CRC */
+#if _SUPPORT_NVRAM_WRITE_BACK
+static void NVRAM_MarkDirty( uint16 u16Page);
+#endif /* _SUPPORT_NVRAM_WRITE_BACK */
+#if _SUPPORT_NVRAM_LOG
+static PNVRAM_LOG_RECORD NVRAM_LogSlot( uint16 u16Slot);
+static uint8 NVRAM_LogCheck( const NVRAM_LOG_RECORD *pRecord);
+static uint16 NVRAM_LogFreeSlot( void);
+static void NVRAM_LogMount( void);
+#endif /* _SUPPORT_NVRAM_LOG */
 
 
 /***********************public functions ***************************/
@@ -75,8 +132,18 @@ void NVRAM_Init(void)
 	uint8  u8CRC;
 	
 	/* dump to memory */
+	NVRAM_WaitReady();															/* Not while a page program is in progress */
 	NVRAM_LoadAll();
 	u16ErrorFlag = (VARIOUS_L & EENV_DED);										/* Double-bit error state */
+#if _SUPPORT_NVRAM_RECORD_CRC
+	/* Structure-revision only; The records are checked at first use (or by NVRAM_MainFunction()) */
+	(void) pMRAM;
+	(void) pIntegrity;
+	(void) i;
+	(void) u8CRC;
+	NVRAM_RecordInitPage( 0u);
+	NVRAM_RecordInitPage( 1u);
+#else  /* _SUPPORT_NVRAM_RECORD_CRC */
 	/* Check Double-bit NVRAM set, User-NVRAM structure-revision and User-NVRAM Checksum */
 	/* 1.check user page 1,if fail use default */
 	pMRAM = (uint16 *)C_ADDR_USERPAGE1;
@@ -110,7 +177,10 @@ void NVRAM_Init(void)
 			pMRAM[i] = 0xFFFFu;
 		}
 	}
-
+#endif /* _SUPPORT_NVRAM_RECORD_CRC */
+#if _SUPPORT_NVRAM_LOG
+	NVRAM_LogMount();
+#endif /* _SUPPORT_NVRAM_LOG */
 }
 
 
@@ -123,6 +193,9 @@ uint8 NVRAM_Read(uint16 addr,uint16 buf[],uint16 size)
 	if((addr >= C_NVRAM_AREA1_ADDR) && ((addr + size) < (C_NVRAM_AREA1_ADDR + C_NVRAM_AREA1_SIZE) ))
 	{
 		pMRAM = (uint16 *)C_ADDR_USERPAGE1 + sizeof(NVRAM_PAGEINTEGRITY)/sizeof(uint16) + addr - C_NVRAM_AREA1_ADDR;
+#if _SUPPORT_NVRAM_RECORD_CRC
+		NVRAM_RecordRange( 0u, (uint16) (pMRAM - (uint16 *) C_ADDR_USERPAGE1), size, FALSE);
+#endif /* _SUPPORT_NVRAM_RECORD_CRC */
 		for(i = 0;i < size;i++)
 		{
 			buf[i] = pMRAM[i];
@@ -131,6 +204,9 @@ uint8 NVRAM_Read(uint16 addr,uint16 buf[],uint16 size)
 	else if((addr >= C_NVRAM_AREA2_ADDR) && ((addr + size) < (C_NVRAM_AREA2_ADDR + C_NVRAM_AREA2_SIZE)))
 	{
 		pMRAM = (uint16 *)C_ADDR_USERPAGE2 + sizeof(NVRAM_PAGEINTEGRITY)/sizeof(uint16) + addr - C_NVRAM_AREA2_ADDR;
+#if _SUPPORT_NVRAM_RECORD_CRC
+		NVRAM_RecordRange( 1u, (uint16) (pMRAM - (uint16 *) C_ADDR_USERPAGE2), size, FALSE);
+#endif /* _SUPPORT_NVRAM_RECORD_CRC */
 		for(i = 0;i < size;i++)
 		{
 			buf[i] = pMRAM[i];
@@ -148,17 +224,28 @@ uint8 NVRAM_Read(uint16 addr,uint16 buf[],uint16 size)
 uint8 NVRAM_Write(uint16 addr,const uint16 buf[],uint16 size)
 {
 	uint16  *pMRAM;
-	uint8  u8VerifyRes,u8CRC8;
-	PNVRAM_PAGEINTEGRITY pIntegrity;
+	uint8  u8VerifyRes;
 	uint16  i;
 	uint8  ret = NVRAM_E_OK;
+#if _SUPPORT_NVRAM_RECORD_CRC
+	uint16 u16Word;
+#endif /* _SUPPORT_NVRAM_RECORD_CRC */
 
 	/* address should be even */	
 	if((addr >= C_NVRAM_AREA1_ADDR) && ((addr + size) < (C_NVRAM_AREA1_ADDR + C_NVRAM_AREA1_SIZE)))
 	{
 		pMRAM = (uint16 *)C_ADDR_USERPAGE1 + sizeof(NVRAM_PAGEINTEGRITY) / sizeof(uint16) + (addr - C_NVRAM_AREA1_ADDR);
+#if _SUPPORT_NVRAM_RECORD_CRC
+		u16Word = (uint16) (pMRAM - (uint16 *) C_ADDR_USERPAGE1);
+		if ( (u16Word < (C_NVRAM_RECORD_CHECK + (C_NVRAM_RECORDS / 2u))) && ((u16Word + size) > C_NVRAM_RECORD_CHECK) )
+		{
+			return ( NVRAM_E_INVALID_DATA );									/* Check-bytes */
+		}
+		NVRAM_RecordRange( 0u, u16Word, size, FALSE);							/* Don't validate unchecked data */
+#endif /* _SUPPORT_NVRAM_RECORD_CRC */
 
 		/* copy with verifing */
+		NVRAM_WaitReady();														/* Shadow-RAM is the program source */
 		u8VerifyRes = 0u;
 		for(i = 0;i < size;i++)
 		{
@@ -172,29 +259,31 @@ uint8 NVRAM_Write(uint16 addr,const uint16 buf[],uint16 size)
 		/* page verify result need saving  */
 		if(u8VerifyRes == 1u)
 		{
-			/* program count and nvram user version */
-			pIntegrity = (PNVRAM_PAGEINTEGRITY)(C_ADDR_USERPAGE1);
-			pIntegrity->CRC8_Revision = C_NVRAM_USER_REV;					/* CRC8=0x00,Revision=C_NVRAM_USER_REV */
-			pIntegrity->ProgramCount++;
-			if(pIntegrity->ProgramCount >= C_MAX_NVRAM_PROGRAM_COUNT)
-			{
-				pIntegrity->ProgramCount = C_MAX_NVRAM_PROGRAM_COUNT;
-			}
-			
-			/* page intergrity */
-			u8CRC8 = (uint8)NVRAM_CRC8((uint16 *)C_ADDR_USERPAGE1, C_SIZE_USERPAGE1 / 2u);	/* MMP151202-1 */
-			u8CRC8 = 0xFFu - u8CRC8;
-			pIntegrity->CRC8_Revision = (pIntegrity->CRC8_Revision & 0x00FFu) | ((uint16)u8CRC8 << 8u);
-			
-			NVRAM_SavePage( NVRAM1_PAGE1);
+#if _SUPPORT_NVRAM_RECORD_CRC
+			NVRAM_RecordRange( 0u, u16Word, size, TRUE);						/* O(record) */
+#endif /* _SUPPORT_NVRAM_RECORD_CRC */
+#if _SUPPORT_NVRAM_WRITE_BACK
+			NVRAM_MarkDirty( C_NVRAM_USER_PAGE_1);						/* Deferred: NVRAM_MainFunction() */
+#else  /* _SUPPORT_NVRAM_WRITE_BACK */
+			NVRAM_CommitPage( C_NVRAM_USER_PAGE_1, TRUE);
+#endif /* _SUPPORT_NVRAM_WRITE_BACK */
 		}
 		
 	}
 	else if((addr >= C_NVRAM_AREA2_ADDR) && ((addr + size) < (C_NVRAM_AREA2_ADDR + C_NVRAM_AREA2_SIZE)))
 	{
 		pMRAM = (uint16 *)C_ADDR_USERPAGE2 + sizeof(NVRAM_PAGEINTEGRITY) / sizeof(uint16) + (addr - C_NVRAM_AREA2_ADDR);
+#if _SUPPORT_NVRAM_RECORD_CRC
+		u16Word = (uint16) (pMRAM - (uint16 *) C_ADDR_USERPAGE2);
+		if ( (u16Word < (C_NVRAM_RECORD_CHECK + (C_NVRAM_RECORDS / 2u))) && ((u16Word + size) > C_NVRAM_RECORD_CHECK) )
+		{
+			return ( NVRAM_E_INVALID_DATA );									/* Check-bytes */
+		}
+		NVRAM_RecordRange( 1u, u16Word, size, FALSE);							/* Don't validate unchecked data */
+#endif /* _SUPPORT_NVRAM_RECORD_CRC */
 
 		/* copy and verify */
+		NVRAM_WaitReady();														/* Shadow-RAM is the program source */
 		u8VerifyRes = 0u;
 
 		for(i = 0;i < size;i++)
@@ -209,19 +298,14 @@ uint8 NVRAM_Write(uint16 addr,const uint16 buf[],uint16 size)
 		/* page verify result need saving,then start save process  */
 		if(u8VerifyRes == 1u)
 		{
-			pIntegrity = (PNVRAM_PAGEINTEGRITY)(C_ADDR_USERPAGE2);
-			pIntegrity->CRC8_Revision = C_NVRAM_USER_REV;					/* CRC8=0x00,Revision=C_NVRAM_USER_REV */
-			pIntegrity->ProgramCount++;
-			if(pIntegrity->ProgramCount >= C_MAX_NVRAM_PROGRAM_COUNT)
-			{
-				pIntegrity->ProgramCount = C_MAX_NVRAM_PROGRAM_COUNT;
-			}
-			/* page intergrity */
-			u8CRC8 = (uint8)NVRAM_CRC8((uint16 *)C_ADDR_USERPAGE2, C_SIZE_USERPAGE2 / 2u);	/* MMP151202-1 */
-			u8CRC8 = 0xFFu - u8CRC8;
-			pIntegrity->CRC8_Revision = (pIntegrity->CRC8_Revision & 0x00FFu) | ((uint16)u8CRC8 << 8u);
-			
-			NVRAM_SavePage( NVRAM2_PAGE1);
+#if _SUPPORT_NVRAM_RECORD_CRC
+			NVRAM_RecordRange( 1u, u16Word, size, TRUE);						/* O(record) */
+#endif /* _SUPPORT_NVRAM_RECORD_CRC */
+#if _SUPPORT_NVRAM_WRITE_BACK
+			NVRAM_MarkDirty( C_NVRAM_USER_PAGE_2);						/* Deferred: NVRAM_MainFunction() */
+#else  /* _SUPPORT_NVRAM_WRITE_BACK */
+			NVRAM_CommitPage( C_NVRAM_USER_PAGE_2, TRUE);
+#endif /* _SUPPORT_NVRAM_WRITE_BACK */
 		}
 	}
 	else
@@ -240,9 +324,17 @@ uint16 NVRAM_Store( uint16 u16Page)
 	uint8 u8CRC8;
 	PNVRAM_PAGEINTEGRITY pIntegrity;
 
+	NVRAM_WaitReady();															/* Program started by NVRAM_MainFunction() or NVRAM_LogError() */
 	if((u16Page & C_NVRAM_USER_PAGE_1) != 0u)
 	{
 		if ( (u16Page & C_MVRAM_USER_PAGE_NoCRC) == 0u )
+#if _SUPPORT_NVRAM_RECORD_CRC
+		{
+			(void) pIntegrity;
+			(void) u8CRC8;
+			NVRAM_RecordRange( 0u, 0u, C_SIZE_USERPAGE1 / 2u, TRUE);			/* Shadow-RAM may be changed directly (C_SID_MLX_EE_USERPG1) */
+		}
+#else  /* _SUPPORT_NVRAM_RECORD_CRC */
 		{
 			pIntegrity = (PNVRAM_PAGEINTEGRITY)(C_ADDR_USERPAGE1);
 			u8CRC8 = (uint8)NVRAM_CRC8((uint16 *)C_ADDR_USERPAGE1, C_SIZE_USERPAGE1 / 2u);	/* MMP151202-1 */
@@ -250,24 +342,595 @@ uint16 NVRAM_Store( uint16 u16Page)
 			pIntegrity->CRC8_Revision = (pIntegrity->CRC8_Revision & 0x00FFu) | ((uint16)u8CRC8 << 8u);
 			
 		}
+#endif /* _SUPPORT_NVRAM_RECORD_CRC */
 		NVRAM_SavePage( NVRAM1_PAGE1);
+#if _SUPPORT_NVRAM_WRITE_BACK
+		g_u8NvramDirtyPages &= (uint8) ~C_NVRAM_USER_PAGE_1;
+#endif /* _SUPPORT_NVRAM_WRITE_BACK */
 	}
 
 	if((u16Page & C_NVRAM_USER_PAGE_2) != 0u)
 	{
 		if ( (u16Page & C_MVRAM_USER_PAGE_NoCRC) == 0u )
+#if _SUPPORT_NVRAM_RECORD_CRC
+		{
+			(void) pIntegrity;
+			(void) u8CRC8;
+			NVRAM_RecordRange( 1u, 0u, C_SIZE_USERPAGE2 / 2u, TRUE);			/* Shadow-RAM may be changed directly (C_SID_MLX_EE_USERPG1) */
+		}
+#else  /* _SUPPORT_NVRAM_RECORD_CRC */
 		{
 			pIntegrity = (PNVRAM_PAGEINTEGRITY)(C_ADDR_USERPAGE2);
 			u8CRC8 = (uint8)NVRAM_CRC8((uint16 *)C_ADDR_USERPAGE2, C_SIZE_USERPAGE2 / 2u);	/* MMP151202-1 */
 			u8CRC8 = 0xFFu - u8CRC8;
 			pIntegrity->CRC8_Revision = (pIntegrity->CRC8_Revision & 0x00FFu) | ((uint16)u8CRC8 << 8u);
 		}
+#endif /* _SUPPORT_NVRAM_RECORD_CRC */
 		NVRAM_SavePage( NVRAM2_PAGE1);
+#if _SUPPORT_NVRAM_WRITE_BACK
+		g_u8NvramDirtyPages &= (uint8) ~C_NVRAM_USER_PAGE_2;
+#if _SUPPORT_NVRAM_LOG
+		NVRAM_LogCommitted();
+#endif /* _SUPPORT_NVRAM_LOG */
+#endif /* _SUPPORT_NVRAM_WRITE_BACK */
 	}
 
 	return u16Result;
 }
 
+/* ****************************************************************************	*
+ * NVRAM_WaitReady
+ *
+ *	Pre:	-
+ *	Post:	-
+ *	Comments: Wait for the completion of a page program started without wait
+ *			(NVRAM_MainFunction(), NVRAM_LogError()); The shadow-RAM is the
+ *			source of the program and may not be changed before, nor may
+ *			another program be started.
+ * ****************************************************************************	*/
+void NVRAM_WaitReady( void)
+{
+	while ( (NV_CTRL & NV_BUSY) != 0u )
+	{
+		WDG_Manager();
+	}
+} /* End of NVRAM_WaitReady() */
+
+/* ****************************************************************************	*
+ * NVRAM_CommitPage
+ *
+ *	Pre:	u16Page: C_NVRAM_USER_PAGE_1 or C_NVRAM_USER_PAGE_2
+ *			u16Wait: FALSE: Start the program only; TRUE: Wait till completed
+ *	Post:	-
+ *	Comments: Update program-count and CRC-8 of the user-page and program it.
+ * ****************************************************************************	*/
+static void NVRAM_CommitPage( uint16 u16Page, uint16 u16Wait)
+{
+	uint16 *pMRAM = (uint16 *) C_ADDR_USERPAGE1;
+	PNVRAM_PAGEINTEGRITY pIntegrity;
+	uint16 u16NvramPage = NVRAM1_PAGE1;
+#if (_SUPPORT_NVRAM_RECORD_CRC == FALSE)
+	uint8 u8CRC8;
+#endif /* (_SUPPORT_NVRAM_RECORD_CRC == FALSE) */
+
+	if ( u16Page == C_NVRAM_USER_PAGE_2 )
+	{
+		pMRAM = (uint16 *) C_ADDR_USERPAGE2;
+		u16NvramPage = NVRAM2_PAGE1;
+	}
+	NVRAM_WaitReady();
+	/* program count and nvram user version */
+	pIntegrity = (PNVRAM_PAGEINTEGRITY) pMRAM;
+#if _SUPPORT_NVRAM_RECORD_CRC
+	pIntegrity->CRC8_Revision = C_NVRAM_USER_REV_RECORD;
+#else  /* _SUPPORT_NVRAM_RECORD_CRC */
+	pIntegrity->CRC8_Revision = C_NVRAM_USER_REV;								/* CRC8=0x00,Revision=C_NVRAM_USER_REV */
+#endif /* _SUPPORT_NVRAM_RECORD_CRC */
+	pIntegrity->ProgramCount++;
+	if(pIntegrity->ProgramCount >= C_MAX_NVRAM_PROGRAM_COUNT)
+	{
+		pIntegrity->ProgramCount = C_MAX_NVRAM_PROGRAM_COUNT;
+	}
+
+#if _SUPPORT_NVRAM_RECORD_CRC
+	/* record #0 integrity (header) */
+	NVRAM_RecordUpdate( pMRAM, 0u);
+#else  /* _SUPPORT_NVRAM_RECORD_CRC */
+	/* page intergrity */
+	u8CRC8 = (uint8)NVRAM_CRC8( pMRAM, C_SIZE_USERPAGE1 / 2u);					/* MMP151202-1 */
+	u8CRC8 = 0xFFu - u8CRC8;
+	pIntegrity->CRC8_Revision = (pIntegrity->CRC8_Revision & 0x00FFu) | ((uint16)u8CRC8 << 8u);
+#endif /* _SUPPORT_NVRAM_RECORD_CRC */
+
+	if ( u16Wait == FALSE )
+	{
+		u16NvramPage |= NVRAM_PAGE_WR_SKIP_WAIT;
+	}
+#if _SUPPORT_NVRAM_LOG && _SUPPORT_NVRAM_WRITE_BACK
+	if ( u16Page == C_NVRAM_USER_PAGE_2 )
+	{
+		NVRAM_LogCommitted();
+	}
+#endif /* _SUPPORT_NVRAM_LOG && _SUPPORT_NVRAM_WRITE_BACK */
+	NVRAM_SavePage( u16NvramPage);
+} /* End of NVRAM_CommitPage() */
+
+#if _SUPPORT_NVRAM_RECORD_CRC
+#define NVRAM_USER_PAGE(idx)	((uint16 *) (((idx) == 0u) ? C_ADDR_USERPAGE1 : C_ADDR_USERPAGE2))
+
+/* ****************************************************************************	*
+ * NVRAM_RecordInitPage
+ *
+ *	Pre:	u16PageIdx: 0: User-page #1, 1: User-page #2
+ *	Post:	-
+ *	Comments: Record format: The records are checked at first use. Page-CRC
+ *			format (C_NVRAM_USER_REV): Converted, words 4-7 become the
+ *			check-bytes. Otherwise the page is cleared (0xFF).
+ * ****************************************************************************	*/
+static void NVRAM_RecordInitPage( uint16 u16PageIdx)
+{
+	uint16 *pMRAM = NVRAM_USER_PAGE( u16PageIdx);
+	PNVRAM_PAGEINTEGRITY pIntegrity = (PNVRAM_PAGEINTEGRITY) pMRAM;
+	uint16 i;
+
+	if ( (uint8) pIntegrity->CRC8_Revision == C_NVRAM_USER_REV_RECORD )
+	{
+		l_au8NvramRecordChecked[u16PageIdx] = 0u;
+	}
+	else
+	{
+		if ( ((uint8) pIntegrity->CRC8_Revision != C_NVRAM_USER_REV) || (NVRAM_CRC8( pMRAM, C_SIZE_USERPAGE1 / 2u) != 0xFFu) )
+		{
+			/* nvram may be corrupted,filled with padding  */
+			for ( i = 0u; i < (C_SIZE_USERPAGE1 / 2u); i++ )
+			{
+				pMRAM[i] = 0xFFFFu;
+			}
+			pIntegrity->ProgramCount = 0u;
+		}
+		pIntegrity->CRC8_Revision = C_NVRAM_USER_REV_RECORD;
+		for ( i = 0u; i < C_NVRAM_RECORDS; i++ )
+		{
+			NVRAM_RecordUpdate( pMRAM, i);
+		}
+		l_au8NvramRecordChecked[u16PageIdx] = C_NVRAM_RECORD_ALL;
+	}
+} /* End of NVRAM_RecordInitPage() */
+
+/* ****************************************************************************	*
+ * NVRAM_RecordUpdate
+ *
+ *	Pre:	pPage: User-page shadow-RAM
+ *			u16Record: Record-index (0..C_NVRAM_RECORDS-1)
+ *	Post:	-
+ *	Comments: Calculate the check-byte of the record (O(record))
+ * ****************************************************************************	*/
+static void NVRAM_RecordUpdate( uint16 *pPage, uint16 u16Record)
+{
+	uint16 u16Size = (u16Record == 0u) ? C_NVRAM_RECORD_CHECK : C_NVRAM_RECORD_WORDS;
+	uint8 u8Check = 0xFFu - NVRAM_CRC8( &pPage[u16Record * C_NVRAM_RECORD_WORDS], u16Size);
+	PlaceError( &pPage[C_NVRAM_RECORD_CHECK + (u16Record >> 1u)], u16Record & 0x01u, u8Check);
+} /* End of NVRAM_RecordUpdate() */
+
+/* ****************************************************************************	*
+ * NVRAM_RecordCheck
+ *
+ *	Pre:	u16PageIdx: 0: User-page #1, 1: User-page #2
+ *			u16Record: Record-index (0..C_NVRAM_RECORDS-1)
+ *	Post:	-
+ *	Comments: Check the record once (since NVRAM_Init()); A corrupted record
+ *			is cleared (0xFF), the other records of the page remain usable.
+ *			Atomic, as the error-log record is also used by the ISR's.
+ * ****************************************************************************	*/
+static void NVRAM_RecordCheck( uint16 u16PageIdx, uint16 u16Record)
+{
+	uint8 u8Mask = (uint8) (1u << u16Record);
+
+	if ( (l_au8NvramRecordChecked[u16PageIdx] & u8Mask) == 0u )
+	{
+		NVRAM_WaitReady();														/* A corrupted record is cleared in the shadow-RAM */
+	}
+	ATOMIC_CODE
+	(
+		if ( (l_au8NvramRecordChecked[u16PageIdx] & u8Mask) == 0u )
+		{
+			uint16 *pMRAM = NVRAM_USER_PAGE( u16PageIdx);
+			uint16 *pRecord = &pMRAM[u16Record * C_NVRAM_RECORD_WORDS];
+			uint16 u16Size = (u16Record == 0u) ? C_NVRAM_RECORD_CHECK : C_NVRAM_RECORD_WORDS;
+			uint16 u16Checks = pMRAM[C_NVRAM_RECORD_CHECK + (u16Record >> 1u)];
+			if ( (u16Record & 0x01u) != 0u )
+			{
+				u16Checks = u16Checks >> 8u;
+			}
+			if ( (uint8) (0xFFu - NVRAM_CRC8( pRecord, u16Size)) != (uint8) u16Checks )
+			{
+				uint16 i;
+				for ( i = 0u; i < u16Size; i++ )
+				{
+					pRecord[i] = 0xFFFFu;
+				}
+				if ( u16Record == 0u )
+				{
+					((PNVRAM_PAGEINTEGRITY) pMRAM)->CRC8_Revision = C_NVRAM_USER_REV_RECORD;
+					((PNVRAM_PAGEINTEGRITY) pMRAM)->ProgramCount = 0u;
+				}
+				NVRAM_RecordUpdate( pMRAM, u16Record);
+				if ( g_u8NvramRecordErrors != 0xFFu )
+				{
+					g_u8NvramRecordErrors++;
+				}
+			}
+			l_au8NvramRecordChecked[u16PageIdx] |= u8Mask;
+		}
+	);
+} /* End of NVRAM_RecordCheck() */
+
+/* ****************************************************************************	*
+ * NVRAM_RecordRange
+ *
+ *	Pre:	u16PageIdx: 0: User-page #1, 1: User-page #2
+ *			u16Word, u16Size: Word-offset and size of the data in the page
+ *			u16Update: FALSE: Check the records; TRUE: Update the check-bytes
+ *	Post:	-
+ *	Comments: Check or update only the records with the data.
+ * ****************************************************************************	*/
+static void NVRAM_RecordRange( uint16 u16PageIdx, uint16 u16Word, uint16 u16Size, uint16 u16Update)
+{
+	if ( u16Size != 0u )
+	{
+		uint16 u16Record = u16Word / C_NVRAM_RECORD_WORDS;
+		uint16 u16Last = (u16Word + u16Size - 1u) / C_NVRAM_RECORD_WORDS;
+		for ( ; u16Record <= u16Last; u16Record++ )
+		{
+			if ( u16Update != FALSE )
+			{
+				NVRAM_RecordUpdate( NVRAM_USER_PAGE( u16PageIdx), u16Record);
+				l_au8NvramRecordChecked[u16PageIdx] |= (uint8) (1u << u16Record);
+			}
+			else
+			{
+				NVRAM_RecordCheck( u16PageIdx, u16Record);
+			}
+		}
+	}
+} /* End of NVRAM_RecordRange() */
+#endif /* _SUPPORT_NVRAM_RECORD_CRC */
+
+#if _SUPPORT_NVRAM_WRITE_BACK
+/* ****************************************************************************	*
+ * NVRAM_MarkDirty
+ *
+ *	Pre:	u16Page: C_NVRAM_USER_PAGE_1 or C_NVRAM_USER_PAGE_2
+ *	Post:	-
+ *	Comments: User-page shadow-RAM changed; Programmed by NVRAM_MainFunction()
+ *			or NVRAM_Flush(). Changes in between are combined in one program.
+ * ****************************************************************************	*/
+static void NVRAM_MarkDirty( uint16 u16Page)
+{
+	l_u16NvramLastChange = g_u16TimerTicks;
+	if ( g_u8NvramDirtyPages == 0u )
+	{
+		l_u16NvramFirstChange = l_u16NvramLastChange;
+	}
+	g_u8NvramDirtyPages |= (uint8) u16Page;
+	l_sNvramCacheStats.u16Writes++;
+} /* End of NVRAM_MarkDirty() */
+#endif /* _SUPPORT_NVRAM_WRITE_BACK */
+
+#if _SUPPORT_NVRAM_WRITE_BACK || _SUPPORT_NVRAM_RECORD_CRC
+/* ****************************************************************************	*
+ * NVRAM_MainFunction
+ *
+ *	Pre:	-
+ *	Post:	-
+ *	Comments: Commit the changed user-pages at an idle point: Motor stopped,
+ *			C_NVRAM_COMMIT_DELAY without changes (or C_NVRAM_COMMIT_MAX_DELAY
+ *			since the first change) and NVRAM not busy. One page program is
+ *			started per call, without waiting for its completion.
+ *			_SUPPORT_NVRAM_RECORD_CRC: Check one record not yet used.
+ * ****************************************************************************	*/
+void NVRAM_MainFunction( void)
+{
+#if _SUPPORT_NVRAM_RECORD_CRC
+	{
+		uint16 u16PageIdx = (l_au8NvramRecordChecked[0] == C_NVRAM_RECORD_ALL) ? 1u : 0u;
+		uint8 u8Checked = l_au8NvramRecordChecked[u16PageIdx];
+		if ( (u8Checked != C_NVRAM_RECORD_ALL) && ((NV_CTRL & NV_BUSY) == 0u) )	/* Deferred while a page is programmed */
+		{
+			uint16 u16Record = 0u;
+			while ( (u8Checked & 0x01u) != 0u )
+			{
+				u8Checked >>= 1;
+				u16Record++;
+			}
+			NVRAM_RecordCheck( u16PageIdx, u16Record);
+		}
+	}
+#endif /* _SUPPORT_NVRAM_RECORD_CRC */
+#if _SUPPORT_NVRAM_WRITE_BACK
+	if ( (g_u8NvramDirtyPages != 0u) && (g_u8MotorStartupMode == (uint8) MSM_STOP) && ((NV_CTRL & NV_BUSY) == 0u) )
+	{
+		uint16 u16Now = g_u16TimerTicks;
+		uint16 u16DirtyTicks = (uint16) (u16Now - l_u16NvramFirstChange);
+		if ( ((uint16) (u16Now - l_u16NvramLastChange) >= C_NVRAM_COMMIT_DELAY) || (u16DirtyTicks >= C_NVRAM_COMMIT_MAX_DELAY) )
+		{
+			uint16 u16Page = C_NVRAM_USER_PAGE_1;
+			if ( (g_u8NvramDirtyPages & C_NVRAM_USER_PAGE_1) == 0u )
+			{
+				u16Page = C_NVRAM_USER_PAGE_2;
+			}
+			g_u8NvramDirtyPages &= (uint8) ~u16Page;
+			NVRAM_CommitPage( u16Page, FALSE);
+			l_sNvramCacheStats.u16Commits++;
+			if ( u16DirtyTicks > l_sNvramCacheStats.u16MaxDirtyTicks )
+			{
+				l_sNvramCacheStats.u16MaxDirtyTicks = u16DirtyTicks;
+			}
+		}
+	}
+#endif /* _SUPPORT_NVRAM_WRITE_BACK */
+} /* End of NVRAM_MainFunction() */
+#endif /* _SUPPORT_NVRAM_WRITE_BACK || _SUPPORT_NVRAM_RECORD_CRC */
+
+#if _SUPPORT_NVRAM_WRITE_BACK
+/* ****************************************************************************	*
+ * NVRAM_Flush
+ *
+ *	Pre:	-
+ *	Post:	-
+ *	Comments: Commit all changed user-pages now (e.g. before sleep); Returns
+ *			after the programs are completed.
+ * ****************************************************************************	*/
+void NVRAM_Flush( void)
+{
+	uint16 u16Page;
+
+	for ( u16Page = C_NVRAM_USER_PAGE_1; u16Page <= C_NVRAM_USER_PAGE_2; u16Page <<= 1 )
+	{
+		if ( (g_u8NvramDirtyPages & u16Page) != 0u )
+		{
+			g_u8NvramDirtyPages &= (uint8) ~u16Page;
+			NVRAM_CommitPage( u16Page, TRUE);
+			l_sNvramCacheStats.u16Commits++;
+		}
+	}
+	NVRAM_WaitReady();															/* Program started by NVRAM_MainFunction() */
+} /* End of NVRAM_Flush() */
+
+/* ****************************************************************************	*
+ * NVRAM_GetCacheStats
+ *
+ *	Pre:	pStats: Pointer to statistics structure
+ *	Post:	-
+ * ****************************************************************************	*/
+void NVRAM_GetCacheStats( PNVRAM_CACHE_STATS pStats)
+{
+	*pStats = l_sNvramCacheStats;
+} /* End of NVRAM_GetCacheStats() */
+#endif /* _SUPPORT_NVRAM_WRITE_BACK */
+
+#if _SUPPORT_NVRAM_LOG
+/* ****************************************************************************	*
+ * NVRAM_LogSlot
+ *
+ *	Pre:	u16Slot: 0..C_NVRAM_LOG_SLOTS-1
+ *	Post:	Shadow-RAM of the log-record slot
+ * ****************************************************************************	*/
+static PNVRAM_LOG_RECORD NVRAM_LogSlot( uint16 u16Slot)
+{
+	return ( (PNVRAM_LOG_RECORD) ((uint16 *) C_ADDR_USERPAGE2 + C_NVRAM_LOG_PAGE2_WORD + (u16Slot * C_NVRAM_LOG_SLOT_WORDS)) );
+} /* End of NVRAM_LogSlot() */
+
+/* ****************************************************************************	*
+ * NVRAM_LogCheck
+ *
+ *	Pre:	pRecord: Log-record
+ *	Post:	Check-byte of the record
+ * ****************************************************************************	*/
+static uint8 NVRAM_LogCheck( const NVRAM_LOG_RECORD *pRecord)
+{
+	NVRAM_LOG_RECORD sRecord = *pRecord;
+	sRecord.u16Tag_Check &= 0x00FFu;
+	return ( 0xFFu - NVRAM_CRC8( (const uint16 *) &sRecord, C_NVRAM_LOG_SLOT_WORDS) );
+} /* End of NVRAM_LogCheck() */
+
+/* ****************************************************************************	*
+ * NVRAM_LogFreeSlot
+ *
+ *	Pre:	-
+ *	Post:	First slot after the last appended one not holding the newest
+ *			record of a tag, nor its newest programmed record (C_NVRAM_LOG_NONE:
+ *			None)
+ * ****************************************************************************	*/
+static uint16 NVRAM_LogFreeSlot( void)
+{
+	uint16 u16Slot = l_u8NvramLogHead;
+	do
+	{
+		uint16 u16Tag;
+		u16Slot++;
+		if ( u16Slot >= C_NVRAM_LOG_SLOTS )
+		{
+			u16Slot = 0u;
+		}
+		for ( u16Tag = 0u; u16Tag < C_NVRAM_LOG_TAGS; u16Tag++ )
+		{
+			if ( l_au8NvramLogTagSlot[u16Tag] == (uint8) u16Slot )
+			{
+				break;
+			}
+#if _SUPPORT_NVRAM_WRITE_BACK
+			if ( l_au8NvramLogTagCommitted[u16Tag] == (uint8) u16Slot )
+			{
+				break;																/* Kept till the newer record is programmed */
+			}
+#endif /* _SUPPORT_NVRAM_WRITE_BACK */
+		}
+		if ( u16Tag == C_NVRAM_LOG_TAGS )
+		{
+			return ( u16Slot );
+		}
+	} while ( u16Slot != l_u8NvramLogHead );
+	return ( C_NVRAM_LOG_NONE );
+} /* End of NVRAM_LogFreeSlot() */
+
+#if _SUPPORT_NVRAM_WRITE_BACK
+/* ****************************************************************************	*
+ * NVRAM_LogCommitted
+ *
+ *	Pre:	-
+ *	Post:	-
+ *	Comments: The program of user-page #2 is started: Its records may no
+ *			longer be updated in place and become the newest programmed ones.
+ * ****************************************************************************	*/
+static void NVRAM_LogCommitted( void)
+{
+	uint16 u16Tag;
+
+	for ( u16Tag = 0u; u16Tag < C_NVRAM_LOG_TAGS; u16Tag++ )
+	{
+		l_au8NvramLogTagCommitted[u16Tag] = l_au8NvramLogTagSlot[u16Tag];
+	}
+	l_u16NvramLogUncommitted = 0u;
+} /* End of NVRAM_LogCommitted() */
+#endif /* _SUPPORT_NVRAM_WRITE_BACK */
+
+/* ****************************************************************************	*
+ * NVRAM_LogMount
+ *
+ *	Pre:	User-pages loaded (NVRAM_Init())
+ *	Post:	-
+ *	Comments: Single scan of the slots: Newest record per tag and the last
+ *			appended slot. Records with a wrong check-byte (e.g. page program
+ *			interrupted) are ignored; The older record of the tag remains.
+ * ****************************************************************************	*/
+static void NVRAM_LogMount( void)
+{
+	uint16 u16Slot;
+	uint16 u16Found = FALSE;
+
+	l_u16NvramLogSequence = 0u;
+	l_u8NvramLogHead = (uint8) (C_NVRAM_LOG_SLOTS - 1u);
+	for ( u16Slot = 0u; u16Slot < C_NVRAM_LOG_TAGS; u16Slot++ )
+	{
+		l_au8NvramLogTagSlot[u16Slot] = C_NVRAM_LOG_NONE;
+	}
+	for ( u16Slot = 0u; u16Slot < C_NVRAM_LOG_SLOTS; u16Slot++ )
+	{
+		PNVRAM_LOG_RECORD pRecord = NVRAM_LogSlot( u16Slot);
+		uint16 u16Tag = (uint8) pRecord->u16Tag_Check;
+#if _SUPPORT_NVRAM_RECORD_CRC
+		NVRAM_RecordRange( 1u, (uint16) ((uint16 *) pRecord - (uint16 *) C_ADDR_USERPAGE2), C_NVRAM_LOG_SLOT_WORDS, FALSE);
+#endif /* _SUPPORT_NVRAM_RECORD_CRC */
+		if ( (u16Tag < C_NVRAM_LOG_TAGS) && (NVRAM_LogCheck( pRecord) == (uint8) (pRecord->u16Tag_Check >> 8u)) )
+		{
+			uint16 u16TagSlot = l_au8NvramLogTagSlot[u16Tag];
+			if ( (u16Found == FALSE) || ((int16) (pRecord->u16Sequence - l_u16NvramLogSequence) > 0) )
+			{
+				l_u16NvramLogSequence = pRecord->u16Sequence;
+				l_u8NvramLogHead = (uint8) u16Slot;
+				u16Found = TRUE;
+			}
+			if ( (u16TagSlot == C_NVRAM_LOG_NONE) ||
+				 ((int16) (pRecord->u16Sequence - NVRAM_LogSlot( u16TagSlot)->u16Sequence) > 0) )
+			{
+				l_au8NvramLogTagSlot[u16Tag] = (uint8) u16Slot;
+			}
+		}
+	}
+#if _SUPPORT_NVRAM_WRITE_BACK
+	for ( u16Slot = 0u; u16Slot < C_NVRAM_LOG_TAGS; u16Slot++ )
+	{
+		l_au8NvramLogTagCommitted[u16Slot] = l_au8NvramLogTagSlot[u16Slot];
+	}
+	l_u16NvramLogUncommitted = 0u;
+#endif /* _SUPPORT_NVRAM_WRITE_BACK */
+} /* End of NVRAM_LogMount() */
+
+/* ****************************************************************************	*
+ * NVRAM_LogPut
+ *
+ *	Pre:	u16Tag: C_NVRAM_LOG_TAG_xxx
+ *			u32Value: Value
+ *	Post:	NVRAM_E_OK: Appended (or unchanged)
+ *			NVRAM_E_INVALID_DATA: Invalid tag
+ *	Comments: Append a sequence-numbered record. Superseded records are free
+ *			slots (garbage), only the newest record per tag is kept. A record
+ *			not yet programmed is updated in place; A programmed record is
+ *			never overwritten before its successor is programmed.
+ * ****************************************************************************	*/
+uint16 NVRAM_LogPut( uint16 u16Tag, uint32 u32Value)
+{
+	uint16 u16Slot;
+	PNVRAM_LOG_RECORD pRecord;
+
+	if ( u16Tag >= C_NVRAM_LOG_TAGS )
+	{
+		return ( NVRAM_E_INVALID_DATA );
+	}
+	u16Slot = l_au8NvramLogTagSlot[u16Tag];
+	if ( u16Slot != C_NVRAM_LOG_NONE )
+	{
+		pRecord = NVRAM_LogSlot( u16Slot);
+		if ( (pRecord->au16Value[0] == (uint16) u32Value) && (pRecord->au16Value[1] == (uint16) (u32Value >> 16)) )
+		{
+			return ( NVRAM_E_OK );
+		}
+	}
+#if _SUPPORT_NVRAM_WRITE_BACK
+	if ( (u16Slot == C_NVRAM_LOG_NONE) || ((l_u16NvramLogUncommitted & (1u << u16Slot)) == 0u) )
+#endif /* _SUPPORT_NVRAM_WRITE_BACK */
+	{
+		u16Slot = NVRAM_LogFreeSlot();
+	}
+
+	NVRAM_WaitReady();															/* Shadow-RAM is the program source */
+	l_u16NvramLogSequence++;
+	pRecord = NVRAM_LogSlot( u16Slot);
+	pRecord->u16Sequence = l_u16NvramLogSequence;
+	pRecord->u16Tag_Check = u16Tag;
+	pRecord->au16Value[0] = (uint16) u32Value;
+	pRecord->au16Value[1] = (uint16) (u32Value >> 16);
+	pRecord->u16Tag_Check |= ((uint16) NVRAM_LogCheck( pRecord) << 8u);
+	l_au8NvramLogTagSlot[u16Tag] = (uint8) u16Slot;
+	l_u8NvramLogHead = (uint8) u16Slot;
+#if _SUPPORT_NVRAM_WRITE_BACK
+	l_u16NvramLogUncommitted |= (uint16) (1u << u16Slot);
+#endif /* _SUPPORT_NVRAM_WRITE_BACK */
+
+#if _SUPPORT_NVRAM_RECORD_CRC
+	NVRAM_RecordRange( 1u, (uint16) ((uint16 *) pRecord - (uint16 *) C_ADDR_USERPAGE2), C_NVRAM_LOG_SLOT_WORDS, TRUE);
+#endif /* _SUPPORT_NVRAM_RECORD_CRC */
+#if _SUPPORT_NVRAM_WRITE_BACK
+	NVRAM_MarkDirty( C_NVRAM_USER_PAGE_2);
+#else  /* _SUPPORT_NVRAM_WRITE_BACK */
+	NVRAM_CommitPage( C_NVRAM_USER_PAGE_2, TRUE);
+#endif /* _SUPPORT_NVRAM_WRITE_BACK */
+	return ( NVRAM_E_OK );
+} /* End of NVRAM_LogPut() */
+
+/* ****************************************************************************	*
+ * NVRAM_LogGet
+ *
+ *	Pre:	u16Tag: C_NVRAM_LOG_TAG_xxx
+ *			pu32Value: Value (unchanged if none)
+ *	Post:	NVRAM_E_OK: Value of the newest record
+ *			NVRAM_E_FAIL: No record (or invalid tag)
+ * ****************************************************************************	*/
+uint16 NVRAM_LogGet( uint16 u16Tag, uint32 *pu32Value)
+{
+	uint16 u16Result = NVRAM_E_FAIL;
+
+	if ( (u16Tag < C_NVRAM_LOG_TAGS) && (l_au8NvramLogTagSlot[u16Tag] != C_NVRAM_LOG_NONE) )
+	{
+		PNVRAM_LOG_RECORD pRecord = NVRAM_LogSlot( l_au8NvramLogTagSlot[u16Tag]);
+		*pu32Value = ((uint32) pRecord->au16Value[1] << 16) | pRecord->au16Value[0];
+		u16Result = NVRAM_E_OK;
+	}
+	return ( u16Result );
+} /* End of NVRAM_LogGet() */
+#endif /* _SUPPORT_NVRAM_LOG */
+
 /* ****************************************************************************	*
  * void NVRAM_StorePatch
  *
@@ -367,7 +1030,13 @@ uint16 NVRAM_LogError( uint8 u8ErrorCode)
 	uint16 u16Result = C_NVRAM_STORE_OKAY;										/* MMP150219-1 */
 	
 	PNVRAM_ERRORLOG pNVERRLOG_UPG = (PNVRAM_ERRORLOG) (C_ADDR_USERPAGE2 + C_NVRAM_ERRLOG_OFFSET);
-	uint16 u16ErrorLogIdx = (uint8) (pNVERRLOG_UPG->ErrorLogIndex_CRC);
+	uint16 u16ErrorLogIdx;
+
+	NVRAM_WaitReady();															/* Previous error-log program */
+#if _SUPPORT_NVRAM_RECORD_CRC
+	NVRAM_RecordCheck( 1u, C_NVRAM_ERRLOG_RECORD);
+#endif /* _SUPPORT_NVRAM_RECORD_CRC */
+	u16ErrorLogIdx = (uint8) (pNVERRLOG_UPG->ErrorLogIndex_CRC);
 	
 	
 	if ( (u16ErrorLogIdx & 0x80u) == 0x00u )
@@ -391,7 +1060,16 @@ uint16 NVRAM_LogError( uint8 u8ErrorCode)
 			(void) NVRAM_CountCRC8( pNVERRLOG_UPG, TRUE);
 			PlaceError( (uint16 *) &(pNVERRLOG_UPG->ErrorLog[u16ErrorLogIdx >> 1u]), u16ErrorLogIdx & 0x01u, u8ErrorCode);
 			pNVERRLOG_UPG->ErrorLogIndex_CRC = ((pNVERRLOG_UPG->ErrorLogIndex_CRC) & 0xFF00u) | u16ErrorLogIdx;
+#if _SUPPORT_NVRAM_RECORD_CRC
+			NVRAM_RecordUpdate( (uint16 *) C_ADDR_USERPAGE2, C_NVRAM_ERRLOG_RECORD);
+#endif /* _SUPPORT_NVRAM_RECORD_CRC */
 			/* Save (NV)RAM to NV(RAM) */
+#if _SUPPORT_NVRAM_WRITE_BACK
+			g_u8NvramDirtyPages &= (uint8) ~C_NVRAM_USER_PAGE_2;				/* Pending shadow-RAM changes of the page are programmed too */
+#if _SUPPORT_NVRAM_LOG
+			NVRAM_LogCommitted();												/* Log-records of the page are programmed too */
+#endif /* _SUPPORT_NVRAM_LOG */
+#endif /* _SUPPORT_NVRAM_WRITE_BACK */
 			NVRAM_SavePage( NVRAM2_PAGE1 | NVRAM_PAGE_WR_SKIP_WAIT);
 		}
 		else
@@ -415,6 +1093,9 @@ uint8 NVRAM_GetLastError( void)
 	uint8 u8Result = 0x00u;														/* No error's */
 
 	PNVRAM_ERRORLOG pNVERRLOG_UPG = (PNVRAM_ERRORLOG) (C_ADDR_USERPAGE2 + C_NVRAM_ERRLOG_OFFSET);
+#if _SUPPORT_NVRAM_RECORD_CRC
+	NVRAM_RecordCheck( 1u, C_NVRAM_ERRLOG_RECORD);
+#endif /* _SUPPORT_NVRAM_RECORD_CRC */
 	u16ErrorLogIdx = (uint8) (pNVERRLOG_UPG->ErrorLogIndex_CRC);
 
 	if ( u16ErrorLogIdx != 0x00u )
@@ -448,12 +1129,26 @@ void NVRAM_ClearErrorLog( void)
 {
 	uint16 i;
 	PNVRAM_ERRORLOG pNVERRLOG_UPG = (PNVRAM_ERRORLOG) (C_ADDR_USERPAGE2 + C_NVRAM_ERRLOG_OFFSET);
+
+	NVRAM_WaitReady();
+#if _SUPPORT_NVRAM_RECORD_CRC
+	NVRAM_RecordCheck( 1u, C_NVRAM_ERRLOG_RECORD);
+#endif /* _SUPPORT_NVRAM_RECORD_CRC */
 	pNVERRLOG_UPG->ErrorLogIndex_CRC = ((pNVERRLOG_UPG->ErrorLogIndex_CRC) & 0xFF00u) | 0x00u;	/* Set index at 0x00 */
 	for ( i = 0; i < (C_MAX_ERRORS_PER_PAGE / 2u); i++ )
 	{
 		pNVERRLOG_UPG->ErrorLog[i] = 0x0000u;
 	}
 	(void) NVRAM_CountCRC8( pNVERRLOG_UPG, TRUE);
+#if _SUPPORT_NVRAM_RECORD_CRC
+	NVRAM_RecordUpdate( (uint16 *) C_ADDR_USERPAGE2, C_NVRAM_ERRLOG_RECORD);
+#endif /* _SUPPORT_NVRAM_RECORD_CRC */
+#if _SUPPORT_NVRAM_WRITE_BACK
+	g_u8NvramDirtyPages &= (uint8) ~C_NVRAM_USER_PAGE_2;						/* Pending shadow-RAM changes of the page are programmed too */
+#if _SUPPORT_NVRAM_LOG
+	NVRAM_LogCommitted();														/* Log-records of the page are programmed too */
+#endif /* _SUPPORT_NVRAM_LOG */
+#endif /* _SUPPORT_NVRAM_WRITE_BACK */
 	NVRAM_SavePage( NVRAM2_PAGE1);
 } /* End of NVRAM_ClearErrorLog() */
 
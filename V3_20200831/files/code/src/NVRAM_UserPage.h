@@ -25,8 +25,10 @@
 #define NVRAM_USER_PAGE_H_
 
 #include "Build.h"
+#include "Timer.h"
 
 #define C_NVRAM_USER_REV		0x02u
+#define C_NVRAM_USER_REV_RECORD	0x03u						/* Record format (_SUPPORT_NVRAM_RECORD_CRC) */
 
 #define C_NVRAM_USER_PAGE_1		0x01u						/* NVRAM User Page #1,calibration info NVRAM #1,Page #1 */
 #define C_NVRAM_USER_PAGE_2		0x02u						/* NVRAM User Page #2,user real time info NVRAM #2,Page #1 */
@@ -84,6 +86,45 @@ typedef struct _NVRAM_ERRORLOG
 
 #define C_NVRAM_ERRLOG_OFFSET			0x70u
 
+#if _SUPPORT_NVRAM_RECORD_CRC
+/* User-page record format (both pages):
+ * Record #0: Words 0-3 (CRC8_Revision, ProgramCount and 0x1000-0x1001 (page #2: 0x103E-0x103F))
+ * Words 4-7: Check-byte per record (0xFF - NVRAM_CRC8() of the record); Not writable by NVRAM_Write()
+ * Record #n (1..7): Words 8n-(8n+7); Record #7 of page #2: Error-log (C_NVRAM_ERRLOG_OFFSET)
+ */
+#define C_NVRAM_RECORDS					8u					/* Records per user-page */
+#define C_NVRAM_RECORD_WORDS			8u					/* Words per record (record #0: 4) */
+#define C_NVRAM_RECORD_CHECK			4u					/* Word-offset of the check-bytes */
+#define C_NVRAM_RECORD_ALL				0xFFu
+#define C_NVRAM_ERRLOG_RECORD			(C_NVRAM_ERRLOG_OFFSET / (2u * C_NVRAM_RECORD_WORDS))
+#endif /* _SUPPORT_NVRAM_RECORD_CRC */
+
+#if _SUPPORT_NVRAM_LOG
+/* Log-structured store: C_NVRAM_LOG_SLOTS records on user-page #2 only; User-page #1
+ * (MOTOR_CALIBPARAMS, NAD) is not programmed by the log.
+ * Slot n: Page #2 word 8+4n, up to the error-log (records #1-#6 with _SUPPORT_NVRAM_RECORD_CRC)
+ * Appends use the next slot not holding the newest (programmed) record of a tag.
+ */
+#define C_NVRAM_LOG_SLOTS				12u
+#define C_NVRAM_LOG_SLOT_WORDS			4u
+#define C_NVRAM_LOG_PAGE2_WORD			8u					/* Behind the page header (record #0) */
+#define C_NVRAM_LOG_NONE				0xFFu
+#if ((C_NVRAM_LOG_PAGE2_WORD + (C_NVRAM_LOG_SLOTS * C_NVRAM_LOG_SLOT_WORDS)) > (C_NVRAM_ERRLOG_OFFSET / 2u))
+#error "ERROR: NVRAM log-slots overlap the error-log of user-page #2"
+#endif
+
+#define C_NVRAM_LOG_TAG_POSITION		0u					/* Valve position at stand-still */
+#define C_NVRAM_LOG_TAG_MOVES			1u					/* Number of position changes */
+#define C_NVRAM_LOG_TAGS				2u
+
+typedef struct _NVRAM_LOG_RECORD
+{
+	uint16 u16Sequence;										/* 0x00: Sequence-number (wraps) */
+	uint16 u16Tag_Check;									/* 0x02: Tag & Check-byte (0xFF - NVRAM_CRC8() of the record with check-byte 0x00) */
+	uint16 au16Value[2];									/* 0x04: 32-bits value (LSW first) */
+} NVRAM_LOG_RECORD, *PNVRAM_LOG_RECORD;
+#endif /* _SUPPORT_NVRAM_LOG */
+
 #define C_MAX_NVRAM_PROGRAM_COUNT		65000u				/* Maximum 65000 Write-cycles */
 #define C_MAX_ERRORS_PER_PAGE			12u
 
@@ -91,12 +132,30 @@ typedef struct _NVRAM_ERRORLOG
 #define C_NVRAM_STORE_MAX_WRITE_CYCLE	0x01u
 #define C_NVRAM_STORE_INVALID_COUNTER	0x02u
 
+#if _SUPPORT_NVRAM_WRITE_BACK
+#define C_NVRAM_COMMIT_DELAY			(1000u * PI_TICKS_PER_MILLISECOND)	/* Commit after 1s without NVRAM_Write() changes ... */
+#define C_NVRAM_COMMIT_MAX_DELAY		(10u * PI_TICKS_PER_SECOND)			/* ... but at most 10s after the first change */
+
+typedef struct _NVRAM_CACHE_STATS
+{
+	uint16 u16Writes;														/* NVRAM_Write() calls with changed data */
+	uint16 u16Commits;														/* User-page programs by the write-back cache */
+	uint16 u16MaxDirtyTicks;												/* Longest time between first change and commit [ticks] */
+} NVRAM_CACHE_STATS, *PNVRAM_CACHE_STATS;
+#endif /* _SUPPORT_NVRAM_WRITE_BACK */
+
 
 #pragma space dp
 #pragma space none
 
 
 #pragma space nodp
+#if _SUPPORT_NVRAM_RECORD_CRC
+extern uint8 g_u8NvramRecordErrors;											/* Records found corrupted (and cleared), saturated */
+#endif /* _SUPPORT_NVRAM_RECORD_CRC */
+#if _SUPPORT_NVRAM_WRITE_BACK
+extern uint8 g_u8NvramDirtyPages;											/* C_NVRAM_USER_PAGE_x: Shadow-RAM changed, not yet programmed */
+#endif /* _SUPPORT_NVRAM_WRITE_BACK */
 #pragma space none
 
 
@@ -109,6 +168,18 @@ extern uint8 NVRAM_Write(uint16 addr,const uint16 buf[],uint16 size);
 
 extern uint16 NVRAM_Store(uint16 u16Page);
 extern void NVRAM_StorePatch( void);											/* Store patch NVRAM page (shadow RAM to NVRAM) and load all NVRAM pages */
+extern void NVRAM_WaitReady( void);												/* Wait till a (non-waiting) page program is completed */
+#if _SUPPORT_NVRAM_WRITE_BACK || _SUPPORT_NVRAM_RECORD_CRC
+extern void NVRAM_MainFunction( void);											/* Commit changed user-pages at an idle point (non-blocking), check deferred records */
+#endif /* _SUPPORT_NVRAM_WRITE_BACK || _SUPPORT_NVRAM_RECORD_CRC */
+#if _SUPPORT_NVRAM_WRITE_BACK
+extern void NVRAM_Flush( void);													/* Commit all changed user-pages (blocking) */
+extern void NVRAM_GetCacheStats( PNVRAM_CACHE_STATS pStats);					/* Get write-back cache statistics */
+#endif /* _SUPPORT_NVRAM_WRITE_BACK */
+#if _SUPPORT_NVRAM_LOG
+extern uint16 NVRAM_LogPut( uint16 u16Tag, uint32 u32Value);					/* Append value to the log-structured store */
+extern uint16 NVRAM_LogGet( uint16 u16Tag, uint32 *pu32Value);					/* Get newest value from the log-structured store */
+#endif /* _SUPPORT_NVRAM_LOG */
 
 /* error log */
 extern uint16 NVRAM_LogError( uint8 u8ErrorCode);								/* Store servire error code */
@@ -12,9 +12,12 @@
  *
  * \functions	ThresholdControl()
  *				PID_Init()
+ *				VoltageCorrectionScale()
  *				VoltageCorrection()
  *				PID_Control()
  *				SelfHeatCompensation()
+ *				LoadAdaptiveCurrentInit()
+ *				LoadAdaptiveCurrentControl()
  *
  *
  * MELEXIS Microelectronic Integrated Systems
@@ -38,10 +41,15 @@
 #include "PID_Control.h"
 #include "ADC.h"
 #include "MotorDriver.h"
+#include "Diagnostic.h"
 #include "NVRAM_UserPage.h"														/* NVRAM User-page support */
 #include "private_mathlib.h"
 #include <mathlib.h>															/* Use Melexis math-library functions to avoid compiler warnings */
 
+#if _SUPPORT_LOAD_ADAPTIVE_CURRENT && (_SUPPORT_HALL_SENSOR == FALSE)
+#error "ERROR: Load-adaptive running current requires the hall-sensor (_SUPPORT_HALL_SENSOR)"
+#endif /* _SUPPORT_LOAD_ADAPTIVE_CURRENT && (_SUPPORT_HALL_SENSOR == FALSE) */
+
 /* ****************************************************************************	*
  *	NORMAL PAGE 0 IMPLEMENTATION (@TINY Memory Space < 0x100)					*
  * ****************************************************************************	*/
@@ -61,6 +69,7 @@ uint16 g_u16PidHoldingThreshold;												/* 5: Motor holding current threshol
 uint16 g_u16PidHoldingThresholdADC;												/* 5: Motor holding current threshold (ADC) */
 uint16 g_u16PidRunningThreshold;												/* 5: Motor current threshold (running) */
 uint16 g_u16PidRunningThresholdADC;												/* 5: Motor current threshold (running) (ADC) */
+uint16 l_u16CurrThrshldRatio = C_GMCURR_DIV;									/* Temperature current-threshold ratio (ThresholdControl) */
 uint16 l_u16MinCorrectionRatio;													/* MMP150509-2 */
 uint16 l_u16MaxCorrectionRatio;													/* MMP150509-2 */
 #if _SUPPORT_AMBIENT_TEMP
@@ -69,6 +78,15 @@ uint32 l_u32SelfHeatingIntegrator = 0;
 #endif /* _SUPPORT_AMBIENT_TEMP */
 uint16 g_u16MotorRefVoltage = 1200;												/* Motor reference voltage:not used */
 uint16 l_u16MotorRefVoltageADC = (uint16) ((12*1024)/(2.5*14));					/* 12.00V [ADC-LSB] */
+#if _SUPPORT_VOLTAGE_CORR_SCALE
+uint16 l_u16VoltageCorrScale = 0u;												/* Vref/Vsm [Q2.14]; 0: No correction */
+uint16 l_u16VoltageCorrVsmADC = 0u;												/* Vsm [ADC-LSB] of l_u16VoltageCorrScale */
+#endif /* _SUPPORT_VOLTAGE_CORR_SCALE */
+
+#if _SUPPORT_LOAD_ADAPTIVE_CURRENT
+int16 l_i16RotorLagFlt = 0;														/* Filtered rotor-lag at the hall-edges [1/256 full-step] */
+uint8 l_u8HallEdgeCountPre = 0u;												/* Hall-edges handled by LoadAdaptiveCurrentControl() */
+#endif /* _SUPPORT_LOAD_ADAPTIVE_CURRENT */
 
 #if _DEBUG_VOLTAGE_COMPENSATION
 int16 l_ai16MotorVolt[SZ_MOTOR_VOLT_COMP];
@@ -96,25 +114,72 @@ void PID_Init( void)
 
 	l_u16MinCorrectionRatio = NVRAM_MIN_CORR_RATIO;								/* MMP150509-2 */
 	l_u16MaxCorrectionRatio = NVRAM_MAX_CORR_RATIO;								/* MMP150509-2 */
+#if _SUPPORT_VOLTAGE_CORR_SCALE
+	l_u16VoltageCorrVsmADC = 0u;
+	VoltageCorrectionScale();
+#endif /* _SUPPORT_VOLTAGE_CORR_SCALE */
 } /* End of PID_Init() */
 
+#if _SUPPORT_VOLTAGE_CORR_SCALE
+/* ***
+ * VoltageCorrectionScale()
+ *
+ *	Calculate the Vref/Vsm scale-factor for VoltageCorrection(); Only in case
+ *	the motor-driver voltage has changed (main-loop, every ms).
+ * Performance: 7.5us @ 20Mz (Vsm changed)
+ * ***/
+void VoltageCorrectionScale( void)
+{
+	uint16 u16MotorVoltageADC = GetRawVsupplyMotor();
+	if ( u16MotorVoltageADC != l_u16VoltageCorrVsmADC )
+	{
+		uint16 u16Scale = 0u;
+		if ( (u16MotorVoltageADC > 0u) && (l_u16MotorRefVoltageADC > 0u) )
+		{
+			if ( (l_u16MotorRefVoltageADC >> (16u - C_VOLTAGE_CORR_Q)) >= u16MotorVoltageADC )
+			{
+				u16Scale = 0xFFFFu;												/* Vsm below Vref/4: Saturate */
+			}
+			else
+			{
+				u16Scale = divU16_U32byU16( ((uint32) l_u16MotorRefVoltageADC << C_VOLTAGE_CORR_Q) + (u16MotorVoltageADC >> 1u), u16MotorVoltageADC);
+			}
+		}
+		l_u16VoltageCorrScale = u16Scale;
+		l_u16VoltageCorrVsmADC = u16MotorVoltageADC;
+	}
+} /* End of VoltageCorrectionScale() */
+#endif /* _SUPPORT_VOLTAGE_CORR_SCALE */
+
 /* ***
  * VoltageCorrection()
  *
  *	Compensate Motor PWM Duty Cycle for voltage changes
- * Performance: 7.5us @ 20Mz
+ * Performance: 7.5us @ 20Mz (_SUPPORT_VOLTAGE_CORR_SCALE: One multiply, instead of the division)
  * ***/
 void VoltageCorrection( void)
 {
+#if _SUPPORT_VOLTAGE_CORR_SCALE
+	uint16 u16Scale = l_u16VoltageCorrScale;
+#else  /* _SUPPORT_VOLTAGE_CORR_SCALE */
 	uint16 u16MotorVoltageADC = GetRawVsupplyMotor();
+#endif /* _SUPPORT_VOLTAGE_CORR_SCALE */
 #if _DEBUG_VOLTAGE_COMPENSATION
 	l_ai16MotorVolt[u16MotorVoltIdx] = g_i16MotorVoltage;
 	u16MotorVoltIdx = (u16MotorVoltIdx + 1u) & (SZ_MOTOR_VOLT_COMP - 1u);
 #endif /* _DEBUG_VOLTAGE_COMPENSATION */
+#if _SUPPORT_VOLTAGE_CORR_SCALE
+	if ( u16Scale != 0u )
+	{
+		/* Correct Motor PWM duty cycle instantly based on change of supply voltage */
+		uint32 u32NewCorrectionRatio = (mulU32_U16byU16( g_u16PidCtrlRatio, u16Scale) + (1UL << (C_VOLTAGE_CORR_Q - 1u))) >> C_VOLTAGE_CORR_Q;
+		uint16 u16NewCorrectionRatio = (u32NewCorrectionRatio > 0xFFFFUL) ? 0xFFFFu : (uint16) u32NewCorrectionRatio;
+#else  /* _SUPPORT_VOLTAGE_CORR_SCALE */
 	if ( (u16MotorVoltageADC > 0u) && (l_u16MotorRefVoltageADC > 0u) )
 	{
 		/* Correct Motor PWM duty cycle instantly based on change of supply voltage */
 		uint16 u16NewCorrectionRatio = divU16_U32byU16( mulU32_U16byU16( g_u16PidCtrlRatio, l_u16MotorRefVoltageADC), u16MotorVoltageADC);
+#endif /* _SUPPORT_VOLTAGE_CORR_SCALE */
 		if ( g_u8MotorStartupMode !=  (uint8)MSM_STOP  )
 		{
 			if ( u16NewCorrectionRatio < l_u16MinCorrectionRatio )
@@ -332,6 +397,7 @@ void ThresholdControl( void)
 				u16CurrThrshldRatio = 0u;										/* Shutdown motor */
 			}
 		}
+		l_u16CurrThrshldRatio = u16CurrThrshldRatio;
 		{
 			uint16 u16MCurrgain = EE_GMCURR;
 			g_u16PidHoldingThresholdADC = muldivU16_U16byU16byU16( g_u16PidHoldingThreshold, u16CurrThrshldRatio, u16MCurrgain);		/* MMP141209-1/MMP131219-1 */
@@ -366,4 +432,73 @@ void SelfHeatCompensation( void)
 } /* End of SelfHeatCompensation() */
 #endif /* _SUPPORT_AMBIENT_TEMP */
 
+#if _SUPPORT_LOAD_ADAPTIVE_CURRENT
+/* ***
+ * LoadAdaptiveCurrentInit()
+ *
+ *	Start of a motor movement at the (NVRAM) running current.
+ * ***/
+void LoadAdaptiveCurrentInit( void)
+{
+	g_u16PidRunningThreshold = NVRAM_RUNNING_CURR_LEVEL;
+	g_u16PidRunningThresholdADC = muldivU16_U16byU16byU16( g_u16PidRunningThreshold, l_u16CurrThrshldRatio, EE_GMCURR);
+	l_i16RotorLagFlt = 0;
+	l_u8HallEdgeCountPre = g_u8HallEdgeCount;
+} /* End of LoadAdaptiveCurrentInit() */
+
+/* ***
+ * LoadAdaptiveCurrentControl()
+ *
+ *	Torque-margin control; Once per hall-edge, the running current is lowered
+ *	(at constant speed) while the rotor-lag is small and raised as soon as the
+ *	lag grows. Range: 50% to 100% of the NVRAM running current.
+ *	The edge count and the captured edge are read in one atomic section.
+ * ***/
+void LoadAdaptiveCurrentControl( void)
+{
+	uint8 u8HallEdgeCount;
+	T_HALL_EDGE HallEdge;
+
+	ATOMIC_CODE
+	(
+		u8HallEdgeCount = g_u8HallEdgeCount;
+		HallEdge = g_HallEdge;
+	);
+	if ( u8HallEdgeCount != l_u8HallEdgeCountPre )
+	{
+		uint16 u16RunningThreshold = g_u16PidRunningThreshold;
+
+		l_u8HallEdgeCountPre = u8HallEdgeCount;
+		l_i16RotorLagFlt += (HallEdgeRotorLag( &HallEdge) - l_i16RotorLagFlt) >> 2;	/* IIR-1: 1/4 */
+		if ( l_i16RotorLagFlt > (int16) C_HALL_LAG_HIGH )
+		{
+			/* Torque-margin too small: Increase running current by 1/8 */
+			u16RunningThreshold += (NVRAM_RUNNING_CURR_LEVEL >> 3);
+			if ( u16RunningThreshold > NVRAM_RUNNING_CURR_LEVEL )
+			{
+				u16RunningThreshold = NVRAM_RUNNING_CURR_LEVEL;
+			}
+		}
+		else if ( (l_i16RotorLagFlt < (int16) C_HALL_LAG_LOW) && (g_u8MotorStartupMode == (uint8) MSM_STEPPER_C) )
+		{
+			/* Light load: Decrease running current by 1/32 */
+			u16RunningThreshold -= (NVRAM_RUNNING_CURR_LEVEL >> 5);
+			if ( u16RunningThreshold < (NVRAM_RUNNING_CURR_LEVEL >> 1) )
+			{
+				u16RunningThreshold = (NVRAM_RUNNING_CURR_LEVEL >> 1);
+			}
+		}
+		else
+		{
+			/* MISRA C:2012 Rule-15.7:All if ... else if constructs shall be terminated with an else statement */
+		}
+		if ( u16RunningThreshold != g_u16PidRunningThreshold )
+		{
+			g_u16PidRunningThreshold = u16RunningThreshold;
+			g_u16PidRunningThresholdADC = muldivU16_U16byU16byU16( u16RunningThreshold, l_u16CurrThrshldRatio, EE_GMCURR);
+		}
+	}
+} /* End of LoadAdaptiveCurrentControl() */
+#endif /* _SUPPORT_LOAD_ADAPTIVE_CURRENT */
+
 /* EOF */
@@ -29,16 +29,27 @@
 #endif /* SYSLIB_H_ */
 #include "Build.h"
 
+#if _SUPPORT_VOLTAGE_CORR_SCALE
+#define C_VOLTAGE_CORR_Q		14U												/* Vref/Vsm scale-factor: Q2.14 (0..4) */
+#endif /* _SUPPORT_VOLTAGE_CORR_SCALE */
+
 /* ****************************************************************************	*
  *	P u b l i c   f u n c t i o n s												*
  * ****************************************************************************	*/
 extern void PID_Init( void);
 extern void PID_Control( void);
+#if _SUPPORT_VOLTAGE_CORR_SCALE
+extern void VoltageCorrectionScale( void);
+#endif /* _SUPPORT_VOLTAGE_CORR_SCALE */
 extern void VoltageCorrection( void);
 extern void ThresholdControl( void);
 #if _SUPPORT_AMBIENT_TEMP
 extern void SelfHeatCompensation( void);
 #endif /* _SUPPORT_AMBIENT_TEMP */
+#if _SUPPORT_LOAD_ADAPTIVE_CURRENT
+extern void LoadAdaptiveCurrentInit( void);
+extern void LoadAdaptiveCurrentControl( void);
+#endif /* _SUPPORT_LOAD_ADAPTIVE_CURRENT */
 
 /* ****************************************************************************	*
  *	P u b l i c   v a r i a b l e s												*
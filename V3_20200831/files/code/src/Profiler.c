@@ -0,0 +1,128 @@
+/*! ----------------------------------------------------------------------------
+ * \file		Profiler.c
+ * \brief		MLX81310 ISR and main-loop task execution-time profiler
+ *
+ * \note		project MLX81310
+ *
+ * \author 		Marcel Braat
+ *
+ * \date 		2020-09-07
+ *
+ * \version 	1.0 - preliminary
+ *
+ * \functions	Profiler_Init()
+ *				Profiler_Stop()
+ *				Profiler_Get()
+ *				Profiler_Clear()
+ *
+ * MELEXIS Microelectronic Integrated Systems
+ *
+ * Copyright (C) 2020-2020 Melexis N.V.
+ * The Software is being delivered 'AS IS' and Melexis, whether explicitly or
+ * implicitly, makes no warranty as to its Use or performance.
+ * The user accepts the Melexis Firmware License Agreement.
+ *
+ * Melexis confidential & proprietary
+ * ****************************************************************************	*/
+
+#include "Build.h"
+
+#if _SUPPORT_PROFILER
+
+#include "Profiler.h"
+#include "lib_mlx315_misc.h"
+#include <syslib.h>
+
+/* ****************************************************************************	*
+ *	NORMAL FAR IMPLEMENTATION	( NEAR Memory Space >= 0x100)					*
+ * ****************************************************************************	*/
+#pragma space nodp																/* __NEAR_SECTION__ */
+PROFILE_DATA l_aProfileData[MAX_PROFILE];										/* Per ISR/task execution-time statistics */
+#pragma space none																/* __NEAR_SECTION__ */
+
+/* ****************************************************************************	*
+ * Profiler_Init()
+ *
+ * Start Timer2 as free-running CPU-cycle counter and clear statistics.
+ * Note: Must be called before the interrupts are enabled.
+ * ****************************************************************************	*/
+void Profiler_Init( void)
+{
+	TMR2_CTRL = C_PROFILER_TMR_CTRL;											/* Timer mode 0, Divider 1 */
+	TMR2_REGB = C_PROFILER_TMR_PERIOD;
+	TMR2_CTRL = C_PROFILER_TMR_CTRL | TMRx_START;								/* Start free-running timer */
+
+	Profiler_Clear( MAX_PROFILE);
+} /* End of Profiler_Init() */
+
+/* ****************************************************************************	*
+ * Profiler_Stop()
+ *
+ * Update statistics of profile u16ProfileID with the time elapsed since
+ * u16StartTime. Each profile-entry is only updated from its own context.
+ * Performance: 2.0us @ 28MHz
+ * ****************************************************************************	*/
+void Profiler_Stop( uint16 u16ProfileID, uint16 u16StartTime)
+{
+	PPROFILE_DATA pProfileData = &l_aProfileData[u16ProfileID];
+	uint16 u16Time = TMR2_CNT - u16StartTime;									/* Wrap-around safe (< 65536 cycles) */
+
+	if ( u16Time < pProfileData->u16Min )
+	{
+		pProfileData->u16Min = u16Time;
+	}
+	if ( u16Time > pProfileData->u16Max )
+	{
+		pProfileData->u16Max = u16Time;
+	}
+	if ( pProfileData->u16Count == 0xFFFFU )
+	{
+		/* Counter overflow: Halve sum and count; Mean remains the same */
+		pProfileData->u32Sum = (pProfileData->u32Sum >> 1);
+		pProfileData->u16Count = (pProfileData->u16Count >> 1);
+	}
+	pProfileData->u32Sum += u16Time;
+	pProfileData->u16Count++;
+} /* End of Profiler_Stop() */
+
+/* ****************************************************************************	*
+ * Profiler_Get()
+ *
+ * Get (consistent) copy of profile u16ProfileID statistics.
+ * ****************************************************************************	*/
+void Profiler_Get( uint16 u16ProfileID, PPROFILE_DATA pProfileData)
+{
+	ATOMIC_CODE
+	(
+		*pProfileData = l_aProfileData[u16ProfileID];
+	);
+} /* End of Profiler_Get() */
+
+/* ****************************************************************************	*
+ * Profiler_Clear()
+ *
+ * Clear statistics of profile u16ProfileID; All profiles in case u16ProfileID
+ * is MAX_PROFILE (or above).
+ * ****************************************************************************	*/
+void Profiler_Clear( uint16 u16ProfileID)
+{
+	uint16 u16Idx;
+	for ( u16Idx = 0u; u16Idx < (uint16) MAX_PROFILE; u16Idx++ )
+	{
+		if ( (u16ProfileID >= (uint16) MAX_PROFILE) || (u16ProfileID == u16Idx) )
+		{
+			PPROFILE_DATA pProfileData = &l_aProfileData[u16Idx];
+			ATOMIC_CODE
+			(
+				pProfileData->u16Min = 0xFFFFU;
+				pProfileData->u16Max = 0u;
+				pProfileData->u32Sum = 0u;
+				pProfileData->u16Count = 0u;
+			);
+		}
+	}
+} /* End of Profiler_Clear() */
+
+#endif /* _SUPPORT_PROFILER */
+
+/* EOF */
@@ -0,0 +1,94 @@
+/*! \file		Profiler.h
+ *  \brief		MLX81310 ISR and main-loop task execution-time profiler
+ *
+ * \note		project MLX81310
+ *
+ * \author 		Marcel Braat
+ *
+ * \date 		2020-09-07
+ *
+ * \version 	1.0 - preliminary
+ *
+ *
+ * MELEXIS Microelectronic Integrated Systems
+ *
+ * Copyright (C) 2020-2020 Melexis N.V.
+ * The Software is being delivered 'AS IS' and Melexis, whether explicitly or
+ * implicitly, makes no warranty as to its Use or performance.
+ * The user accepts the Melexis Firmware License Agreement.
+ *
+ * Melexis confidential & proprietary
+ *
+ * ****************************************************************************	*/
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#ifndef SYSLIB_H_
+#include "syslib.h"
+#endif /* SYSLIB_H_ */
+#include "Build.h"
+
+#if _SUPPORT_PROFILER
+
+/* Timer2 is free-running (Timer mode 0, Divider 1): 1 LSB = 1 MLX16 CPU-cycle; Wrap-around each 65536 cycles (2.34ms @ 28MHz) */
+#define C_PROFILER_TMR_CTRL			((0U * TMRx_DIV0) | (0U * TMRx_MODE0) | TMRx_T_EBLK)
+#define C_PROFILER_TMR_PERIOD		0xFFFFU
+
+typedef enum
+{
+	PROFILE_EXT0_IT = 0,														/* Commutation ISR */
+	PROFILE_SOFT_IT,															/* Commutation ISR bottom-half */
+	PROFILE_TIMER_IT,															/* Core-timer ISR */
+	PROFILE_EXT4_IT,															/* Diagnostic ISR */
+	PROFILE_ADC_IT,																/* ADC ISR */
+	PROFILE_LIN_IT,																/* LIN ISR (ml_LinInterruptHandler) */
+	PROFILE_TASK_APPL,															/* Main-loop: App_CoolantValveSM() */
+	PROFILE_TASK_MOTOR,															/* Main-loop: MotorDriver_MainFunction() */
+	PROFILE_TASK_LIN,															/* Main-loop: LIN_MainFunction() */
+	PROFILE_TASK_BG_MEMORY,														/* Main-loop: System_BackgroundMemoryTest() */
+	PROFILE_TASK_BG_IOREG,														/* Main-loop: System_BackgroundIORegTest() */
+#if _SUPPORT_NVRAM_WRITE_BACK || _SUPPORT_NVRAM_RECORD_CRC
+	PROFILE_TASK_NVRAM,															/* Main-loop: NVRAM_MainFunction() */
+#endif /* _SUPPORT_NVRAM_WRITE_BACK || _SUPPORT_NVRAM_RECORD_CRC */
+#if (_DEBUG > 0u) && (_DEBUG_NVRAM_ERRORLOG > 0u)
+	PROFILE_TASK_ERRLOG,														/* Main-loop: ErrorLog_MainFunction() */
+#endif /* (_DEBUG > 0u) && (_DEBUG_NVRAM_ERRORLOG > 0u) */
+	MAX_PROFILE
+} PROFILE_ID;
+
+typedef struct _PROFILE_DATA
+{
+	uint16 u16Min;																/* Minimum execution time [CPU-cycles] */
+	uint16 u16Max;																/* Maximum execution time [CPU-cycles] */
+	uint32 u32Sum;																/* Sum of execution times [CPU-cycles] */
+	uint16 u16Count;															/* Number of measurements in u32Sum */
+} PROFILE_DATA, *PPROFILE_DATA;
+
+/* Start/stop of an ISR measurement; PROFILER_START() declares the start time-stamp */
+#define PROFILER_START()			uint16 u16ProfileStart = TMR2_CNT
+#define PROFILER_STOP(id)			Profiler_Stop( (id), u16ProfileStart)
+/* Measurement of a main-loop task (code-block) */
+#define PROFILER_CODE(id, __code__)	do { uint16 u16ProfileStart = TMR2_CNT; __code__; Profiler_Stop( (id), u16ProfileStart); } while(0)
+
+#else  /* _SUPPORT_PROFILER */
+
+#define PROFILER_START()
+#define PROFILER_STOP(id)
+#define PROFILER_CODE(id, __code__)	do { __code__; } while(0)
+
+#endif /* _SUPPORT_PROFILER */
+
+#if _SUPPORT_PROFILER
+/* ****************************************************************************	*
+ *	P u b l i c   f u n c t i o n s												*
+ * ****************************************************************************	*/
+extern void Profiler_Init( void);
+extern void Profiler_Stop( uint16 u16ProfileID, uint16 u16StartTime);
+extern void Profiler_Get( uint16 u16ProfileID, PPROFILE_DATA pProfileData);
+extern void Profiler_Clear( uint16 u16ProfileID);
+#endif /* _SUPPORT_PROFILER */
+
+#endif /* PROFILER_H_ */
+
+/* EOF */
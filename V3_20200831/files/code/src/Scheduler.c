@@ -0,0 +1,242 @@
+/*! ----------------------------------------------------------------------------
+ * \file		Scheduler.c
+ * \brief		MLX81310 Main-loop rate-group scheduler
+ *
+ * \note		project MLX81310
+ *
+ * \author 		Marcel Braat
+ *
+ * \date 		2020-10-12
+ *
+ * \version 	1.0 - preliminary
+ *
+ * \functions	Scheduler_Init()
+ *				Scheduler_MainFunction()
+ *				Scheduler_GetIdleTicks()
+ *				Scheduler_Get()
+ *
+ * Cooperative, static schedule of the main-loop tasks. A task belongs to one
+ * rate group (1ms, 10ms or 100ms), released on the core timer tick-counter,
+ * and/or is triggered by events (e.g. LIN frame received). The tasks run in
+ * the order of l_aSchedTask[]; Each task runs to completion.
+ * A rate group which is released one period (or more) late is counted as
+ * overrun and re-aligned to the current tick; A task which runs longer than
+ * its group period is counted as task overrun.
+ * The task execution time is measured in core timer ticks (overruns) and,
+ * with the profiler, in CPU-cycles of the free-running Timer2.
+ *
+ * MELEXIS Microelectronic Integrated Systems
+ *
+ * Copyright (C) 2020-2020 Melexis N.V.
+ * The Software is being delivered 'AS IS' and Melexis, whether explicitly or
+ * implicitly, makes no warranty as to its Use or performance.
+ * The user accepts the Melexis Firmware License Agreement.
+ *
+ * Melexis confidential & proprietary
+ * ****************************************************************************	*/
+
+#include "Build.h"
+
+#if _SUPPORT_SCHEDULER
+
+#include "Scheduler.h"
+#include "Timer.h"
+#include "Profiler.h"
+#include "MotorDriver.h"
+#include "LIN_Communication.h"
+#include "app_coolantvalve.h"
+#include "system_background.h"
+#include "NVRAM_UserPage.h"
+#include "ErrorCodes.h"
+#include <syslib.h>
+
+#if _SUPPORT_PROFILER
+#define SCHED_PROFILE_ID(id)		((uint8) (id))
+#else  /* _SUPPORT_PROFILER */
+#define SCHED_PROFILE_ID(id)		0u
+#endif /* _SUPPORT_PROFILER */
+
+/* Static schedule (order of execution); Index: SCHED_TASK_ID */
+static const SCHED_TASK l_aSchedTask[MAX_SCHED_TASK] =
+{
+	{ LIN_MainFunction,				C_SCHED_GROUP_10MS,	 C_SCHED_EVENT_LIN,	 SCHED_PROFILE_ID( PROFILE_TASK_LIN) },
+	{ App_CoolantValveSM,			C_SCHED_GROUP_10MS,	 C_SCHED_EVENT_LIN,	 SCHED_PROFILE_ID( PROFILE_TASK_APPL) },
+	{ MotorDriver_MainFunction,		C_SCHED_GROUP_1MS,	 C_SCHED_EVENT_NONE, SCHED_PROFILE_ID( PROFILE_TASK_MOTOR) },
+	{ System_BackgroundMemoryTest,	C_SCHED_GROUP_10MS,	 C_SCHED_EVENT_NONE, SCHED_PROFILE_ID( PROFILE_TASK_BG_MEMORY) },
+	{ System_BackgroundIORegTest,	C_SCHED_GROUP_100MS, C_SCHED_EVENT_NONE, SCHED_PROFILE_ID( PROFILE_TASK_BG_IOREG) },
+#if _SUPPORT_NVRAM_WRITE_BACK || _SUPPORT_NVRAM_RECORD_CRC
+	{ NVRAM_MainFunction,			C_SCHED_GROUP_100MS, C_SCHED_EVENT_NONE, SCHED_PROFILE_ID( PROFILE_TASK_NVRAM) },
+#endif /* _SUPPORT_NVRAM_WRITE_BACK || _SUPPORT_NVRAM_RECORD_CRC */
+#if (_DEBUG > 0u) && (_DEBUG_NVRAM_ERRORLOG > 0u)
+	{ ErrorLog_MainFunction,		C_SCHED_GROUP_100MS, C_SCHED_EVENT_NONE, SCHED_PROFILE_ID( PROFILE_TASK_ERRLOG) },
+#endif /* (_DEBUG > 0u) && (_DEBUG_NVRAM_ERRORLOG > 0u) */
+};
+
+static const uint16 l_au16SchedPeriod[C_SCHED_MAX_GROUP] =
+{
+	C_SCHED_PERIOD_1MS, C_SCHED_PERIOD_10MS, C_SCHED_PERIOD_100MS
+};
+
+/* ****************************************************************************	*
+ *	NORMAL FAR IMPLEMENTATION	( NEAR Memory Space >= 0x100)					*
+ * ****************************************************************************	*/
+#pragma space nodp																/* __NEAR_SECTION__ */
+volatile uint8 g_u8SchedulerEvents = C_SCHED_EVENT_NONE;						/* Pending events */
+uint8 g_au8SchedulerGroupOverruns[C_SCHED_MAX_GROUP];							/* Missed releases per rate group */
+uint16 l_au16SchedRelease[C_SCHED_MAX_GROUP];									/* Tick-counter of the next release */
+SCHED_DATA l_aSchedData[MAX_SCHED_TASK];										/* Per task statistics */
+#pragma space none																/* __NEAR_SECTION__ */
+
+/* ****************************************************************************	*
+ * Scheduler_Init()
+ *
+ * Release all rate groups at the next tick; The 10ms and 100ms groups are
+ * offset by one tick to the faster groups, to spread the load.
+ * ****************************************************************************	*/
+void Scheduler_Init( void)
+{
+	uint16 u16Idx;
+	uint16 u16Ticks = g_u16TimerTicks;
+
+	for ( u16Idx = 0u; u16Idx < C_SCHED_MAX_GROUP; u16Idx++ )
+	{
+		l_au16SchedRelease[u16Idx] = u16Ticks + u16Idx;
+		g_au8SchedulerGroupOverruns[u16Idx] = 0u;
+	}
+	for ( u16Idx = 0u; u16Idx < (uint16) MAX_SCHED_TASK; u16Idx++ )
+	{
+		l_aSchedData[u16Idx].u16Count = 0u;
+		l_aSchedData[u16Idx].u16MaxTicks = 0u;
+#if _SUPPORT_PROFILER
+		l_aSchedData[u16Idx].u16MaxCycles = 0u;
+#endif /* _SUPPORT_PROFILER */
+		l_aSchedData[u16Idx].u8Overruns = 0u;
+	}
+	g_u8SchedulerEvents = C_SCHED_EVENT_NONE;
+} /* End of Scheduler_Init() */
+
+/* ****************************************************************************	*
+ * Scheduler_MainFunction()
+ *
+ * Run the tasks of the released rate groups and of the pending events.
+ * ****************************************************************************	*/
+void Scheduler_MainFunction( void)
+{
+	uint16 u16Idx;
+	uint8 u8Released = 0u;														/* Bit n: Group n released */
+	uint8 u8Events;
+	uint16 u16Ticks = g_u16TimerTicks;
+
+	for ( u16Idx = 0u; u16Idx < C_SCHED_MAX_GROUP; u16Idx++ )
+	{
+		int16 i16Late = (int16) (u16Ticks - l_au16SchedRelease[u16Idx]);
+		if ( i16Late >= 0 )
+		{
+			u8Released |= (uint8) (1u << u16Idx);
+			if ( (uint16) i16Late >= l_au16SchedPeriod[u16Idx] )
+			{
+				/* Missed one or more releases: Overrun; Re-align */
+				if ( g_au8SchedulerGroupOverruns[u16Idx] != 0xFFu )
+				{
+					g_au8SchedulerGroupOverruns[u16Idx]++;
+				}
+				l_au16SchedRelease[u16Idx] = u16Ticks;
+			}
+			l_au16SchedRelease[u16Idx] += l_au16SchedPeriod[u16Idx];
+		}
+	}
+	ATOMIC_CODE
+	(
+		u8Events = g_u8SchedulerEvents;
+		g_u8SchedulerEvents = C_SCHED_EVENT_NONE;
+	);
+
+	for ( u16Idx = 0u; u16Idx < (uint16) MAX_SCHED_TASK; u16Idx++ )
+	{
+		const SCHED_TASK *pTask = &l_aSchedTask[u16Idx];
+		if ( ((pTask->u8Group < C_SCHED_MAX_GROUP) && ((u8Released & (uint8) (1u << pTask->u8Group)) != 0u)) ||
+			 ((pTask->u8Events & u8Events) != 0u) )
+		{
+			PSCHED_DATA pSchedData = &l_aSchedData[u16Idx];
+			uint16 u16Start = g_u16TimerTicks;
+			uint16 u16Time;
+#if _SUPPORT_PROFILER
+			uint16 u16StartCycles = TMR2_CNT;
+			uint16 u16Cycles;
+			pTask->pfnTask();
+			u16Cycles = TMR2_CNT - u16StartCycles;
+			u16Time = g_u16TimerTicks - u16Start;
+			Profiler_Stop( pTask->u8ProfileID, u16StartCycles);
+			if ( u16Time >= C_SCHED_CYCLES_MAX_TICKS )
+			{
+				u16Cycles = 0xFFFFu;											/* Timer2 may have wrapped-around */
+			}
+			if ( u16Cycles > pSchedData->u16MaxCycles )
+			{
+				pSchedData->u16MaxCycles = u16Cycles;
+			}
+#else  /* _SUPPORT_PROFILER */
+			pTask->pfnTask();
+			u16Time = g_u16TimerTicks - u16Start;
+#endif /* _SUPPORT_PROFILER */
+			if ( u16Time > pSchedData->u16MaxTicks )
+			{
+				pSchedData->u16MaxTicks = u16Time;
+			}
+			if ( (pTask->u8Group < C_SCHED_MAX_GROUP) && (u16Time >= l_au16SchedPeriod[pTask->u8Group]) &&
+				 (pSchedData->u8Overruns != 0xFFu) )
+			{
+				pSchedData->u8Overruns++;
+			}
+			pSchedData->u16Count++;
+		}
+	}
+} /* End of Scheduler_MainFunction() */
+
+/* ****************************************************************************	*
+ * Scheduler_GetIdleTicks()
+ *
+ * Returns the number of ticks until the next rate group release; 0: A group
+ * is released or an event is pending.
+ * ****************************************************************************	*/
+uint16 Scheduler_GetIdleTicks( void)
+{
+	uint16 u16Idx;
+	uint16 u16IdleTicks = 0xFFFFu;
+	uint16 u16Ticks = g_u16TimerTicks;
+
+	if ( g_u8SchedulerEvents != C_SCHED_EVENT_NONE )
+	{
+		return ( 0u );
+	}
+	for ( u16Idx = 0u; u16Idx < C_SCHED_MAX_GROUP; u16Idx++ )
+	{
+		int16 i16Left = (int16) (l_au16SchedRelease[u16Idx] - u16Ticks);
+		if ( i16Left <= 0 )
+		{
+			return ( 0u );
+		}
+		if ( (uint16) i16Left < u16IdleTicks )
+		{
+			u16IdleTicks = (uint16) i16Left;
+		}
+	}
+	return ( u16IdleTicks );
+} /* End of Scheduler_GetIdleTicks() */
+
+/* ****************************************************************************	*
+ * Scheduler_Get()
+ *
+ * Get statistics of task u16TaskID.
+ * ****************************************************************************	*/
+void Scheduler_Get( uint16 u16TaskID, PSCHED_DATA pSchedData)
+{
+	if ( u16TaskID < (uint16) MAX_SCHED_TASK )
+	{
+		*pSchedData = l_aSchedData[u16TaskID];
+	}
+} /* End of Scheduler_Get() */
+
+#endif /* _SUPPORT_SCHEDULER */
+
+/* EOF */
@@ -0,0 +1,118 @@
+/*! \file		Scheduler.h
+ *  \brief		MLX81310 Main-loop rate-group scheduler
+ *
+ * \note		project MLX81310
+ *
+ * \author 		Marcel Braat
+ *
+ * \date 		2020-10-12
+ *
+ * \version 	1.0 - preliminary
+ *
+ *
+ * MELEXIS Microelectronic Integrated Systems
+ *
+ * Copyright (C) 2020-2020 Melexis N.V.
+ * The Software is being delivered 'AS IS' and Melexis, whether explicitly or
+ * implicitly, makes no warranty as to its Use or performance.
+ * The user accepts the Melexis Firmware License Agreement.
+ *
+ * Melexis confidential & proprietary
+ *
+ * ****************************************************************************	*/
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include "Build.h"
+#include "Timer.h"
+
+#if _SUPPORT_SCHEDULER
+
+/* Rate groups */
+#define C_SCHED_GROUP_1MS			0U
+#define C_SCHED_GROUP_10MS			1U
+#define C_SCHED_GROUP_100MS			2U
+#define C_SCHED_GROUP_EVENT			3U											/* Only event triggered */
+#define C_SCHED_MAX_GROUP			3U											/* Periodic groups */
+
+#define C_SCHED_PERIOD_1MS			(  1u * PI_TICKS_PER_MILLISECOND)
+#define C_SCHED_PERIOD_10MS			( 10u * PI_TICKS_PER_MILLISECOND)
+#define C_SCHED_PERIOD_100MS		(100u * PI_TICKS_PER_MILLISECOND)
+#if _SUPPORT_PROFILER
+/* Task time in Timer2 CPU-cycles is valid up to the last full tick before the Timer2 wrap-around (65536 cycles) */
+#define C_SCHED_CYCLES_MAX_TICKS	((uint16) ((65536000UL / FPLL) / CT_PERIODIC_RATE))
+#endif /* _SUPPORT_PROFILER */
+
+/* Events (Scheduler_SetEvent()) */
+#define C_SCHED_EVENT_NONE			0x00U
+#define C_SCHED_EVENT_LIN			0x01U										/* LIN frame received */
+
+typedef enum
+{
+	SCHED_TASK_LIN = 0,															/* LIN_MainFunction() */
+	SCHED_TASK_APPL,															/* App_CoolantValveSM() */
+	SCHED_TASK_MOTOR,															/* MotorDriver_MainFunction() */
+	SCHED_TASK_BG_MEMORY,														/* System_BackgroundMemoryTest() */
+	SCHED_TASK_BG_IOREG,														/* System_BackgroundIORegTest() */
+#if _SUPPORT_NVRAM_WRITE_BACK || _SUPPORT_NVRAM_RECORD_CRC
+	SCHED_TASK_NVRAM,															/* NVRAM_MainFunction() */
+#endif /* _SUPPORT_NVRAM_WRITE_BACK || _SUPPORT_NVRAM_RECORD_CRC */
+#if (_DEBUG > 0u) && (_DEBUG_NVRAM_ERRORLOG > 0u)
+	SCHED_TASK_ERRLOG,															/* ErrorLog_MainFunction() */
+#endif /* (_DEBUG > 0u) && (_DEBUG_NVRAM_ERRORLOG > 0u) */
+	MAX_SCHED_TASK
+} SCHED_TASK_ID;
+
+typedef struct _SCHED_TASK
+{
+	void (*pfnTask)( void);
+	uint8 u8Group;																/* Rate group (C_SCHED_GROUP_xxx) */
+	uint8 u8Events;																/* Triggering events (C_SCHED_EVENT_xxx) */
+	uint8 u8ProfileID;															/* Profiler entry (_SUPPORT_PROFILER) */
+} SCHED_TASK;
+
+typedef struct _SCHED_DATA
+{
+	uint16 u16Count;															/* Number of runs */
+	uint16 u16MaxTicks;															/* Maximum execution time [ticks] */
+#if _SUPPORT_PROFILER
+	uint16 u16MaxCycles;														/* Maximum execution time [CPU-cycles]; 0xFFFF: >= C_SCHED_CYCLES_MAX_TICKS */
+#endif /* _SUPPORT_PROFILER */
+	uint8 u8Overruns;															/* Runs longer than the group period (saturated) */
+} SCHED_DATA, *PSCHED_DATA;
+
+/* ****************************************************************************	*
+ *	P u b l i c   v a r i a b l e s												*
+ * ****************************************************************************	*/
+#pragma space nodp																/* __NEAR_SECTION__ */
+extern volatile uint8 g_u8SchedulerEvents;										/*!< Pending events */
+extern uint8 g_au8SchedulerGroupOverruns[C_SCHED_MAX_GROUP];					/*!< Missed releases per rate group (saturated) */
+#pragma space none																/* __NEAR_SECTION__ */
+
+/* ****************************************************************************	*
+ *	P u b l i c   f u n c t i o n s												*
+ * ****************************************************************************	*/
+extern void Scheduler_Init( void);												/*!< Start the rate groups; Timer_Init() must be called first */
+extern void Scheduler_MainFunction( void);										/*!< Run the released and event triggered tasks */
+extern uint16 Scheduler_GetIdleTicks( void);									/*!< Ticks until the next release; 0: Tasks pending */
+extern void Scheduler_Get( uint16 u16TaskID, PSCHED_DATA pSchedData);			/*!< Task statistics */
+
+/* ****************************************************************************	*
+ * Scheduler_SetEvent()
+ *
+ * Trigger the tasks of event(s) u8Events (also from ISR).
+ * ****************************************************************************	*/
+static __inline__ void Scheduler_SetEvent( uint8 u8Events)
+{
+	ATOMIC_CODE
+	(
+		g_u8SchedulerEvents |= u8Events;
+	);
+} /* End of Scheduler_SetEvent() */
+
+#endif /* _SUPPORT_SCHEDULER */
+
+#endif /* SCHEDULER_H_ */
+
+/* EOF */
@@ -11,10 +11,25 @@
  * \version 	1.0 - preliminary
  *
  * \functions	Timer_Init()
- *				Timer_Stop()
+ *				Timer_Start()
+ *				Timer_IsExpired()
  *				Timer_SleepCompensation()
+ *				Timer_GetIdleTicks()
+ *				Timer_Halt()
  *				TIMER_IT()
- *				
+ *
+ * The software timers are deadlines on a single (wrapping) tick-counter; The
+ * periodic ISR increments the tick-counter and checks one timer per tick
+ * (round-robin), independent of the number of timers. A timer is expired
+ * once the tick-counter has reached its deadline; The expiry is latched
+ * (l_au8TimerRunning[]) within MAX_TIMER ticks, long before the tick-counter
+ * wraps (32768 ticks = 16.4s), so a timer which isn't polled for a long time
+ * remains expired. Maximum timer period: 32767 ticks.
+ *
+ * Tickless idle (_SUPPORT_MLX16_HALT): Timer_Halt() reprograms the core timer
+ * for the next timer deadline, HALTs the MLX16 and accounts for the elapsed
+ * ticks after the wake-up (TIMER_IT: l_u16TimerStep ticks per interrupt).
+ *
  *
  * MELEXIS Microelectronic Integrated Systems
  * 
@@ -29,7 +44,9 @@
 
 #include "Build.h"
 #include "Timer.h"																/* Periodic IRQ Timer support */
+#include "Profiler.h"
 #include <plib.h>																/* Use Melexis MLX813xx library (WDG_Manager) */
+#include <coretimerlib.h>														/* CORE_TIMER_VALUE() */
 #include "private_mathlib.h"
 #include <mathlib.h>															/* Use Melexis math-library functions to avoid compiler warnings */
 
@@ -43,7 +60,16 @@
  *	NORMAL FAR IMPLEMENTATION	(@NEAR Memory Space >= 0x100)					*
  * ****************************************************************************	*/
 #pragma space nodp																/* __NEAR_SECTION__ */
-uint16 l_u16Timer[MAX_TIMER];
+volatile uint16 g_u16TimerTicks = 0u;											/* Tick-counter (CT_PERIODIC_RATE) */
+uint16 l_au16TimerDeadline[MAX_TIMER];											/* Tick-counter at expiry */
+volatile uint8 l_au8TimerRunning[MAX_TIMER];									/* FALSE: Expired (or never started) */
+uint8 l_u8TimerScan = 0u;														/* Timer checked by the next TIMER_IT */
+#if _SUPPORT_MLX16_HALT
+uint16 l_u16TimerStep = 1u;														/* Ticks per TIMER_IT */
+uint16 l_u16TimerLoad = CT_PERIODIC_RATE;										/* Core timer reload value [us] */
+uint16 l_u16TimerOffset = 0u;													/* [us] since the last tick at load of the core timer */
+uint8 l_u8TimerReload = FALSE;													/* TRUE: TIMER_IT restores the periodic rate */
+#endif /* _SUPPORT_MLX16_HALT */
 #pragma space none																/* __NEAR_SECTION__ */
 
 
@@ -57,8 +83,17 @@ void Timer_Init( void)
 	uint16 i;
 	for(i = 0; i < (uint16)MAX_TIMER; i++)
 	{
-		l_u16Timer[i] = 0;
+		l_au8TimerRunning[i] = FALSE;
+		l_au16TimerDeadline[i] = 0u;
 	}
+	g_u16TimerTicks = 0u;
+	l_u8TimerScan = 0u;
+#if _SUPPORT_MLX16_HALT
+	l_u16TimerStep = 1u;
+	l_u16TimerLoad = CT_PERIODIC_RATE;
+	l_u16TimerOffset = 0u;
+	l_u8TimerReload = FALSE;
+#endif /* _SUPPORT_MLX16_HALT */
 	/* System Tick Timer - Core Timer  */
 	TIMER =  TMR_EN | CT_PERIODIC_RATE;											/* 500us timer */
 
@@ -73,7 +108,8 @@ void Timer_Start(TIMER_ID id,uint16 TimerPeriod)
 {
 	if(id < MAX_TIMER)
 	{
-		l_u16Timer[id] = TimerPeriod;
+		l_au16TimerDeadline[id] = (uint16)(g_u16TimerTicks + TimerPeriod);		/* Deadline first; TIMER_IT only checks running timers */
+		l_au8TimerRunning[id] = (TimerPeriod != 0u) ? TRUE : FALSE;
 	}
 }
 
@@ -84,10 +120,15 @@ void Timer_Start(TIMER_ID id,uint16 TimerPeriod)
  * ****************************************************************************	*/
 uint8 Timer_IsExpired(TIMER_ID id)
 {
-	if(l_u16Timer[id] == 0u)
+	if(l_au8TimerRunning[id] == FALSE)
 	{
 		return TRUE;
 	}
+	else if((int16)(g_u16TimerTicks - l_au16TimerDeadline[id]) >= 0)
+	{
+		l_au8TimerRunning[id] = FALSE;
+		return TRUE;
+	}
 	else
 	{
 		return FALSE;
@@ -102,24 +143,135 @@ uint8 Timer_IsExpired(TIMER_ID id)
  * ****************************************************************************	*/
 void Timer_SleepCompensation( uint16 u16SleepPeriod)
 {
-	uint16 i;
-	
 	u16SleepPeriod = muldivU16_U16byU16byU16( u16SleepPeriod, 256U, (uint16)(CT_PERIODIC_RATE*(PLL_freq/1000000U)));
 	ATOMIC_CODE
 	(
-		for(i = 0u; i < (uint16)MAX_TIMER; i++)
+		g_u16TimerTicks += u16SleepPeriod;
+	);
+} /* End of Timer_SleepCompensation() */
+
+#if _SUPPORT_MLX16_HALT
+/* ****************************************************************************	*
+ * Timer_Elapsed()
+ *
+ * Time [us] since the last tick (within ATOMIC_CODE)
+ * ****************************************************************************	*/
+static INLINE uint16 Timer_Elapsed( void)
+{
+	uint16 u16Value = CORE_TIMER_VALUE();
+	if ( u16Value > l_u16TimerLoad )
+	{
+		u16Value = l_u16TimerLoad;												/* Just (re)loaded */
+	}
+	return ( (uint16)(l_u16TimerOffset + l_u16TimerLoad - u16Value) );
+} /* End of Timer_Elapsed() */
+
+/* ****************************************************************************	*
+ * Timer_GetIdleTicks()
+ *
+ * Returns the number of ticks until the first running timer expires, at most
+ * u16MaxTicks; 0: A timer has expired (not yet polled).
+ * ****************************************************************************	*/
+uint16 Timer_GetIdleTicks( uint16 u16MaxTicks)
+{
+	uint16 i;
+	uint16 u16Ticks = g_u16TimerTicks;
+
+	for(i = 0u; i < (uint16)MAX_TIMER; i++)
+	{
+		if(l_au8TimerRunning[i] != FALSE)
 		{
-			if(l_u16Timer[i] > u16SleepPeriod)
+			int16 i16Left = (int16)(l_au16TimerDeadline[i] - u16Ticks);
+			if(i16Left <= 0)
 			{
-				l_u16Timer[i] -= u16SleepPeriod;
+				return ( 0u );
 			}
-			else
+			if((uint16)i16Left < u16MaxTicks)
 			{
-				l_u16Timer[i] = 0;
-			}		
-		}	
+				u16MaxTicks = (uint16)i16Left;
+			}
+		}
+	}
+	return ( u16MaxTicks );
+} /* End of Timer_GetIdleTicks() */
+
+/* ****************************************************************************	*
+ * Timer_Halt()
+ *
+ * HALT the MLX16 until the next interrupt, at most u16Ticks ticks. For more
+ * than one tick, the core timer is reloaded to expire at the tick u16Ticks
+ * ahead; After an early wake-up (other interrupt), the elapsed ticks are
+ * added and the core timer is re-aligned to the next tick.
+ * pfnBusy() is re-checked with interrupts disabled, immediately before the
+ * HALT; An event raised by an ISR after the caller's check either cancels the
+ * HALT, or its interrupt request (pending, not yet accepted) wakes-up the
+ * MLX16 at once. The ISR's run when leaving the atomic section.
+ * Returns the HALT time [us] (including the ISR's before resuming).
+ * ****************************************************************************	*/
+uint16 Timer_Halt( uint16 u16Ticks, uint16 (*pfnBusy)(void))
+{
+	uint16 u16StartTicks, u16Start, u16End = 0u;
+
+	if(u16Ticks > C_TIMER_MAX_HALT_TICKS)
+	{
+		u16Ticks = C_TIMER_MAX_HALT_TICKS;
+	}
+	ATOMIC_CODE
+	(
+		u16StartTicks = g_u16TimerTicks;
+		u16Start = Timer_Elapsed();
+		if(((PEND & CLR_TIMER_IT) != 0u) || (pfnBusy() != 0u))
+		{
+			u16Ticks = 0u;														/* Tick or work pending; Don't HALT */
+		}
+		else
+		{
+			if(u16Ticks > 1u)
+			{
+				l_u16TimerLoad = (uint16)(u16Ticks * CT_PERIODIC_RATE) - u16Start;
+				l_u16TimerOffset = u16Start;
+				l_u16TimerStep = u16Ticks;
+				l_u8TimerReload = TRUE;
+				TIMER = TMR_EN | l_u16TimerLoad;
+			}
+			MLX16_HALT();														/* Wait for an interrupt request */
+		}
 	);
-} /* End of Timer_SleepCompensation() */
+	if(u16Ticks == 0u)
+	{
+		return ( 0u );
+	}
+
+	ATOMIC_CODE
+	(
+		if((PEND & CLR_TIMER_IT) != 0u)
+		{
+			/* Core timer reloaded; TIMER_IT pending */
+			u16StartTicks -= l_u16TimerStep;
+			l_u16TimerOffset = 0u;
+			u16End = Timer_Elapsed();
+		}
+		else if(l_u16TimerStep > 1u)
+		{
+			/* Early wake-up: Add the elapsed ticks, re-align to the next tick */
+			uint16 u16Elapsed = Timer_Elapsed();
+			uint16 u16Rem = u16Elapsed % CT_PERIODIC_RATE;
+			g_u16TimerTicks += (uint16)(u16Elapsed / CT_PERIODIC_RATE);
+			l_u16TimerLoad = CT_PERIODIC_RATE - u16Rem;
+			l_u16TimerOffset = u16Rem;
+			l_u16TimerStep = 1u;
+			TIMER = TMR_EN | l_u16TimerLoad;									/* TIMER_IT restores the periodic rate */
+			u16End = u16Rem;
+		}
+		else
+		{
+			u16End = Timer_Elapsed();
+		}
+		u16End += (uint16)((uint16)(g_u16TimerTicks - u16StartTicks) * CT_PERIODIC_RATE);
+	);
+	return ( (uint16)(u16End - u16Start) );
+} /* End of Timer_Halt() */
+#endif /* _SUPPORT_MLX16_HALT */
 
 
 /* ****************************************************************************	*
@@ -129,15 +281,36 @@ void Timer_SleepCompensation( uint16 u16SleepPeriod)
  * ****************************************************************************	*/
 __interrupt__ void TIMER_IT(void) 
 {
-	uint16 i;
-	
-	for(i = 0; i < (uint16)MAX_TIMER; i++)
-	{	
-		if(l_u16Timer[i] > 0u)
-		{
-			l_u16Timer[i]--;
-		}
+	PROFILER_START();
+	uint8 i = l_u8TimerScan;
+#if _SUPPORT_MLX16_HALT
+	uint16 u16Ticks = g_u16TimerTicks + l_u16TimerStep;
+
+	if(l_u8TimerReload != FALSE)
+	{
+		/* End of tickless period: Restore the periodic rate */
+		TIMER = TMR_EN | CT_PERIODIC_RATE;
+		l_u16TimerLoad = CT_PERIODIC_RATE;
+		l_u16TimerOffset = 0u;
+		l_u16TimerStep = 1u;
+		l_u8TimerReload = FALSE;
+	}
+#else  /* _SUPPORT_MLX16_HALT */
+	uint16 u16Ticks = g_u16TimerTicks + 1u;
+#endif /* _SUPPORT_MLX16_HALT */
+
+	g_u16TimerTicks = u16Ticks;
+	if((l_au8TimerRunning[i] != FALSE) && ((int16)(u16Ticks - l_au16TimerDeadline[i]) >= 0))
+	{
+		l_au8TimerRunning[i] = FALSE;											/* Latch expiry (tick-counter wrap) */
+	}
+	i++;
+	if(i >= (uint8)MAX_TIMER)
+	{
+		i = 0u;
 	}
+	l_u8TimerScan = i;
+	PROFILER_STOP( PROFILE_TIMER_IT);
 }
 
 
@@ -46,6 +46,7 @@
 #define C_PI_TICKS_PWM_INACTIVE		(  4u * PI_TICKS_PER_SECOND)
 #define C_PI_TICKS_STABILISE		( 50u * PI_TICKS_PER_MILLISECOND)			/* Max. 255 */
 #define C_PI_TICKS_STABILISE_CALIB	(100u * PI_TICKS_PER_MILLISECOND)
+#define C_TIMER_MAX_HALT_TICKS		(0x7FFFU/CT_PERIODIC_RATE)					/* Maximum tickless period (15-bit core timer) */
 
 #define DELAY_4us	(uint16)(((    4U * (PLL_freq/1000000))/(2*CYCLES_PER_INSTR))-1)	/*   4us delay */
 #define DELAY_7us	(uint16)(((    7U * (PLL_freq/1000000))/(2*CYCLES_PER_INSTR))-1)	/*   7us delay */
@@ -90,6 +91,13 @@ typedef enum
   MAX_TIMER,
 } TIMER_ID;
 
+/* ****************************************************************************	*
+ *	P u b l i c   v a r i a b l e s												*
+ * ****************************************************************************	*/
+#pragma space nodp																/* __NEAR_SECTION__ */
+extern volatile uint16 g_u16TimerTicks;											/*!< Tick-counter, incremented at CT_PERIODIC_RATE */
+#pragma space none																/* __NEAR_SECTION__ */
+
 /* ****************************************************************************	*
  *	P u b l i c   f u n c t i o n s												*
  * ****************************************************************************	*/
@@ -97,6 +105,10 @@ extern void Timer_Init( void);														/*!< Initialize the core timer (Mula
 extern void Timer_SleepCompensation( uint16 u16SleepPeriod);					/*!< Compensate the various timer-counters for the sleep-period */
 extern void Timer_Start(TIMER_ID id,uint16 TimerPeriod);						/* Set timer by timer ID*/
 extern uint8 Timer_IsExpired(TIMER_ID id);									/* Get the status of timer*/
+#if _SUPPORT_MLX16_HALT
+extern uint16 Timer_GetIdleTicks( uint16 u16MaxTicks);							/*!< Ticks until the first timer deadline */
+extern uint16 Timer_Halt( uint16 u16Ticks, uint16 (*pfnBusy)(void));			/*!< HALT (tickless) until the next interrupt, unless pfnBusy() */
+#endif /* _SUPPORT_MLX16_HALT */
 
 static __inline__ void NopDelay(uint16 u16DelayCount)
 {
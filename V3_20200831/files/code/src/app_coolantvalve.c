@@ -110,6 +110,10 @@ uint8 l_u8EmrunStatus = 0u;			/* emergency run status:0-idle;1-in process */
 
 uint8 l_u8MotorControl = C_MOTOR_STOP_ONLY;
 
+#if _SUPPORT_NVRAM_LOG
+uint32 l_u32ValveMoves = 0u;		/* number of position changes, restored from NVRAM log */
+#endif /* _SUPPORT_NVRAM_LOG */
+
 /* purpose is to buffer LIN command info */
 CV_RequestStructType s_CVRequestStruct = {
     (uint16)C_MOTOR_REQUEST_NONE,
@@ -159,6 +163,10 @@ void App_CoolantValveSMInit(void)
 		l_e8ValveState = (uint8)C_STATE_UNINITIALIZED;
 		l_e8CalibrationStep = (uint8)C_CALIB_NONE;
 	}
+#if _SUPPORT_NVRAM_LOG
+	/* move counter continues from the NVRAM log (read only: no NVRAM program at start-up) */
+	(void)NVRAM_LogGet(C_NVRAM_LOG_TAG_MOVES, &l_u32ValveMoves);
+#endif /* _SUPPORT_NVRAM_LOG */
 
 	/* configure motor control params */
 	motor_params.MotorCtrl = C_MOTOR_CTRL_STOP;
@@ -594,6 +602,19 @@ void handleSynchronizePosition(void)
 
 	/* position */
 	l_u16PhysicalActualPos = motor_status.ActPos;
+#if _SUPPORT_NVRAM_LOG
+	/* persist position at stand-still; programmed by NVRAM write-back at idle */
+	if((l_e8ValveState == (uint8)C_STATE_INITIALIZED) && (motor_status.Mode == (uint8)MSM_STOP))
+	{
+		uint32 u32LogValue;
+		if((NVRAM_LogGet(C_NVRAM_LOG_TAG_POSITION, &u32LogValue) != NVRAM_E_OK) || (u32LogValue != l_u16PhysicalActualPos))
+		{
+			l_u32ValveMoves++;
+			(void)NVRAM_LogPut(C_NVRAM_LOG_TAG_POSITION, l_u16PhysicalActualPos);
+			(void)NVRAM_LogPut(C_NVRAM_LOG_TAG_MOVES, l_u32ValveMoves);
+		}
+	}
+#endif /* _SUPPORT_NVRAM_LOG */
 	l_u8OBDValveElectricError &= (uint8)(~OBD_VALVE_ELECTRIC_INDET);			/* diagnostic has been done */
 	/* temporary electric error is recoverable */
 	if((motor_status.Fault.UV != 0u) || (motor_status.Fault.OV != 0u) ||
@@ -791,6 +812,9 @@ void handleSleepEvent(void)
 void Valve_GotoSleep(void)
 {
 	uint16 cv_nvm[3];
+#if _SUPPORT_NVRAM_WRITE_BACK
+	NVRAM_Flush();																/* Commit pending NVRAM changes */
+#endif /* _SUPPORT_NVRAM_WRITE_BACK */
 	/* stop MCU */
 	MLX315_GotoSleep();
 }
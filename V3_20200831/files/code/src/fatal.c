@@ -32,6 +32,7 @@
 #include "MotorDriver.h"
 #include "lib_mlx315_misc.h"
 #include "NVRAM_UserPage.h"
+#include "ErrorCodes.h"															/* Queued error-codes */
 
 /* Linker symbols (these objects are not created in the memory) */
 extern uint16 stack;
@@ -164,6 +165,9 @@ __MLX_TEXT__ void _fatal (void)
 
 	/* Disable motor driver first, before waiting for watchdog */
 	DRVCFG_DIS_UVWT();															/* Tri-state (disconnect) the phase U, V, W and T (MMP130919-1) */
+#if (_DEBUG > 0u) && (_DEBUG_NVRAM_ERRORLOG > 0u)
+	ErrorLog_Flush();															/* Queued error-codes */
+#endif /* (_DEBUG > 0u) && (_DEBUG_NVRAM_ERRORLOG > 0u) */
 
 	for (;;) {
 		/* loop forever */
@@ -80,6 +80,12 @@ void MLX315_SystemInit(void)
 	PEND = CLR_EXT0_IT;
 	MASK |= EN_EXT0_IT;	
 
+#if _SUPPORT_COMMUT_BOTTOM_HALF
+	/* BLDC motor Commutation bottom-half (Software interrupt, fixed priority 7) */
+	PEND = CLR_SOFT_IT;
+	MASK |= EN_SOFT_IT;
+#endif /* _SUPPORT_COMMUT_BOTTOM_HALF */
+
 	/* HALL,diagnostic(OVT,OVC,UV,OV) interrupt */
 	/* PRIO = (PRIO & ~(3U << 14)) | ((3U - 3U) << 14); */							/* EXT4_IT Priority: 3 (3..6) */
 	PRIO &= ~((uint16)3u << 14u);												/* EXT4_IT Priority: 3 (3..6) */
@@ -41,6 +41,8 @@
 #define C_TMRx_CTRL_MODE0	((2u * TMRx_DIV0) | (0u * TMRx_MODE0) | TMRx_T_EBLK)	/* Timer mode 0, Divider 256 */
 #endif /* (TIMER_PRESCALER == 16) */
 #endif /* (TIMER_PRESCALER == 1) */
+/* Timer mode 1 (capture), free running, same divider as C_TMRx_CTRL_MODE0; Channel A both edges */
+#define C_TMR2_CTRL_HALL_CAPTURE	((C_TMRx_CTRL_MODE0 & (3u * TMRx_DIV0)) | TMRx_MODE1 | TMRx_EDG1_1 | TMRx_EDG1_0 | TMRx_T_EBLK)
 
 #define FET_SETTING (((10u*PLL_freq)/(1000000u * CYCLES_PER_INSTR * 2u)) + 1u)			/* 10us: 10us*PLL-freq/(10000000us/s * #cycles/instruction) * instructions */
 
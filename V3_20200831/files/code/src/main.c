@@ -10,6 +10,9 @@
 #include "ErrorCodes.h"
 #include "app_coolantvalve.h"
 #include "system_background.h"
+#include "Profiler.h"
+#include "Idle.h"
+#include "Scheduler.h"
 
 #pragma space nodp
 
@@ -28,12 +31,18 @@ int16 main( void)
 	MotorDriverInit();							       	/*  Initialize Motor-driver */
 	PID_Init();										   	/* PID Control initialization */
 	LIN_Init();											/* initialize LIN interface */
+#if _SUPPORT_PROFILER
+	Profiler_Init();									/* Start ISR/task execution-time profiler */
+#endif /* _SUPPORT_PROFILER */
 	
 	SET_PRIORITY(7);									/* Enable interrupts:MASK LEVEL lowest */
 	
 	/* system service */
 	ErrorLogInit();								       	/* Initialize Error-logging management */	
 	Timer_Init();								       	/* Initialize (Core) Timer */
+#if _SUPPORT_MLX16_HALT
+	Idle_Init();										/* Start idle percentage measurement */
+#endif /* _SUPPORT_MLX16_HALT */
 
 #if _SUPPORT_MOTOR_SELFTEST
 	MotorDiagnosticSelfTest();							/* Self-test Motor-Driver */
@@ -41,24 +50,43 @@ int16 main( void)
 	/* Application initialize area */
 	App_CoolantValveSMInit();
 	System_BackgroundTaskInit();
+#if _SUPPORT_SCHEDULER
+	Scheduler_Init();									/* Start rate groups */
+#endif /* _SUPPORT_SCHEDULER */
 	
 	for(;;)
 	{
+#if _SUPPORT_SCHEDULER
+		/* Application, driver, service and background tasks (rate groups and events) */
+		Scheduler_MainFunction();
+#else  /* _SUPPORT_SCHEDULER */
 		/* user application */
-		App_CoolantValveSM();
+		PROFILER_CODE( PROFILE_TASK_APPL, App_CoolantValveSM());
 
 		/* driver and service */
-		MotorDriver_MainFunction();
-		LIN_MainFunction();
+		PROFILER_CODE( PROFILE_TASK_MOTOR, MotorDriver_MainFunction());
+		PROFILER_CODE( PROFILE_TASK_LIN, LIN_MainFunction());
 		
 		/* system background application */
-		System_BackgroundMemoryTest();
-		System_BackgroundIORegTest();
+		PROFILER_CODE( PROFILE_TASK_BG_MEMORY, System_BackgroundMemoryTest());
+		PROFILER_CODE( PROFILE_TASK_BG_IOREG, System_BackgroundIORegTest());
+#if _SUPPORT_NVRAM_WRITE_BACK || _SUPPORT_NVRAM_RECORD_CRC
+		PROFILER_CODE( PROFILE_TASK_NVRAM, NVRAM_MainFunction());
+#endif /* _SUPPORT_NVRAM_WRITE_BACK || _SUPPORT_NVRAM_RECORD_CRC */
+#if (_DEBUG > 0u) && (_DEBUG_NVRAM_ERRORLOG > 0u)
+		PROFILER_CODE( PROFILE_TASK_ERRLOG, ErrorLog_MainFunction());
+#endif /* (_DEBUG > 0u) && (_DEBUG_NVRAM_ERRORLOG > 0u) */
+#endif /* _SUPPORT_SCHEDULER */
 
 #if WATCHDOG == ENABLED
 		/* Watch-dog acknowledgment */
 		WDG_Manager();
 #endif	
+
+#if _SUPPORT_MLX16_HALT
+		/* Tickless idle: HALT until the next event */
+		Idle_MainFunction();
+#endif /* _SUPPORT_MLX16_HALT */
 	}
 
 	return 0;
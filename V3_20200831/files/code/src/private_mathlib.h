@@ -30,6 +30,7 @@
 static __inline__ int16 muldivI16_I16byI16byI16(int16 a, int16 b, int16 c) __attribute__ ((always_inline));
 static __inline__ int16 muldivI16_I16byI16byI16(int16 a, int16 b, int16 c)
 {
+#ifdef __MLX16__
     int16 result;  /*lint -e530 */
     int16 result2; /*lint -e529 */												/* clobbering of the register */
 
@@ -43,11 +44,15 @@ static __inline__ int16 muldivI16_I16byI16byI16(int16 a, int16 b, int16 c)
          );
 
     return result;
+#else
+    return (int16) (((int32) a * (int32) b) / (int32) c);
+#endif /* __MLX16__ */
 } /* End of muldivI16_I16byI16byI16() */
 
 static __inline__ uint16 muldivU16_U16byU16byU16(uint16 a, uint16 b, uint16 c) __attribute__ ((always_inline));
 static __inline__ uint16 muldivU16_U16byU16byU16(uint16 a, uint16 b, uint16 c)
 {
+#ifdef __MLX16__
     int16 result;  /*lint -e530 */
     int16 result2; /*lint -e529 */												/* clobbering of the register */
 
@@ -60,11 +65,15 @@ static __inline__ uint16 muldivU16_U16byU16byU16(uint16 a, uint16 b, uint16 c)
          );
 
     return result;
+#else
+    return (uint16) (((uint32) a * (uint32) b) / (uint32) c);
+#endif /* __MLX16__ */
 } /* End of muldivU16_U16byU16byU16() */
 
 static __inline__ int16 mulI16_I16byI16Shft4(int16 a, int16 b) __attribute__ ((always_inline));
 static __inline__ int16 mulI16_I16byI16Shft4(int16 a, int16 b)
 {
+#ifdef __MLX16__
     int16 result;  /*lint -e530 */
     int16 result2; /*lint -e529 */												/* clobbering of the register */
 
@@ -76,6 +85,9 @@ static __inline__ int16 mulI16_I16byI16Shft4(int16 a, int16 b)
          );
 
     return result;
+#else
+    return (int16) (((int32) a * (int32) b) >> 20);
+#endif /* __MLX16__ */
 } /* End of mulI16_I16byI16Shft4() */
 
 /* ----------------------------------------------------------------------------
@@ -91,6 +103,7 @@ static __inline__ int16 mulI16_I16byI16Shft4(int16 a, int16 b)
 static __inline__ int16 divI16_I32byI16(int32 a, int16 b) __attribute__ ((always_inline));
 static __inline__ int16 divI16_I32byI16(int32 a, int16 b)
 {
+#ifdef __MLX16__
     int16 result;
     int16 result2;    /* clobbering of the register */
 
@@ -103,11 +116,15 @@ static __inline__ int16 divI16_I32byI16(int32 a, int16 b)
          );
 
     return result;
+#else
+    return (int16) (a / (int32) b);
+#endif /* __MLX16__ */
 } /* End of divI16_I32byI16() */
 
 static __inline__ int16 mulI16_I16byI16RndDiv64(int16 a, int16 b) __attribute__ ((always_inline));
 static __inline__ int16 mulI16_I16byI16RndDiv64(int16 a, int16 b)
 {
+#ifdef __MLX16__
     int16 result;
     int16 result2;    /* clobbering of the register */
 
@@ -121,6 +138,11 @@ static __inline__ int16 mulI16_I16byI16RndDiv64(int16 a, int16 b)
          );
 
     return result;
+#else
+    int32 product = ((int32) a * (int32) b);
+
+    return (int16) ((product >> 6) + ((product >> 5) & 1));
+#endif /* __MLX16__ */
 } /* End of mulI16_I16byI16RndDiv64() */
 
 #endif /* PRIVATE_MATHLIB_H_ */
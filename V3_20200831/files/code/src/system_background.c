@@ -12,6 +12,7 @@
 #define FLASH_CRC_ADDR				0xBF4Eu
 #define FLASH_END_ADDR				0xC000u
 #define C_FLASH_SEGMENT_SZ			4u											/* Max 250us (196us), Halt-mode: Full-check is once per 8:40s; Running-mode: 1.5s */
+																				/* _SUPPORT_SCHEDULER (10ms group): 4128 calls (2 of 256 IDs are RAM-checks), full-check once per 41s */
 
 #define C_FLASH_CRC_FAILED			0u
 #define C_FLASH_CRC_OK				1u
@@ -56,6 +57,9 @@ void System_BackgroundMemoryTest(void)
 			else
 			{
 				SetLastError( (uint8) C_ERR_RAM_BG);						/* Log RAM failure */
+#if (_DEBUG > 0u) && (_DEBUG_NVRAM_ERRORLOG > 0u)
+				ErrorLog_Flush();											/* Store the error-code in NVRAM before the reset */
+#endif /* (_DEBUG > 0u) && (_DEBUG_NVRAM_ERRORLOG > 0u) */
 				MLX4_RESET();												/* Reset the Mlx4   */
 				bistResetInfo = C_CHIP_STATE_LIN_CMD_RESET;
 				MLX16_RESET();												/* Reset the Mlx16  */
@@ -75,6 +79,9 @@ void System_BackgroundMemoryTest(void)
 			if ( FlashBackgroundTest( C_FLASH_SEGMENT_SZ) == (uint16)C_FLASH_CRC_FAILED )	/* Check Flash/ROM Memory Checksum (max. 250us) */
 			{
 				SetLastError( (uint8) C_ERR_FLASH_BG);
+#if (_DEBUG > 0u) && (_DEBUG_NVRAM_ERRORLOG > 0u)
+				ErrorLog_Flush();												/* Store the error-code in NVRAM before the reset */
+#endif /* (_DEBUG > 0u) && (_DEBUG_NVRAM_ERRORLOG > 0u) */
 				MLX4_RESET();													/* Reset the Mlx4   */
 				bistResetInfo = C_CHIP_STATE_LIN_CMD_RESET;
 				MLX16_RESET();													/* Reset the Mlx16  */
@@ -225,6 +232,15 @@ void System_BackgroundIORegTest(void)
 		MASK |= (EN_EXT4_IT | EN_EXT0_IT | EN_TIMER_IT | EN_M4_SHE_IT);
 		SetLastError( (uint8) C_ERR_IOREG);
 	}
+#if _SUPPORT_COMMUT_BOTTOM_HALF
+	/* Check: IRQ-Mask Commutation bottom-half (Software interrupt) */
+	if ( (MASK & EN_SOFT_IT) == 0u )
+	{
+		PEND = CLR_SOFT_IT;
+		MASK |= EN_SOFT_IT;
+		SetLastError( (uint8) C_ERR_IOREG);
+	}
+#endif /* _SUPPORT_COMMUT_BOTTOM_HALF */
 	/* Check: IRQ-priority (Respectively: Diagnostics, Timer1, CoreTimer) */
 	if ( (PRIO & (((uint16)3u << 14u) | ((uint16)3u << 6u) | ((uint16)3u << 0u))) != 
 		(/*((uint16)(3-3) << 14) |*/ ((uint16)(4u - 3u) << 6u) | ((uint16)(6u - 3u) << 0u)) )
@@ -247,6 +263,15 @@ void System_BackgroundIORegTest(void)
 		XI4_MASK = C_DIAG_MASK; 										/* MMP150409-1 */
 		SetLastError( (uint8) C_ERR_IOREG);
 	}
+#if _SUPPORT_HALL_TMR2_CAPTURE
+	/* Check: Timer2 hall-edge capture (IRQ, priority, 2nd level IRQ and timer) */
+	if ( ((MASK & EN_EXT1_IT) == 0u) || ((PRIO & ((uint16)3u << 8u)) != ((uint16)(4u - 3u) << 8u)) ||
+		 ((XI1_MASK & (EN_T2_INT1 | EN_T2_INT3)) != (EN_T2_INT1 | EN_T2_INT3)) || ((TMR2_CTRL & (TMRx_START | TMRx_T_EBLK)) != (TMRx_START | TMRx_T_EBLK)) )
+	{
+		HallCaptureInit();
+		SetLastError( (uint8) C_ERR_IOREG);
+	}
+#endif /* _SUPPORT_HALL_TMR2_CAPTURE */
 	/* Check:driver check */
 	if ( (g_u8MotorStartupMode != (uint8)MSM_STOP) && ((DRVCFG & (DRV_CFG_T|DRV_CFG_W|DRV_CFG_V|DRV_CFG_U)) == 0u) )
 	{